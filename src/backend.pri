@@ -95,18 +95,25 @@ HEADERS += \
     $$PWD/backend/dab_decoder.h \
     $$PWD/backend/dabplus_decoder.h \
     $$PWD/backend/subchannel_sink.h \
+    $$PWD/backend/channel-scan.h \
     $$PWD/backend/charsets.h \
     $$PWD/backend/dab-constants.h \
     $$PWD/backend/dab-processor.h \
     $$PWD/backend/dab-virtual.h \
     $$PWD/backend/mot_manager.h \
     $$PWD/backend/pad_decoder.h \
+    $$PWD/backend/async-radio-controller.h \
     $$PWD/backend/eep-protection.h \
     $$PWD/backend/energy_dispersal.h \
+    $$PWD/backend/ensemble-cache.h \
     $$PWD/backend/fib-processor.h \
     $$PWD/backend/fic-handler.h \
     $$PWD/backend/msc-handler.h \
+    $$PWD/backend/frame-pool.h \
     $$PWD/backend/freq-interleaver.h \
+    $$PWD/backend/frequency-shifter.h \
+    $$PWD/backend/differential-demod.h \
+    $$PWD/backend/null-detector.h \
     $$PWD/backend/ofdm-decoder.h \
     $$PWD/backend/ofdm-processor.h \
     $$PWD/backend/phasereference.h \
@@ -118,9 +125,14 @@ HEADERS += \
     $$PWD/backend/radio-receiver.h \
     $$PWD/backend/tools.h \
     $$PWD/backend/uep-protection.h \
-    $$PWD/backend/viterbi.h \\
+    $$PWD/backend/viterbi.h \
+    $$PWD/backend/viterbi-simd.h \
+    $$PWD/various/cpu_features.h \
     $$PWD/various/fft.h \
     $$PWD/various/ringbuffer.h \
+    $$PWD/various/spsc_ring.h \
+    $$PWD/various/mpsc_queue.h \
+    $$PWD/various/sample_conversion.h \
     $$PWD/various/Xtan2.h \
     $$PWD/various/channels.h \
     $$PWD/various/wavfile.h \
@@ -150,15 +162,22 @@ SOURCES += \
     $$PWD/backend/dab-audio.cpp \
     $$PWD/backend/dab_decoder.cpp \
     $$PWD/backend/dabplus_decoder.cpp \
+    $$PWD/backend/channel-scan.cpp \
     $$PWD/backend/charsets.cpp \
     $$PWD/backend/dab-constants.cpp \
     $$PWD/backend/mot_manager.cpp \
     $$PWD/backend/pad_decoder.cpp \
+    $$PWD/backend/async-radio-controller.cpp \
     $$PWD/backend/eep-protection.cpp \
+    $$PWD/backend/ensemble-cache.cpp \
     $$PWD/backend/fib-processor.cpp \
     $$PWD/backend/fic-handler.cpp \
     $$PWD/backend/msc-handler.cpp \
+    $$PWD/backend/frame-pool.cpp \
     $$PWD/backend/freq-interleaver.cpp \
+    $$PWD/backend/frequency-shifter.cpp \
+    $$PWD/backend/differential-demod.cpp \
+    $$PWD/backend/null-detector.cpp \
     $$PWD/backend/ofdm-decoder.cpp \
     $$PWD/backend/ofdm-processor.cpp \
     $$PWD/backend/phasereference.cpp \
@@ -169,8 +188,12 @@ SOURCES += \
     $$PWD/backend/tools.cpp \
     $$PWD/backend/uep-protection.cpp \
     $$PWD/backend/viterbi.cpp \
+    $$PWD/backend/viterbi-simd.cpp \
+    $$PWD/various/cpu_features.cpp \
     $$PWD/various/Xtan2.cpp \
     $$PWD/various/channels.cpp \
+    $$PWD/various/spsc_ring.cpp \
+    $$PWD/various/sample_conversion.cpp \
     $$PWD/various/fft.cpp \
     $$PWD/various/wavfile.c \
     $$PWD/various/Socket.cpp \
@@ -0,0 +1,360 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include "async-radio-controller.h"
+#include "announcement-types.h"
+
+AsyncRadioController::AsyncRadioController(
+        RadioControllerInterface& controller, size_t queueDepth) :
+    controller(controller),
+    queue(std::max<size_t>(queueDepth, 1))
+{
+    thread = std::thread(&AsyncRadioController::dispatcher, this);
+}
+
+AsyncRadioController::~AsyncRadioController()
+{
+    running = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        event_cv.notify_one();
+    }
+    thread.join();
+}
+
+EventQueueStats AsyncRadioController::getStats() const
+{
+    EventQueueStats s;
+    s.depth = queue.capacity();
+    s.pending = queue.size();
+    s.highWaterMark = highWaterMark;
+    s.eventsDelivered = eventsDelivered;
+    s.eventsDropped = eventsDropped;
+    return s;
+}
+
+bool AsyncRadioController::isDiagnostic(Event::Type type)
+{
+    switch (type) {
+        case Event::Type::SNR:
+        case Event::Type::FrequencyCorrector:
+        case Event::Type::FIB:
+        case Event::Type::ImpulseResponse:
+        case Event::Type::Constellation:
+        case Event::Type::NullSymbol:
+        case Event::Type::TII:
+            return true;
+        default:
+            return false;
+    }
+}
+
+void AsyncRadioController::push(Event&& event)
+{
+    if (not queue.tryPush(std::move(event))) {
+        if (isDiagnostic(event.type)) {
+            eventsDropped++;
+            return;
+        }
+
+        // A callback that sends an event would wait for itself
+        if (std::this_thread::get_id() == thread.get_id()) {
+            deliver(event);
+            eventsDelivered++;
+            return;
+        }
+
+        while (not queue.tryPush(std::move(event))) {
+            if (not running) {
+                eventsDropped++;
+                return;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(100));
+        }
+    }
+
+    const size_t pending = queue.size();
+    size_t mark = highWaterMark.load(std::memory_order_relaxed);
+    while (pending > mark and
+            not highWaterMark.compare_exchange_weak(mark, pending)) {
+    }
+
+    if (sleeping.exchange(false)) {
+        std::lock_guard<std::mutex> lock(mutex);
+        event_cv.notify_one();
+    }
+}
+
+/**
+ * The dispatcher sleeps when the queue is empty. A producer that pushes
+ * just before the dispatcher goes to sleep does not wake it up, the
+ * timeout bounds the delay of such an event.
+ */
+void AsyncRadioController::dispatcher()
+{
+    Event event;
+    while (running) {
+        if (queue.tryPop(event)) {
+            deliver(event);
+            eventsDelivered++;
+            continue;
+        }
+
+        sleeping = true;
+        std::unique_lock<std::mutex> lock(mutex);
+        event_cv.wait_for(lock, std::chrono::milliseconds(10),
+                [this]() { return not sleeping or not running; });
+        sleeping = false;
+    }
+
+    // What the receiver sent before it stopped
+    while (queue.tryPop(event)) {
+        deliver(event);
+        eventsDelivered++;
+    }
+}
+
+void AsyncRadioController::deliver(Event& e)
+{
+    switch (e.type) {
+        case Event::Type::SNR:
+            controller.onSNR(e.value);
+            break;
+        case Event::Type::FrequencyCorrector:
+            controller.onFrequencyCorrectorChange(e.a, e.b);
+            break;
+        case Event::Type::Sync:
+            controller.onSyncChange(e.a);
+            break;
+        case Event::Type::SignalPresence:
+            controller.onSignalPresence(e.a);
+            break;
+        case Event::Type::ServiceDetected:
+            controller.onServiceDetected(e.a);
+            break;
+        case Event::Type::NewEnsemble:
+            controller.onNewEnsemble(e.a);
+            break;
+        case Event::Type::FIB:
+        {
+            uint8_t bits[256];
+            for (size_t i = 0; i < 256; i++) {
+                bits[i] = (e.fib[i / 8] >> (7 - i % 8)) & 1;
+            }
+            controller.onFIBDecodeSuccess(e.a, bits);
+            break;
+        }
+        case Event::Type::ImpulseResponse:
+            controller.onNewImpulseResponse(std::move(e.floats));
+            break;
+        case Event::Type::Constellation:
+            controller.onConstellationPoints(std::move(e.samples));
+            break;
+        case Event::Type::NullSymbol:
+            controller.onNewNullSymbol(std::move(e.samples));
+            break;
+        case Event::Type::TII:
+            controller.onTIIMeasurement(std::move(e.tii));
+            break;
+        case Event::Type::Message:
+            controller.onMessage(e.level, e.text, e.text2);
+            break;
+        case Event::Type::InputFailure:
+            controller.onInputFailure();
+            break;
+        case Event::Type::RestartService:
+            controller.onRestartService();
+            break;
+        case Event::Type::Call:
+            e.call(controller);
+            // Release what the closure holds now
+            e.call = nullptr;
+            break;
+    }
+}
+
+void AsyncRadioController::onSNR(float snr)
+{
+    Event e;
+    e.type = Event::Type::SNR;
+    e.value = snr;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onFrequencyCorrectorChange(int fine, int coarse)
+{
+    Event e;
+    e.type = Event::Type::FrequencyCorrector;
+    e.a = fine;
+    e.b = coarse;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onSyncChange(char isSync)
+{
+    Event e;
+    e.type = Event::Type::Sync;
+    e.a = isSync;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onSignalPresence(bool isSignal)
+{
+    Event e;
+    e.type = Event::Type::SignalPresence;
+    e.a = isSignal;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onServiceDetected(uint32_t sId)
+{
+    Event e;
+    e.type = Event::Type::ServiceDetected;
+    e.a = sId;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onNewEnsemble(uint16_t eId)
+{
+    Event e;
+    e.type = Event::Type::NewEnsemble;
+    e.a = eId;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onSetEnsembleLabel(DabLabel& label)
+{
+    Event e;
+    e.call = [label](RadioControllerInterface& c) mutable {
+        c.onSetEnsembleLabel(label); };
+    push(std::move(e));
+}
+
+void AsyncRadioController::onDateTimeUpdate(const dab_date_time_t& dateTime)
+{
+    Event e;
+    e.call = [dateTime](RadioControllerInterface& c) {
+        c.onDateTimeUpdate(dateTime); };
+    push(std::move(e));
+}
+
+void AsyncRadioController::onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib)
+{
+    Event e;
+    e.type = Event::Type::FIB;
+    e.a = crcCheckOk;
+    e.fib.fill(0);
+    for (size_t i = 0; i < 256; i++) {
+        e.fib[i / 8] |= (fib[i] & 1) << (7 - i % 8);
+    }
+    push(std::move(e));
+}
+
+uint32_t AsyncRadioController::getDiagnosticSubscriptions() const
+{
+    return controller.getDiagnosticSubscriptions();
+}
+
+void AsyncRadioController::onNewImpulseResponse(std::vector<float>&& data)
+{
+    Event e;
+    e.type = Event::Type::ImpulseResponse;
+    e.floats = std::move(data);
+    push(std::move(e));
+}
+
+void AsyncRadioController::onConstellationPoints(std::vector<DSPCOMPLEX>&& data)
+{
+    Event e;
+    e.type = Event::Type::Constellation;
+    e.samples = std::move(data);
+    push(std::move(e));
+}
+
+void AsyncRadioController::onNewNullSymbol(std::vector<DSPCOMPLEX>&& data)
+{
+    Event e;
+    e.type = Event::Type::NullSymbol;
+    e.samples = std::move(data);
+    push(std::move(e));
+}
+
+void AsyncRadioController::onTIIMeasurement(tii_measurement_t&& m)
+{
+    Event e;
+    e.type = Event::Type::TII;
+    e.tii = std::move(m);
+    push(std::move(e));
+}
+
+void AsyncRadioController::onMessage(message_level_t level, const std::string& text, const std::string& text2)
+{
+    Event e;
+    e.type = Event::Type::Message;
+    e.level = level;
+    e.text = text;
+    e.text2 = text2;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onInputFailure()
+{
+    Event e;
+    e.type = Event::Type::InputFailure;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onRestartService()
+{
+    Event e;
+    e.type = Event::Type::RestartService;
+    push(std::move(e));
+}
+
+void AsyncRadioController::onAnnouncementSupportUpdate(const ServiceAnnouncementSupport& support)
+{
+    Event e;
+    e.call = [support](RadioControllerInterface& c) {
+        c.onAnnouncementSupportUpdate(support); };
+    push(std::move(e));
+}
+
+void AsyncRadioController::onAnnouncementSwitchingUpdate(const std::vector<ActiveAnnouncement>& announcements)
+{
+    Event e;
+    e.call = [announcements](RadioControllerInterface& c) {
+        c.onAnnouncementSwitchingUpdate(announcements); };
+    push(std::move(e));
+}
+
+void AsyncRadioController::onAlarmFlagUpdate(bool alarm_enabled)
+{
+    Event e;
+    e.call = [alarm_enabled](RadioControllerInterface& c) {
+        c.onAlarmFlagUpdate(alarm_enabled); };
+    push(std::move(e));
+}
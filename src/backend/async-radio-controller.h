@@ -0,0 +1,142 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ASYNC_RADIO_CONTROLLER_H
+#define ASYNC_RADIO_CONTROLLER_H
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "radio-controller.h"
+#include "various/mpsc_queue.h"
+
+struct EventQueueStats {
+    // Configured number of events that can wait for the dispatcher
+    size_t depth = 0;
+    // Events waiting now, and the most that were waiting at the same time
+    size_t pending = 0;
+    size_t highWaterMark = 0;
+    uint64_t eventsDelivered = 0;
+    // Diagnostic events that were discarded because the queue was full
+    uint64_t eventsDropped = 0;
+};
+
+/* Delivers the callbacks of the backend to a RadioControllerInterface on
+ * a dispatcher thread of its own. The DSP threads only move the event
+ * into a lock-free queue, so that a controller that takes its locks in
+ * the callbacks, or is slow, never stalls the demodulation. When the
+ * queue is full, a diagnostic event (SNR, frequency correction, FIB CRC,
+ * plots and TII) is dropped and counted. The others change the state of
+ * the controller, their sender waits for the dispatcher to make room.
+ *
+ * The events keep their order. getDiagnosticSubscriptions is not an
+ * event and is forwarded to the controller directly. */
+class AsyncRadioController : public RadioControllerInterface {
+    public:
+        AsyncRadioController(RadioControllerInterface& controller,
+                size_t queueDepth);
+        ~AsyncRadioController();
+        AsyncRadioController(const AsyncRadioController&) = delete;
+        AsyncRadioController& operator=(const AsyncRadioController&) = delete;
+
+        EventQueueStats getStats(void) const;
+
+        virtual void onSNR(float snr) override;
+        virtual void onFrequencyCorrectorChange(int fine, int coarse) override;
+        virtual void onSyncChange(char isSync) override;
+        virtual void onSignalPresence(bool isSignal) override;
+        virtual void onServiceDetected(uint32_t sId) override;
+        virtual void onNewEnsemble(uint16_t eId) override;
+        virtual void onSetEnsembleLabel(DabLabel& label) override;
+        virtual void onDateTimeUpdate(const dab_date_time_t& dateTime) override;
+        virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override;
+        virtual uint32_t getDiagnosticSubscriptions(void) const override;
+        virtual void onNewImpulseResponse(std::vector<float>&& data) override;
+        virtual void onConstellationPoints(std::vector<DSPCOMPLEX>&& data) override;
+        virtual void onNewNullSymbol(std::vector<DSPCOMPLEX>&& data) override;
+        virtual void onTIIMeasurement(tii_measurement_t&& m) override;
+        virtual void onMessage(message_level_t level, const std::string& text, const std::string& text2 = std::string()) override;
+        virtual void onInputFailure(void) override;
+        virtual void onRestartService(void) override;
+        virtual void onAnnouncementSupportUpdate(const ServiceAnnouncementSupport& support) override;
+        virtual void onAnnouncementSwitchingUpdate(const std::vector<ActiveAnnouncement>& announcements) override;
+        virtual void onAlarmFlagUpdate(bool alarm_enabled) override;
+
+    private:
+        struct Event {
+            enum class Type {
+                SNR, FrequencyCorrector, Sync, SignalPresence,
+                ServiceDetected, NewEnsemble, FIB, ImpulseResponse,
+                Constellation, NullSymbol, TII, Message, InputFailure,
+                RestartService,
+                // The rare events with larger arguments
+                Call,
+            };
+            Type type = Type::Call;
+
+            float value = 0;
+            int32_t a = 0;
+            int32_t b = 0;
+            // The 256 bits of a FIB, packed
+            std::array<uint8_t, 32> fib;
+            std::vector<float> floats;
+            std::vector<DSPCOMPLEX> samples;
+            tii_measurement_t tii;
+            message_level_t level = message_level_t::Information;
+            std::string text;
+            std::string text2;
+            std::function<void(RadioControllerInterface&)> call;
+        };
+
+        static bool isDiagnostic(Event::Type type);
+        void push(Event&& event);
+        void deliver(Event& event);
+        void dispatcher(void);
+
+        RadioControllerInterface& controller;
+        MpscQueue<Event> queue;
+
+        std::atomic<size_t> highWaterMark = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> eventsDelivered = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> eventsDropped = ATOMIC_VAR_INIT(0);
+
+        // The producers only take the mutex to wake up the dispatcher
+        // when it sleeps.
+        std::mutex mutex;
+        std::condition_variable event_cv;
+        std::atomic<bool> sleeping = ATOMIC_VAR_INIT(false);
+
+        std::atomic<bool> running = ATOMIC_VAR_INIT(true);
+        std::thread thread;
+};
+
+#endif
@@ -0,0 +1,236 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include "channel-scan.h"
+#include "fib-processor.h"
+
+constexpr int32_t SignalDetector::energyBlocks;
+constexpr float SignalDetector::bandThreshold;
+constexpr int32_t SignalDetector::envelopeBlock;
+constexpr int32_t SignalDetector::frameCount;
+constexpr float SignalDetector::nullThreshold;
+
+// The bins next to DC, where the tuners leave their offset
+static const int32_t dcGuard = 4;
+
+SignalDetector::SignalDetector(const DABParams& params) :
+    T_u(params.T_u),
+    K(params.K),
+    blocksPerFrame(params.T_F / envelopeBlock),
+    nullBlocks(std::max(params.T_null / envelopeBlock - 1, 1)),
+    fft_handler(params.T_u),
+    fft_buffer(fft_handler.getVector())
+{
+    envelope.reserve(frameCount * blocksPerFrame);
+}
+
+void SignalDetector::reset()
+{
+    blocksSeen = 0;
+    inBandPower = 0;
+    guardBandPower = 0;
+    bandRatio = 0;
+    nullDepth = 1;
+    envelope.clear();
+}
+
+SignalDetector::Verdict SignalDetector::process(const DSPCOMPLEX *v)
+{
+    if (blocksSeen < energyBlocks) {
+        std::copy(v, v + T_u, fft_buffer);
+        fft_handler.do_FFT();
+
+        // The carriers are on both sides of DC, the guard band is
+        // around T_u / 2. Leave a margin for the frequency offset of
+        // the tuner and the edges of its filter.
+        const int32_t margin = (T_u - K) / 8;
+        for (int32_t k = dcGuard; k <= K / 2; k++) {
+            inBandPower += std::norm(fft_buffer[k]) +
+                std::norm(fft_buffer[T_u - k]);
+        }
+        for (int32_t k = K / 2 + margin; k <= T_u - K / 2 - margin; k++) {
+            guardBandPower += std::norm(fft_buffer[k]);
+        }
+    }
+
+    for (int32_t i = 0; i + envelopeBlock <= T_u; i += envelopeBlock) {
+        float power = 0;
+        for (int32_t j = i; j < i + envelopeBlock; j++) {
+            power += std::norm(v[j]);
+        }
+        envelope.push_back(power);
+    }
+
+    if (++blocksSeen == energyBlocks and testEnergy() == Verdict::Empty) {
+        return Verdict::Empty;
+    }
+
+    if ((int32_t)envelope.size() >= frameCount * blocksPerFrame) {
+        return testPeriodicity();
+    }
+    return Verdict::Undecided;
+}
+
+SignalDetector::Verdict SignalDetector::testEnergy()
+{
+    const int32_t margin = (T_u - K) / 8;
+    const double inBandMean = inBandPower / (2 * (K / 2 - dcGuard + 1));
+    const double guardBandMean = guardBandPower / (T_u - K - 2 * margin + 1);
+
+    if (guardBandMean > 0) {
+        bandRatio = inBandMean / guardBandMean;
+    }
+    else {
+        bandRatio = inBandMean > 0 ? std::numeric_limits<float>::max() : 0;
+    }
+
+    return bandRatio < bandThreshold ? Verdict::Empty : Verdict::Undecided;
+}
+
+SignalDetector::Verdict SignalDetector::testPeriodicity()
+{
+    std::vector<double> folded(blocksPerFrame, 0);
+    for (int32_t f = 0; f < frameCount; f++) {
+        for (int32_t p = 0; p < blocksPerFrame; p++) {
+            folded[p] += envelope[f * blocksPerFrame + p];
+        }
+    }
+
+    double total = 0;
+    for (const double power : folded) {
+        total += power;
+    }
+    if (total <= 0) {
+        return Verdict::NotDab;
+    }
+
+    // The nullBlocks consecutive blocks with the least power, the
+    // frame being circular
+    double window = 0;
+    for (int32_t p = 0; p < nullBlocks; p++) {
+        window += folded[p];
+    }
+    double dip = window;
+    int32_t dipStart = 0;
+    for (int32_t p = 1; p < blocksPerFrame; p++) {
+        window += folded[(p + nullBlocks - 1) % blocksPerFrame] - folded[p - 1];
+        if (window < dip) {
+            dip = window;
+            dipStart = p;
+        }
+    }
+
+    nullDepth = (dip / nullBlocks) / (total / blocksPerFrame);
+    if (nullDepth >= nullThreshold) {
+        return Verdict::NotDab;
+    }
+
+    // A fade in one frame must not pass for a null symbol
+    for (int32_t f = 0; f < frameCount; f++) {
+        const float *frame = &envelope[f * blocksPerFrame];
+        double frameTotal = 0;
+        for (int32_t p = 0; p < blocksPerFrame; p++) {
+            frameTotal += frame[p];
+        }
+
+        double frameDip = 0;
+        for (int32_t p = 0; p < nullBlocks; p++) {
+            frameDip += frame[(dipStart + p) % blocksPerFrame];
+        }
+
+        if (frameDip / nullBlocks >=
+                nullThreshold * frameTotal / blocksPerFrame) {
+            return Verdict::NotDab;
+        }
+    }
+
+    return Verdict::Dab;
+}
+
+float SignalDetector::getBandRatio() const
+{
+    return 10 * std::log10(std::max(bandRatio, 1e-6f));
+}
+
+float SignalDetector::getNullDepth() const
+{
+    return nullDepth;
+}
+
+int32_t SignalDetector::getSamplesUsed() const
+{
+    return blocksSeen * T_u;
+}
+
+ScanDwell::ScanDwell(std::chrono::milliseconds settleTime,
+        std::chrono::milliseconds maxDwell) :
+    settleTime(settleTime),
+    maxDwell(maxDwell)
+{
+    start();
+}
+
+void ScanDwell::start()
+{
+    timeStart = std::chrono::steady_clock::now();
+    timeLastChange = timeStart;
+    lastVersion = 0;
+    complete = false;
+}
+
+bool ScanDwell::isDone(const EnsembleSnapshot& ensemble)
+{
+    const auto now = std::chrono::steady_clock::now();
+    if (ensemble.version != lastVersion) {
+        lastVersion = ensemble.version;
+        timeLastChange = now;
+    }
+
+    complete = not ensemble.ensembleLabel.fig1_label.empty() and
+        not ensemble.services.empty() and
+        std::all_of(ensemble.services.begin(), ensemble.services.end(),
+                [](const Service& s) {
+                    return not s.serviceLabel.fig1_label.empty();
+                });
+
+    if (complete and now - timeLastChange >= settleTime) {
+        return true;
+    }
+    return now - timeStart >= maxDwell;
+}
+
+bool ScanDwell::isComplete() const
+{
+    return complete;
+}
+
+std::chrono::milliseconds ScanDwell::elapsed() const
+{
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - timeStart);
+}
@@ -0,0 +1,132 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef CHANNEL_SCAN_H
+#define CHANNEL_SCAN_H
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+#include "dab-constants.h"
+#include "fft.h"
+
+struct EnsembleSnapshot;
+
+/* Tells from the first samples after a tune, before any attempt to
+ * synchronise, whether the channel carries a DAB signal. Two tests, the
+ * cheapest first:
+ *
+ *  - Energy: over the spectra of the first energyBlocks blocks of T_u
+ *    samples, the mean power of the bins of the K carriers is compared
+ *    to the one of the guard band between both ends of the carriers.
+ *    Noise is flat, below bandThreshold the channel is empty. This
+ *    takes a few milliseconds.
+ *
+ *  - Null symbol periodicity: the power of the first frameCount frames,
+ *    in blocks of envelopeBlock samples, is folded modulo the length of
+ *    a frame. A DAB signal leaves a dip as long as the null symbol at
+ *    the same place in every frame, in which the power stays below
+ *    nullThreshold times the mean power of the frame.
+ */
+class SignalDetector {
+    public:
+        enum class Verdict { Undecided, Empty, NotDab, Dab };
+
+        SignalDetector(const DABParams& params);
+        SignalDetector(const SignalDetector&) = delete;
+        SignalDetector& operator=(const SignalDetector&) = delete;
+
+        void reset(void);
+
+        /* Give the next T_u samples of the input. Returns Undecided as
+         * long as more samples are needed, at most frameCount * T_F. */
+        Verdict process(const DSPCOMPLEX *v);
+
+        // The ratio of the energy test, in dB
+        float getBandRatio(void) const;
+        // The power in the dip found by the periodicity test, relative
+        // to the mean power, 1 before the test
+        float getNullDepth(void) const;
+        int32_t getSamplesUsed(void) const;
+
+        static constexpr int32_t energyBlocks = 8;
+        static constexpr float bandThreshold = 2.0; // 3 dB
+        static constexpr int32_t envelopeBlock = 256;
+        static constexpr int32_t frameCount = 2;
+        static constexpr float nullThreshold = 0.5;
+
+    private:
+        Verdict testEnergy(void);
+        Verdict testPeriodicity(void);
+
+        const int32_t T_u;
+        const int32_t K;
+        const int32_t blocksPerFrame;
+        // Blocks that lie entirely in the null symbol, whatever its
+        // alignment to the blocks
+        const int32_t nullBlocks;
+
+        fft::Forward fft_handler;
+        DSPCOMPLEX *fft_buffer;
+
+        int32_t blocksSeen = 0;
+        double inBandPower = 0;
+        double guardBandPower = 0;
+        float bandRatio = 0;
+        float nullDepth = 1;
+        std::vector<float> envelope;
+};
+
+/* Decides how long a scan listens to a channel on which a DAB signal
+ * was detected: until the FIC named the ensemble and all the services
+ * it announced, and nothing changed for settleTime, but at most for
+ * maxDwell. */
+class ScanDwell {
+    public:
+        ScanDwell(std::chrono::milliseconds settleTime = std::chrono::milliseconds(2000),
+                std::chrono::milliseconds maxDwell = std::chrono::milliseconds(10000));
+
+        /* When the signal was detected */
+        void start(void);
+
+        /* Call regularly with the latest ensemble. Returns true when the
+         * scan can go on with the next channel. */
+        bool isDone(const EnsembleSnapshot& ensemble);
+
+        // The ensemble was complete, and not only the time was up
+        bool isComplete(void) const;
+        std::chrono::milliseconds elapsed(void) const;
+
+    private:
+        const std::chrono::milliseconds settleTime;
+        const std::chrono::milliseconds maxDwell;
+
+        std::chrono::steady_clock::time_point timeStart;
+        std::chrono::steady_clock::time_point timeLastChange;
+        uint64_t lastVersion = 0;
+        bool complete = false;
+};
+
+#endif
@@ -49,9 +49,11 @@ DabAudio::DabAudio(
         int16_t bitRate,
         ProtectionSettings protection,
         ProgrammeHandlerInterface& phi,
-        const std::string& dumpFileName) :
+        const std::string& dumpFileName,
+        bool singleThreaded) :
     myProgrammeHandler(phi),
-    mscBuffer(64 * 32768),
+    singleThreaded(singleThreaded),
+    mscBuffer(64 * 32768, true),
     dumpFileName(dumpFileName)
 {
     this->dabModus         = dabModus;
@@ -62,6 +64,8 @@ DabAudio::DabAudio(
     for (int i = 0; i < 16; i ++) {
         interleaveData[i].resize(fragmentSize);
     }
+    data.resize(fragmentSize);
+    tempX.resize(fragmentSize);
 
     using std::make_unique;
 
@@ -79,7 +83,9 @@ DabAudio::DabAudio(
             myProgrammeHandler, bitRate, dabModus, dumpFileName);
 
     running = true;
-    ourThread = std::thread(&DabAudio::run, this);
+    if (not singleThreaded) {
+        ourThread = std::thread(&DabAudio::run, this);
+    }
 }
 
 DabAudio::~DabAudio()
@@ -87,7 +93,10 @@ DabAudio::~DabAudio()
     running = false;
 
     if (ourThread.joinable()) {
+        { std::lock_guard<std::mutex> lock(ourMutex); }
         mscDataAvailable.notify_all();
+        mscSpaceAvailable.notify_all();
+        mscIdle.notify_all();
         ourThread.join();
     }
 }
@@ -96,70 +105,116 @@ int32_t DabAudio::process(const softbit_t *v, int16_t cnt)
 {
     int32_t fr;
 
-    if (mscBuffer.GetRingBufferWriteAvailable () < cnt)
+    if (singleThreaded) {
+        //  Decode on the caller thread, as soon as a whole
+        //  fragment is there
+        mscBuffer.write(v, cnt);
+        while (mscBuffer.readAvailable() >= (size_t)fragmentSize) {
+            decodeFragment();
+        }
+        return (int32_t)mscBuffer.writeAvailable();
+    }
+
+    if (mscBuffer.writeAvailable () < (size_t)cnt)
         fprintf (stderr, "dab-concurrent: buffer full\n");
 
-    while ((fr = mscBuffer.GetRingBufferWriteAvailable ()) <= cnt) {
+    {
+        //  run() wakes us up when it took data out of the buffer
+        std::unique_lock<std::mutex> lock(ourMutex);
+        mscSpaceAvailable.wait(lock, [&]{
+                fr = (int32_t)mscBuffer.writeAvailable ();
+                return fr > cnt or not running; });
         if (!running)
             return 0;
-        std::this_thread::sleep_for(std::chrono::microseconds(1));
     }
 
-    mscBuffer.putDataIntoBuffer(v, cnt);
+    mscBuffer.write(v, cnt);
+    {
+        std::lock_guard<std::mutex> lock(ourMutex);
+        idle = false;
+    }
     mscDataAvailable.notify_all();
     return fr;
 }
 
+void DabAudio::drain()
+{
+    //  Single-threaded, process() decodes before it returns
+    if (singleThreaded)
+        return;
+
+    std::unique_lock<std::mutex> lock(ourMutex);
+    mscIdle.wait(lock, [&]{ return idle or not running; });
+}
+
 const int16_t interleaveMap[] = {0,8,4,12,2,10,6,14,1,9,5,13,3,11,7,15};
 
 void DabAudio::run()
 {
-    int16_t i;
-    int16_t countforInterleaver = 0;
-    int16_t interleaverIndex    = 0;
-    std::vector<softbit_t> data(fragmentSize);
-    std::vector<softbit_t> tempX(fragmentSize);
-
     while (running) {
         std::unique_lock<std::mutex> lock(ourMutex);
-        while (running && mscBuffer.GetRingBufferReadAvailable() <= fragmentSize) {
+        while (running && mscBuffer.readAvailable() < (size_t)fragmentSize) {
+            idle = true;
+            mscIdle.notify_all();
             mscDataAvailable.wait(lock);
         }
         if (!running)
             break;
+        idle = false;
 
         // mscBuffer is threadsafe to access, no need to keep the lock
         lock.unlock();
 
-        PROFILE(DAGetMSCData);
-        mscBuffer.getDataFromBuffer(data.data(), fragmentSize);
+        decodeFragment();
+    }
+}
+
+void DabAudio::decodeFragment()
+{
+    PROFILE(DAGetMSCData);
+    //  Deinterleave straight from the ring, unless the fragment
+    //  wraps around, which only happens if it could not be mirrored
+    const auto span = mscBuffer.acquireRead(fragmentSize);
+    const bool inPlace = span.size == (size_t)fragmentSize;
+    const softbit_t *fragment = span.data;
+    if (not inPlace) {
+        mscBuffer.read(data.data(), fragmentSize);
+        fragment = data.data();
+    }
 
-        PROFILE(DADeinterleave);
-        for (i = 0; i < fragmentSize; i ++) {
-            tempX[i] = interleaveData[(interleaverIndex +
-                    interleaveMap[i & 017]) & 017][i];
-            interleaveData[interleaverIndex][i] = data[i];
-        }
-        interleaverIndex = (interleaverIndex + 1) & 0x0F;
+    PROFILE(DADeinterleave);
+    for (int16_t i = 0; i < fragmentSize; i ++) {
+        tempX[i] = interleaveData[(interleaverIndex +
+                interleaveMap[i & 017]) & 017][i];
+        interleaveData[interleaverIndex][i] = fragment[i];
+    }
+    interleaverIndex = (interleaverIndex + 1) & 0x0F;
 
-        //  only continue when de-interleaver is filled
-        if (countforInterleaver <= 15) {
-            countforInterleaver ++;
-            continue;
-        }
+    if (inPlace) {
+        mscBuffer.commitRead(fragmentSize);
+    }
+    if (not singleThreaded) {
+        { std::lock_guard<std::mutex> lock(ourMutex); }
+        mscSpaceAvailable.notify_all();
+    }
 
-        PROFILE(DADeconvolve);
-        protectionHandler->deconvolve(tempX.data(), fragmentSize, outV.data());
+    //  only continue when de-interleaver is filled
+    if (countforInterleaver <= 15) {
+        countforInterleaver ++;
+        return;
+    }
 
-        PROFILE(DADispersal);
-        // and the inline energy dispersal
-        energyDispersal.dedisperse(outV);
+    PROFILE(DADeconvolve);
+    protectionHandler->deconvolve(tempX.data(), fragmentSize, outV.data());
 
-        if (our_dabProcessor) {
-            PROFILE(DADecode);
-            our_dabProcessor->addtoFrame(outV.data());
-        }
-        PROFILE(DADone);
+    PROFILE(DADispersal);
+    // and the inline energy dispersal
+    energyDispersal.dedisperse(outV);
+
+    if (our_dabProcessor) {
+        PROFILE(DADecode);
+        our_dabProcessor->addtoFrame(outV.data());
     }
+    PROFILE(DADone);
 }
 
@@ -33,7 +33,7 @@
 #include <mutex>
 #include <condition_variable>
 #include <cstdio>
-#include "ringbuffer.h"
+#include "spsc_ring.h"
 #include "energy_dispersal.h"
 #include "radio-controller.h"
 
@@ -48,33 +48,45 @@ class DabAudio : public DabVirtual
                   int16_t bitRate,
                   ProtectionSettings protection,
                   ProgrammeHandlerInterface& phi,
-                  const std::string& dumpFileName);
+                  const std::string& dumpFileName,
+                  bool singleThreaded = false);
         virtual ~DabAudio(void);
         DabAudio(const DabAudio&) = delete;
         DabAudio& operator=(const DabAudio&) = delete;
 
         int32_t process(const softbit_t *v, int16_t cnt);
+        void drain() override;
 
     protected:
         ProgrammeHandlerInterface& myProgrammeHandler;
 
     private:
         void    run(void);
+        void    decodeFragment(void);
         std::atomic<bool> running;
+        const bool singleThreaded;
         AudioServiceComponentType dabModus;
         int16_t fragmentSize;
         int16_t bitRate;
         std::vector<uint8_t> outV;
         std::vector<softbit_t> interleaveData[16];
+        int16_t countforInterleaver = 0;
+        int16_t interleaverIndex = 0;
+        std::vector<softbit_t> data;
+        std::vector<softbit_t> tempX;
         EnergyDispersal energyDispersal;
 
         std::condition_variable  mscDataAvailable;
+        std::condition_variable  mscSpaceAvailable;
+        //  run() waits for a whole fragment, after decoding the last one
+        std::condition_variable  mscIdle;
+        bool                     idle = true;
         std::mutex               ourMutex;
         std::thread              ourThread;
 
         std::unique_ptr<Protection> protectionHandler;
         std::unique_ptr<DabProcessor> our_dabProcessor;
-        RingBuffer<softbit_t> mscBuffer;
+        SpscRing<softbit_t> mscBuffer;
 
         const std::string dumpFileName;
 };
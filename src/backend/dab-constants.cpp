@@ -178,6 +178,26 @@ string DabLabel::fig2_label() const
     throw logic_error("invalid extended label charset " + to_string((int)extended_label_charset));
 }
 
+bool operator==(const DabLabel& a, const DabLabel& b)
+{
+    return a.charset == b.charset and
+        a.fig1_label == b.fig1_label and
+        a.fig1_flag == b.fig1_flag and
+        a.segments == b.segments and
+        a.segment_count == b.segment_count and
+        a.extended_label_charset == b.extended_label_charset and
+        a.toggle_flag == b.toggle_flag and
+        a.fig2_rfu == b.fig2_rfu;
+}
+
+bool operator==(const Service& a, const Service& b)
+{
+    return a.serviceId == b.serviceId and
+        a.serviceLabel == b.serviceLabel and
+        a.language == b.language and
+        a.programType == b.programType;
+}
+
 const char* DABConstants::getProgramTypeName(int type)
 {
     const char* typeName = "";
@@ -341,6 +361,11 @@ const char* DABConstants::getLanguageName(int language)
 }
 
 
+constexpr int16_t DABModeI::L;
+constexpr int16_t DABModeI::K;
+constexpr int16_t DABModeI::T_s;
+constexpr int16_t DABModeI::T_u;
+
 DABParams::DABParams(int mode)
 {
     setMode(mode);
@@ -499,6 +524,26 @@ string Subchannel::protection() const
     return prot;
 }
 
+bool operator==(const ProtectionSettings& a, const ProtectionSettings& b)
+{
+    return a.shortForm == b.shortForm and
+        a.uepTableIndex == b.uepTableIndex and
+        a.uepLevel == b.uepLevel and
+        a.eepProfile == b.eepProfile and
+        a.eepLevel == b.eepLevel;
+}
+
+bool operator==(const Subchannel& a, const Subchannel& b)
+{
+    return a.subChId == b.subChId and
+        a.startAddr == b.startAddr and
+        a.length == b.length and
+        a.programmeNotData == b.programmeNotData and
+        a.protectionSettings == b.protectionSettings and
+        a.language == b.language and
+        a.fecScheme == b.fecScheme;
+}
+
 TransportMode ServiceComponent::transportMode() const
 {
     if (TMid == 0) {
@@ -529,3 +574,18 @@ AudioServiceComponentType ServiceComponent::audioType() const
     }
 }
 
+bool operator==(const ServiceComponent& a, const ServiceComponent& b)
+{
+    return a.TMid == b.TMid and
+        a.SId == b.SId and
+        a.componentNr == b.componentNr and
+        a.componentLabel == b.componentLabel and
+        a.ASCTy == b.ASCTy and
+        a.PS_flag == b.PS_flag and
+        a.subchannelId == b.subchannelId and
+        a.SCId == b.SCId and
+        a.CAflag == b.CAflag and
+        a.DSCTy == b.DSCTy and
+        a.DGflag == b.DGflag and
+        a.packetAddress == b.packetAddress;
+}
@@ -85,6 +85,15 @@ public:
     int16_t carrierDiff;
 };
 
+// The dimensions of transmission mode I, the mode of all current
+// multiplexes, for the code that is specialised for it at compile time.
+struct DABModeI {
+    static constexpr int16_t L = 76;
+    static constexpr int16_t K = 1536;
+    static constexpr int16_t T_s = 2552;
+    static constexpr int16_t T_u = 2048;
+};
+
 struct DabLabel {
     // Label from FIG 1
     /* FIG 1 labels are usually in EBU Latin encoded */
@@ -117,6 +126,8 @@ struct DabLabel {
     std::string utf8_label() const;
 };
 
+bool operator==(const DabLabel& a, const DabLabel& b);
+
 struct Service {
     Service(uint32_t sid) : serviceId(sid) {}
 
@@ -127,6 +138,8 @@ struct Service {
     int16_t  programType = 0; // PTy, FIG0/17
 };
 
+bool operator==(const Service& a, const Service& b);
+
 //      The service component describes the actual service
 //      It really should be a union
 struct ServiceComponent {
@@ -149,6 +162,8 @@ struct ServiceComponent {
     AudioServiceComponentType audioType(void) const;
 };
 
+bool operator==(const ServiceComponent& a, const ServiceComponent& b);
+
 enum class EEPProtectionProfile {
     EEP_A,
     EEP_B,
@@ -173,6 +188,8 @@ struct ProtectionSettings {
     EEPProtectionLevel eepLevel = EEPProtectionLevel::EEP_3;
 };
 
+bool operator==(const ProtectionSettings& a, const ProtectionSettings& b);
+
 struct Subchannel {
     int32_t  subChId = -1;
     int32_t  startAddr = 0;
@@ -197,5 +214,7 @@ struct Subchannel {
     inline bool valid() const { return subChId != -1; }
 };
 
+bool operator==(const Subchannel& a, const Subchannel& b);
+
 
 #endif
@@ -0,0 +1,347 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <cmath>
+#include "differential-demod.h"
+#include "freq-interleaver.h"
+#include "various/cpu_features.h"
+
+#if defined(WELLE_HAVE_X86_SIMD)
+#  include <immintrin.h>
+#endif
+
+// The NEON kernel needs the division of AArch64 to be exact
+#if defined(WELLE_HAVE_NEON) && defined(__aarch64__)
+#  define WELLE_HAVE_NEON_DEMOD 1
+#  include <arm_neon.h>
+#endif
+
+static_assert(sizeof(DSPCOMPLEX) == 2 * sizeof(float),
+        "The kernels work on interleaved float samples");
+
+//  The kernels avoid std::complex multiplication, which checks for NaN
+//  and infinity. A carrier and its reference both at zero give zero
+//  soft bits instead of the NaN of 127 / 0.
+
+static inline void demod_carrier(const float *spectrum, const float *reference,
+        int32_t idx, float& re, float& im)
+{
+    const float s_re = spectrum[2 * idx];
+    const float s_im = spectrum[2 * idx + 1];
+    const float r_re = reference[2 * idx];
+    const float r_im = reference[2 * idx + 1];
+    re = s_re * r_re + s_im * r_im;
+    im = s_im * r_re - s_re * r_im;
+}
+
+//  Carriers first to K - 1, also the tail of the SIMD kernels
+static inline void demod_tail(const float *spectrum, const float *reference,
+        const int32_t *index, int32_t K, int32_t first, softbit_t *bits)
+{
+    for (int32_t i = first; i < K; i++) {
+        float re, im;
+        demod_carrier(spectrum, reference, index[i], re, im);
+        const float l1 = std::abs(re) + std::abs(im);
+        const float ab = l1 > 0 ? 127.0f / l1 : 0.0f;
+        bits[i]     = -re * ab;
+        bits[K + i] = -im * ab;
+    }
+}
+
+template<int32_t FixedK>
+static void demod_generic(const float *spectrum, const float *reference,
+        const int32_t *index, int32_t carriers, softbit_t *bits)
+{
+    const int32_t K = FixedK ? FixedK : carriers;
+    demod_tail(spectrum, reference, index, K, 0, bits);
+}
+
+#if defined(WELLE_HAVE_X86_SIMD)
+//  Four carriers: the soft bits of the real and imaginary parts
+__attribute__((target("sse2")))
+static inline void demod4_SSE2(const float *spectrum, const float *reference,
+        const int32_t *index, __m128i& bits_re, __m128i& bits_im)
+{
+    const double *s = reinterpret_cast<const double*>(spectrum);
+    const double *r = reinterpret_cast<const double*>(reference);
+
+    // Gather the carriers, two complex samples per register
+    const __m128 s01 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(s + index[0]), s + index[1]));
+    const __m128 s23 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(s + index[2]), s + index[3]));
+    const __m128 r01 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(r + index[0]), r + index[1]));
+    const __m128 r23 = _mm_castpd_ps(_mm_loadh_pd(_mm_load_sd(r + index[2]), r + index[3]));
+
+    const __m128 s_re = _mm_shuffle_ps(s01, s23, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 s_im = _mm_shuffle_ps(s01, s23, _MM_SHUFFLE(3, 1, 3, 1));
+    const __m128 r_re = _mm_shuffle_ps(r01, r23, _MM_SHUFFLE(2, 0, 2, 0));
+    const __m128 r_im = _mm_shuffle_ps(r01, r23, _MM_SHUFFLE(3, 1, 3, 1));
+
+    const __m128 re = _mm_add_ps(_mm_mul_ps(s_re, r_re), _mm_mul_ps(s_im, r_im));
+    const __m128 im = _mm_sub_ps(_mm_mul_ps(s_im, r_re), _mm_mul_ps(s_re, r_im));
+
+    const __m128 sign = _mm_set1_ps(-0.0f);
+    const __m128 l1 = _mm_add_ps(_mm_andnot_ps(sign, re), _mm_andnot_ps(sign, im));
+    const __m128 ab = _mm_and_ps(_mm_cmpgt_ps(l1, _mm_setzero_ps()),
+            _mm_div_ps(_mm_set1_ps(127.0f), l1));
+
+    bits_re = _mm_cvttps_epi32(_mm_mul_ps(_mm_xor_ps(re, sign), ab));
+    bits_im = _mm_cvttps_epi32(_mm_mul_ps(_mm_xor_ps(im, sign), ab));
+}
+
+template<int32_t FixedK>
+__attribute__((target("sse2")))
+static void demod_SSE2(const float *spectrum, const float *reference,
+        const int32_t *index, int32_t carriers, softbit_t *bits)
+{
+    const int32_t K = FixedK ? FixedK : carriers;
+    int32_t i = 0;
+    for (; i + 16 <= K; i += 16) {
+        __m128i re[4], im[4];
+        for (int k = 0; k < 4; k++) {
+            demod4_SSE2(spectrum, reference, index + i + 4 * k, re[k], im[k]);
+        }
+        // Saturate to int8 in carrier order
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bits + i), _mm_packs_epi16(
+                    _mm_packs_epi32(re[0], re[1]), _mm_packs_epi32(re[2], re[3])));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(bits + K + i), _mm_packs_epi16(
+                    _mm_packs_epi32(im[0], im[1]), _mm_packs_epi32(im[2], im[3])));
+    }
+
+    demod_tail(spectrum, reference, index, K, i, bits);
+}
+
+//  The shuffles work within the 128-bit lanes, put the carriers back
+//  in order
+__attribute__((target("avx2")))
+static inline __m256 in_order_AVX2(__m256 v)
+{
+    return _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(v), 0xD8));
+}
+
+__attribute__((target("avx2")))
+static inline __m256 gather4_AVX2(const float *samples, const int32_t *index)
+{
+    const double *p = reinterpret_cast<const double*>(samples);
+    const __m128d lo = _mm_loadh_pd(_mm_load_sd(p + index[0]), p + index[1]);
+    const __m128d hi = _mm_loadh_pd(_mm_load_sd(p + index[2]), p + index[3]);
+    return _mm256_castpd_ps(_mm256_insertf128_pd(_mm256_castpd128_pd256(lo), hi, 1));
+}
+
+//  Eight carriers
+__attribute__((target("avx2")))
+static inline void demod8_AVX2(const float *spectrum, const float *reference,
+        const int32_t *index, __m256i& bits_re, __m256i& bits_im)
+{
+    // Gather four complex samples per register, the gather instruction
+    // is slower than the loads on most CPUs
+    const __m256 s0 = gather4_AVX2(spectrum, index);
+    const __m256 s1 = gather4_AVX2(spectrum, index + 4);
+    const __m256 r0 = gather4_AVX2(reference, index);
+    const __m256 r1 = gather4_AVX2(reference, index + 4);
+
+    const __m256 s_re = in_order_AVX2(_mm256_shuffle_ps(s0, s1, 0x88));
+    const __m256 s_im = in_order_AVX2(_mm256_shuffle_ps(s0, s1, 0xDD));
+    const __m256 r_re = in_order_AVX2(_mm256_shuffle_ps(r0, r1, 0x88));
+    const __m256 r_im = in_order_AVX2(_mm256_shuffle_ps(r0, r1, 0xDD));
+
+    const __m256 re = _mm256_add_ps(_mm256_mul_ps(s_re, r_re), _mm256_mul_ps(s_im, r_im));
+    const __m256 im = _mm256_sub_ps(_mm256_mul_ps(s_im, r_re), _mm256_mul_ps(s_re, r_im));
+
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    const __m256 l1 = _mm256_add_ps(_mm256_andnot_ps(sign, re), _mm256_andnot_ps(sign, im));
+    const __m256 ab = _mm256_and_ps(_mm256_cmp_ps(l1, _mm256_setzero_ps(), _CMP_GT_OQ),
+            _mm256_div_ps(_mm256_set1_ps(127.0f), l1));
+
+    bits_re = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_xor_ps(re, sign), ab));
+    bits_im = _mm256_cvttps_epi32(_mm256_mul_ps(_mm256_xor_ps(im, sign), ab));
+}
+
+//  Saturate 32 values to int8, the packs work within the 128-bit lanes
+__attribute__((target("avx2")))
+static inline __m256i pack_AVX2(const __m256i *v)
+{
+    const __m256i p = _mm256_packs_epi16(
+            _mm256_packs_epi32(v[0], v[1]), _mm256_packs_epi32(v[2], v[3]));
+    return _mm256_permutevar8x32_epi32(p, _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7));
+}
+
+template<int32_t FixedK>
+__attribute__((target("avx2")))
+static void demod_AVX2(const float *spectrum, const float *reference,
+        const int32_t *index, int32_t carriers, softbit_t *bits)
+{
+    const int32_t K = FixedK ? FixedK : carriers;
+    int32_t i = 0;
+    for (; i + 32 <= K; i += 32) {
+        __m256i re[4], im[4];
+        for (int k = 0; k < 4; k++) {
+            demod8_AVX2(spectrum, reference, index + i + 8 * k, re[k], im[k]);
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bits + i), pack_AVX2(re));
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(bits + K + i), pack_AVX2(im));
+    }
+
+    demod_tail(spectrum, reference, index, K, i, bits);
+}
+#endif
+
+#if defined(WELLE_HAVE_NEON_DEMOD)
+//  Four carriers, saturated to int16
+static inline void demod4_NEON(const float *spectrum, const float *reference,
+        const int32_t *index, int16x4_t& bits_re, int16x4_t& bits_im)
+{
+    const float32x4_t s01 = vcombine_f32(vld1_f32(spectrum + 2 * index[0]),
+            vld1_f32(spectrum + 2 * index[1]));
+    const float32x4_t s23 = vcombine_f32(vld1_f32(spectrum + 2 * index[2]),
+            vld1_f32(spectrum + 2 * index[3]));
+    const float32x4_t r01 = vcombine_f32(vld1_f32(reference + 2 * index[0]),
+            vld1_f32(reference + 2 * index[1]));
+    const float32x4_t r23 = vcombine_f32(vld1_f32(reference + 2 * index[2]),
+            vld1_f32(reference + 2 * index[3]));
+
+    const float32x4x2_t s = vuzpq_f32(s01, s23);
+    const float32x4x2_t r = vuzpq_f32(r01, r23);
+
+    // No fused multiply-add, to round like the generic kernel
+    const float32x4_t re = vaddq_f32(vmulq_f32(s.val[0], r.val[0]), vmulq_f32(s.val[1], r.val[1]));
+    const float32x4_t im = vsubq_f32(vmulq_f32(s.val[1], r.val[0]), vmulq_f32(s.val[0], r.val[1]));
+
+    const float32x4_t l1 = vaddq_f32(vabsq_f32(re), vabsq_f32(im));
+    const uint32x4_t nonzero = vcgtq_f32(l1, vdupq_n_f32(0.0f));
+    const float32x4_t ab = vreinterpretq_f32_u32(vandq_u32(nonzero,
+                vreinterpretq_u32_f32(vdivq_f32(vdupq_n_f32(127.0f), l1))));
+
+    bits_re = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(vnegq_f32(re), ab)));
+    bits_im = vqmovn_s32(vcvtq_s32_f32(vmulq_f32(vnegq_f32(im), ab)));
+}
+
+template<int32_t FixedK>
+static void demod_NEON(const float *spectrum, const float *reference,
+        const int32_t *index, int32_t carriers, softbit_t *bits)
+{
+    const int32_t K = FixedK ? FixedK : carriers;
+    int32_t i = 0;
+    for (; i + 8 <= K; i += 8) {
+        int16x4_t re0, im0, re1, im1;
+        demod4_NEON(spectrum, reference, index + i, re0, im0);
+        demod4_NEON(spectrum, reference, index + i + 4, re1, im1);
+        vst1_s8(bits + i, vqmovn_s16(vcombine_s16(re0, re1)));
+        vst1_s8(bits + K + i, vqmovn_s16(vcombine_s16(im0, im1)));
+    }
+
+    demod_tail(spectrum, reference, index, K, i, bits);
+}
+#endif
+
+DifferentialDemodulator::DifferentialDemodulator(const DABParams& params) :
+    DifferentialDemodulator(params, bestKernel())
+{
+}
+
+DifferentialDemodulator::DifferentialDemodulator(const DABParams& params,
+        DemodKernel kernel, bool specialiseModeI) :
+    kernel(kernel),
+    specialised(specialiseModeI and params.dabMode == 1),
+    demod(demod_generic<0>),
+    K(params.K),
+    index(params.K)
+{
+    /**
+     * We do not interchange the positive/negative frequencies of the
+     * FFT output, the negative carriers of the interleaver table are
+     * at the end of the FFT output.
+     */
+    FrequencyInterleaver interleaver(params);
+    for (int32_t i = 0; i < K; i++) {
+        int32_t idx = interleaver.mapIn(i);
+        if (idx < 0) {
+            idx += params.T_u;
+        }
+        index[i] = idx;
+    }
+
+    // In mode I, the kernels know the number of carriers
+    constexpr int32_t K_I = DABModeI::K;
+    switch (kernel) {
+#if defined(WELLE_HAVE_X86_SIMD)
+        case DemodKernel::SSE2:
+            demod = specialised ? demod_SSE2<K_I> : demod_SSE2<0>;
+            break;
+        case DemodKernel::AVX2:
+            demod = specialised ? demod_AVX2<K_I> : demod_AVX2<0>;
+            break;
+#endif
+#if defined(WELLE_HAVE_NEON_DEMOD)
+        case DemodKernel::NEON:
+            demod = specialised ? demod_NEON<K_I> : demod_NEON<0>;
+            break;
+#endif
+        default:
+            this->kernel = DemodKernel::Generic;
+            demod = specialised ? demod_generic<K_I> : demod_generic<0>;
+            break;
+    }
+}
+
+void DifferentialDemodulator::demodulate(const DSPCOMPLEX *spectrum,
+        const DSPCOMPLEX *reference, softbit_t *bits) const
+{
+    demod(reinterpret_cast<const float*>(spectrum),
+            reinterpret_cast<const float*>(reference),
+            index.data(), K, bits);
+}
+
+DemodKernel DifferentialDemodulator::bestKernel()
+{
+    const auto kernels = availableKernels();
+    return kernels.back();
+}
+
+std::vector<DemodKernel> DifferentialDemodulator::availableKernels()
+{
+    std::vector<DemodKernel> kernels = { DemodKernel::Generic };
+#if defined(WELLE_HAVE_X86_SIMD)
+    if (cpu_features::has_sse2())
+        kernels.push_back(DemodKernel::SSE2);
+    if (cpu_features::has_avx2())
+        kernels.push_back(DemodKernel::AVX2);
+#endif
+#if defined(WELLE_HAVE_NEON_DEMOD)
+    if (cpu_features::has_neon())
+        kernels.push_back(DemodKernel::NEON);
+#endif
+    return kernels;
+}
+
+const char *DifferentialDemodulator::kernelName(DemodKernel kernel)
+{
+    switch (kernel) {
+        case DemodKernel::Generic: return "generic";
+        case DemodKernel::SSE2: return "SSE2";
+        case DemodKernel::AVX2: return "AVX2";
+        case DemodKernel::NEON: return "NEON";
+    }
+    return "unknown";
+}
@@ -0,0 +1,87 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef DIFFERENTIAL_DEMOD_H
+#define DIFFERENTIAL_DEMOD_H
+
+/*
+ *  Differential demodulation and frequency deinterleaving of the K
+ *  carriers of an OFDM symbol, in one pass.
+ *
+ *  Carrier i of the deinterleaved symbol is at position index[i] of the
+ *  FFT output, the interleaver table combined with the FFT shift. It is
+ *  multiplied by the conjugate of the same carrier of the previous symbol,
+ *  and scaled by 127 / l1_norm to soft bits, the real part going to
+ *  bits[i] and the imaginary part to bits[K + i].
+ *
+ *  The SIMD kernels give the same soft bits as the generic one, bit for
+ *  bit, which is what the OfdmDecoder did one carrier at a time.
+ */
+
+#include <cstdint>
+#include <vector>
+#include "dab-constants.h"
+
+enum class DemodKernel { Generic, SSE2, AVX2, NEON };
+
+class DifferentialDemodulator
+{
+    public:
+        /* Uses the fastest kernel the CPU supports */
+        DifferentialDemodulator(const DABParams& params);
+
+        /* In mode I, unless specialiseModeI is false, the kernel is
+         * compiled for the 1536 carriers of that mode */
+        DifferentialDemodulator(const DABParams& params, DemodKernel kernel,
+                bool specialiseModeI = true);
+
+        void demodulate(const DSPCOMPLEX *spectrum,
+                const DSPCOMPLEX *reference, softbit_t *bits) const;
+
+        // Position of carrier i in the FFT output
+        int32_t carrierIndex(int32_t i) const { return index[i]; }
+
+        DemodKernel getKernel(void) const { return kernel; }
+        bool isSpecialised(void) const { return specialised; }
+
+        /* Runtime CPU feature detection */
+        static DemodKernel bestKernel(void);
+        static std::vector<DemodKernel> availableKernels(void);
+        static const char *kernelName(DemodKernel kernel);
+
+    private:
+        using demod_fn = void (*)(const float *spectrum,
+                const float *reference, const int32_t *index,
+                int32_t K, softbit_t *bits);
+
+        DemodKernel kernel;
+        bool specialised;
+        demod_fn demod;
+
+        int32_t K;
+        std::vector<int32_t> index;
+};
+
+#endif
@@ -0,0 +1,337 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iterator>
+#include "ensemble-cache.h"
+
+// Changed whenever the layout of the file changes
+static const char cacheMagic[8] = { 'W', 'E', 'L', 'L', 'E', 'E', 'N', 'S' };
+static const uint8_t cacheFormatVersion = 1;
+
+namespace {
+
+// All integers are little endian, strings and vectors are prefixed
+// with their length
+class Writer {
+    public:
+        void u8(uint8_t v) { data.push_back((char)v); }
+        void u16(uint16_t v) { u8(v & 0xFF); u8(v >> 8); }
+        void u32(uint32_t v) { u16(v & 0xFFFF); u16(v >> 16); }
+        void i16(int16_t v) { u16((uint16_t)v); }
+        void i32(int32_t v) { u32((uint32_t)v); }
+        void bytes(const std::string& s) { u32(s.size()); data += s; }
+        void bytes(const std::vector<uint8_t>& v) {
+            u32(v.size());
+            data.append(v.begin(), v.end());
+        }
+
+        std::string data;
+};
+
+// Every read past the end, or of an impossible length, sets failed and
+// returns zero
+class Reader {
+    public:
+        Reader(const std::string& data) : data(data) {}
+
+        uint8_t u8() {
+            if (pos >= data.size()) {
+                failed = true;
+                return 0;
+            }
+            return (uint8_t)data[pos++];
+        }
+        uint16_t u16() { const uint16_t lo = u8(); return lo | (u8() << 8); }
+        uint32_t u32() { const uint32_t lo = u16(); return lo | ((uint32_t)u16() << 16); }
+        int16_t i16() { return (int16_t)u16(); }
+        int32_t i32() { return (int32_t)u32(); }
+
+        // The number of elements of a vector, each at least minSize bytes
+        size_t count(size_t minSize) {
+            const size_t n = u32();
+            if (n > (data.size() - pos) / std::max<size_t>(minSize, 1)) {
+                failed = true;
+                return 0;
+            }
+            return n;
+        }
+
+        std::string str() {
+            const size_t n = count(1);
+            std::string s = data.substr(pos, n);
+            pos += n;
+            return s;
+        }
+
+        std::vector<uint8_t> vec() {
+            const size_t n = count(1);
+            std::vector<uint8_t> v(data.begin() + pos, data.begin() + pos + n);
+            pos += n;
+            return v;
+        }
+
+        void skip(size_t n) { pos = std::min(pos + n, data.size()); }
+
+        bool atEnd() const { return pos == data.size(); }
+
+        bool failed = false;
+
+    private:
+        const std::string& data;
+        size_t pos = 0;
+};
+
+}
+
+static void writeLabel(Writer& w, const DabLabel& label)
+{
+    w.u8((uint8_t)label.charset);
+    w.bytes(label.fig1_label);
+    w.u16(label.fig1_flag);
+    w.u32(label.segments.size());
+    for (const auto& segment : label.segments) {
+        w.i32(segment.first);
+        w.bytes(segment.second);
+    }
+    w.u32(label.segment_count);
+    w.u8((uint8_t)label.extended_label_charset);
+    w.u8(label.toggle_flag);
+    w.u8(label.fig2_rfu);
+}
+
+static DabLabel readLabel(Reader& r)
+{
+    DabLabel label;
+    label.charset = (CharacterSet)r.u8();
+    label.fig1_label = r.str();
+    label.fig1_flag = r.u16();
+    const size_t numSegments = r.count(8);
+    for (size_t i = 0; i < numSegments; i++) {
+        const int segment = r.i32();
+        label.segments[segment] = r.vec();
+    }
+    label.segment_count = r.u32();
+    label.extended_label_charset = (CharacterSet)r.u8();
+    label.toggle_flag = r.u8();
+    label.fig2_rfu = r.u8();
+    return label;
+}
+
+std::string EnsembleCache::serialise(const CachedEnsemble& ensemble)
+{
+    Writer w;
+    w.data.assign(cacheMagic, sizeof(cacheMagic));
+    w.u8(cacheFormatVersion);
+
+    w.u16(ensemble.ensembleId);
+    w.u8(ensemble.ensembleEcc);
+    writeLabel(w, ensemble.ensembleLabel);
+
+    w.u32(ensemble.services.size());
+    for (const auto& s : ensemble.services) {
+        w.u32(s.serviceId);
+        writeLabel(w, s.serviceLabel);
+        w.i16(s.language);
+        w.i16(s.programType);
+    }
+
+    w.u32(ensemble.components.size());
+    for (const auto& sc : ensemble.components) {
+        w.u8(sc.TMid);
+        w.u32(sc.SId);
+        w.i16(sc.componentNr);
+        writeLabel(w, sc.componentLabel);
+        w.i16(sc.ASCTy);
+        w.i16(sc.PS_flag);
+        w.i16(sc.subchannelId);
+        w.u16(sc.SCId);
+        w.u8(sc.CAflag);
+        w.i16(sc.DSCTy);
+        w.u8(sc.DGflag);
+        w.i16(sc.packetAddress);
+    }
+
+    w.u32(ensemble.subChannels.size());
+    for (const auto& sub : ensemble.subChannels) {
+        w.i32(sub.subChId);
+        w.i32(sub.startAddr);
+        w.i32(sub.length);
+        w.u8(sub.programmeNotData);
+        const auto& ps = sub.protectionSettings;
+        w.u8(ps.shortForm);
+        w.i16(ps.uepTableIndex);
+        w.i16(ps.uepLevel);
+        w.u8((uint8_t)ps.eepProfile);
+        w.u8((uint8_t)ps.eepLevel);
+        w.i16(sub.language);
+        w.i16(sub.fecScheme);
+    }
+
+    w.u32(ensemble.announcementSupport.size());
+    for (const auto& a : ensemble.announcementSupport) {
+        w.u32(a.service_id);
+        w.u16(a.support_flags.flags);
+        w.bytes(a.cluster_ids);
+    }
+
+    return w.data;
+}
+
+bool EnsembleCache::deserialise(const std::string& data, CachedEnsemble& ensemble)
+{
+    if (data.compare(0, sizeof(cacheMagic), cacheMagic, sizeof(cacheMagic)) != 0 or
+            data.size() <= sizeof(cacheMagic) or
+            (uint8_t)data[sizeof(cacheMagic)] != cacheFormatVersion) {
+        return false;
+    }
+
+    Reader r(data);
+    r.skip(sizeof(cacheMagic) + 1);
+
+    CachedEnsemble e;
+    e.ensembleId = r.u16();
+    e.ensembleEcc = r.u8();
+    e.ensembleLabel = readLabel(r);
+
+    const size_t numServices = r.count(4);
+    for (size_t i = 0; i < numServices and not r.failed; i++) {
+        Service s(r.u32());
+        s.serviceLabel = readLabel(r);
+        s.language = r.i16();
+        s.programType = r.i16();
+        e.services.push_back(s);
+    }
+
+    const size_t numComponents = r.count(5);
+    for (size_t i = 0; i < numComponents and not r.failed; i++) {
+        ServiceComponent sc;
+        sc.TMid = r.u8();
+        sc.SId = r.u32();
+        sc.componentNr = r.i16();
+        sc.componentLabel = readLabel(r);
+        sc.ASCTy = r.i16();
+        sc.PS_flag = r.i16();
+        sc.subchannelId = r.i16();
+        sc.SCId = r.u16();
+        sc.CAflag = r.u8();
+        sc.DSCTy = r.i16();
+        sc.DGflag = r.u8();
+        sc.packetAddress = r.i16();
+        e.components.push_back(sc);
+    }
+
+    const size_t numSubChannels = r.count(22);
+    for (size_t i = 0; i < numSubChannels and not r.failed; i++) {
+        Subchannel sub;
+        sub.subChId = r.i32();
+        sub.startAddr = r.i32();
+        sub.length = r.i32();
+        sub.programmeNotData = r.u8();
+        auto& ps = sub.protectionSettings;
+        ps.shortForm = r.u8();
+        ps.uepTableIndex = r.i16();
+        ps.uepLevel = r.i16();
+        ps.eepProfile = (EEPProtectionProfile)r.u8();
+        ps.eepLevel = (EEPProtectionLevel)r.u8();
+        sub.language = r.i16();
+        sub.fecScheme = r.i16();
+        if (sub.subChId < 0 or sub.subChId >= 64 or
+                ps.uepTableIndex < 0 or ps.uepTableIndex >= 64) {
+            return false;
+        }
+        e.subChannels.push_back(sub);
+    }
+
+    const size_t numAnnouncementSupport = r.count(10);
+    for (size_t i = 0; i < numAnnouncementSupport and not r.failed; i++) {
+        ServiceAnnouncementSupport a;
+        a.service_id = r.u32();
+        a.support_flags.flags = r.u16();
+        a.cluster_ids = r.vec();
+        e.announcementSupport.push_back(a);
+    }
+
+    if (r.failed or not r.atEnd()) {
+        return false;
+    }
+
+    ensemble = std::move(e);
+    return true;
+}
+
+EnsembleCache::EnsembleCache(const std::string& directory) :
+    directory(directory)
+{ }
+
+std::string EnsembleCache::pathFor(const std::string& channel) const
+{
+    // Channel names are short and alphanumeric, keep the file name so
+    std::string name;
+    for (const char c : channel) {
+        name += std::isalnum((unsigned char)c) ? c : '_';
+    }
+    return directory + "/" + name + ".ensemble";
+}
+
+bool EnsembleCache::load(const std::string& channel, CachedEnsemble& ensemble) const
+{
+    std::ifstream in(pathFor(channel), std::ios::binary);
+    if (not in) {
+        return false;
+    }
+
+    const std::string data((std::istreambuf_iterator<char>(in)),
+            std::istreambuf_iterator<char>());
+    return deserialise(data, ensemble);
+}
+
+bool EnsembleCache::save(const std::string& channel, const CachedEnsemble& ensemble) const
+{
+    // Readers must never see half a file
+    const std::string path = pathFor(channel);
+    const std::string tmpPath = path + ".tmp";
+    {
+        std::ofstream out(tmpPath, std::ios::binary | std::ios::trunc);
+        const std::string data = serialise(ensemble);
+        out.write(data.data(), data.size());
+        if (not out) {
+            return false;
+        }
+    }
+
+    if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+        // Windows does not replace an existing file
+        std::remove(path.c_str());
+        if (std::rename(tmpPath.c_str(), path.c_str()) != 0) {
+            std::remove(tmpPath.c_str());
+            return false;
+        }
+    }
+    return true;
+}
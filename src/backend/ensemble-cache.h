@@ -0,0 +1,79 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef ENSEMBLE_CACHE_H
+#define ENSEMBLE_CACHE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "dab-constants.h"
+#include "announcement-types.h"
+
+/* The part of the ensemble database that a receiver needs to play a
+ * service, and that rarely changes from one tune to the next. */
+struct CachedEnsemble {
+    uint16_t ensembleId = 0;
+    uint8_t ensembleEcc = 0;
+    DabLabel ensembleLabel;
+    std::vector<Service> services;
+    std::vector<ServiceComponent> components;
+    // Only the valid subchannels
+    std::vector<Subchannel> subChannels;
+    // From FIG 0/18
+    std::vector<ServiceAnnouncementSupport> announcementSupport;
+};
+
+struct EnsembleCacheStats {
+    // The ensemble of the current channel was loaded from the cache
+    bool preloaded = false;
+    // Cached entries that the FIC described differently, or not at all
+    uint64_t contradictions = 0;
+    // Milliseconds from the restart of the receiver to the moment the
+    // first audio service was handed to the MSC decoder, -1 until then
+    int64_t timeToPlay = -1;
+};
+
+/* Keeps one file per channel in a directory, holding the ensemble that
+ * was last received on that channel in a compact binary form. The
+ * directory is not created. A file that cannot be read, or that was
+ * written by another version of the format, is a cache miss. */
+class EnsembleCache {
+    public:
+        EnsembleCache(const std::string& directory);
+
+        bool load(const std::string& channel, CachedEnsemble& ensemble) const;
+        bool save(const std::string& channel, const CachedEnsemble& ensemble) const;
+
+        static std::string serialise(const CachedEnsemble& ensemble);
+        static bool deserialise(const std::string& data, CachedEnsemble& ensemble);
+
+    private:
+        std::string pathFor(const std::string& channel) const;
+
+        std::string directory;
+};
+
+#endif
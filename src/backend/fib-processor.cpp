@@ -32,8 +32,24 @@
 #include "charsets.h"
 #include "MathHelper.h"
 
+constexpr std::chrono::seconds FIBProcessor::figCacheWindow;
+constexpr size_t FIBProcessor::cacheConfirmFIBs;
+
+// Assigns a field of the database, returns true if its value changed
+template<typename T, typename U>
+static bool update(T& field, U value)
+{
+    const T v = static_cast<T>(value);
+    if (field == v) {
+        return false;
+    }
+    field = v;
+    return true;
+}
+
 FIBProcessor::FIBProcessor(RadioControllerInterface& mr) :
-    myRadioInterface(mr)
+    myRadioInterface(mr),
+    snapshot(std::make_shared<EnsembleSnapshot>())
 {
     clearEnsemble();
 }
@@ -48,9 +64,19 @@ void FIBProcessor::processFIB(uint8_t *p, uint16_t fib)
 
     std::lock_guard<std::recursive_mutex> lock(mutex);
 
+    if (preloadPending and ++fibsSincePreload >= cacheConfirmFIBs) {
+        confirmCachedEnsemble();
+    }
+
     (void)fib;
     while (processedBytes  < 30) {
         const uint8_t FIGtype = getBits_3 (d, 0);
+        if (FIGtype != 7 and isRepeatedFIG(d)) {
+            processedBytes += getBits_5 (d, 3) + 1;
+            d = p + processedBytes * 8;
+            continue;
+        }
+
         switch (FIGtype) {
             case 0:
                 process_FIG0(d);
@@ -65,6 +91,7 @@ void FIBProcessor::processFIB(uint8_t *p, uint16_t fib)
                 break;
 
             case 7:
+                finishFIB();
                 return;
 
             default:
@@ -76,6 +103,8 @@ void FIBProcessor::processFIB(uint8_t *p, uint16_t fib)
         processedBytes += getBits_5 (d, 3) + 1;
         d = p + processedBytes * 8;
     }
+
+    finishFIB();
 }
 //
 //  Handle ensemble is all through FIG0
@@ -122,7 +151,12 @@ void FIBProcessor::FIG0Extension0 (uint8_t *d)
     uint16_t eId  = getBits(d, 16, 16);
 
     if (ensembleId != eId) {
+        if (preloadPending) {
+            discardCachedEnsemble();
+        }
         ensembleId = eId;
+        ensembleDirty = true;
+        publishEnsemble();
         myRadioInterface.onNewEnsemble(ensembleId);
     }
 
@@ -202,6 +236,7 @@ int16_t FIBProcessor::HandleFIG0Extension1(
     int16_t bitOffset = offset * 8;
     const int16_t subChId   = getBits_6 (d, bitOffset);
     const int16_t startAdr  = getBits(d, bitOffset + 6, 10);
+    const Subchannel previous = subChannels[subChId];
     subChannels[subChId].programmeNotData = pd;
     subChannels[subChId].subChId = subChId;
     subChannels[subChId].startAddr = startAdr;
@@ -260,6 +295,16 @@ int16_t FIBProcessor::HandleFIG0Extension1(
         bitOffset += 32;
     }
 
+    const bool changed = not (subChannels[subChId] == previous);
+    ensembleDirty |= changed;
+
+    if (unconfirmedSubchannels[subChId]) {
+        unconfirmedSubchannels.reset(subChId);
+        if (changed) {
+            cacheContradiction("subchannel " + std::to_string(subChId));
+        }
+    }
+
     return bitOffset / 8;   // we return bytes
 }
 
@@ -304,11 +349,58 @@ int16_t FIBProcessor::HandleFIG0Extension2(
         lOffset += 16;
     }
 
-    // Keep track how often we see a service using a saturating counter.
-    // Every time a service is signalled, we increment the counter.
-    // If the counter is >= 2, we consider the service. Every second, we
-    // decrement all counters by one.
-    // This avoids that misdecoded services appear and stay in the list.
+    countService(SId);
+
+    if (findServiceId(SId) == nullptr and serviceRepeatCount[SId] >= 2) {
+        services.emplace_back(SId);
+        index.addService(services.back(), services.size() - 1);
+        ensembleDirty = true;
+        publishEnsemble();
+        myRadioInterface.onServiceDetected(SId);
+    }
+
+    numberofComponents = getBits_4(d, lOffset + 4);
+    lOffset += 8;
+
+    for (i = 0; i < numberofComponents; i ++) {
+        uint8_t TMid    = getBits_2 (d, lOffset);
+        if (TMid == 00)  {  // Audio
+            uint8_t ASCTy   = getBits_6 (d, lOffset + 2);
+            uint8_t SubChId = getBits_6 (d, lOffset + 8);
+            uint8_t PS_flag = getBits_1 (d, lOffset + 14);
+            bindAudioService(TMid, SId, i, SubChId, PS_flag, ASCTy);
+        }
+        else if (TMid == 1) { // MSC stream data
+            uint8_t DSCTy   = getBits_6 (d, lOffset + 2);
+            uint8_t SubChId = getBits_6 (d, lOffset + 8);
+            uint8_t PS_flag = getBits_1 (d, lOffset + 14);
+            bindDataStreamService(TMid, SId, i, SubChId, PS_flag, DSCTy);
+        }
+        else if (TMid == 3) { // MSC packet data
+            int16_t SCId    = getBits (d, lOffset + 2, 12);
+            uint8_t PS_flag = getBits_1 (d, lOffset + 14);
+            uint8_t CA_flag = getBits_1 (d, lOffset + 15);
+            bindPacketService(TMid, SId, i, SCId, PS_flag, CA_flag);
+        }
+        else {
+            // reserved
+        }
+        lOffset += 16;
+    }
+
+    // Its components were compared with the cached ones
+    unconfirmedServices.erase(SId);
+
+    return lOffset / 8;     // in Bytes
+}
+
+// Keep track how often we see a service using a saturating counter.
+// Every time a service is signalled, we increment the counter.
+// If the counter is >= 2, we consider the service. Every second, we
+// decrement all counters by one.
+// This avoids that misdecoded services appear and stay in the list.
+void FIBProcessor::countService(uint32_t SId)
+{
     using namespace std::chrono;
     const auto now = steady_clock::now();
     if (timeLastServiceDecrement + seconds(1) < now) {
@@ -343,41 +435,104 @@ int16_t FIBProcessor::HandleFIG0Extension2(
     if (serviceRepeatCount[SId] < 4) {
         serviceRepeatCount[SId]++;
     }
+}
 
-    if (findServiceId(SId) == nullptr and serviceRepeatCount[SId] >= 2) {
-        services.emplace_back(SId);
-        myRadioInterface.onServiceDetected(SId);
-    }
-
-    numberofComponents = getBits_4(d, lOffset + 4);
-    lOffset += 8;
-
-    for (i = 0; i < numberofComponents; i ++) {
-        uint8_t TMid    = getBits_2 (d, lOffset);
-        if (TMid == 00)  {  // Audio
-            uint8_t ASCTy   = getBits_6 (d, lOffset + 2);
-            uint8_t SubChId = getBits_6 (d, lOffset + 8);
-            uint8_t PS_flag = getBits_1 (d, lOffset + 14);
-            bindAudioService(TMid, SId, i, SubChId, PS_flag, ASCTy);
+//  A repeated FIG 0/2 only counts its services, as long as they are all
+//  in the list already. Returns false if the FIG must be decoded.
+bool FIBProcessor::refreshFIG0Extension2(const uint8_t *d)
+{
+    const int16_t Length = getBits_5 (d, 3);
+    const uint8_t PD_bit = getBits_1 (d, 8 + 2);
+
+    std::array<uint32_t, 16> SIds;
+    size_t numSIds = 0;
+    for (int16_t used = 2; used < Length and numSIds < SIds.size();) {
+        int16_t lOffset = 8 * used;
+        uint32_t SId;
+        if (PD_bit == 1) {
+            SId = getBits(d, lOffset, 32);
+            lOffset += 32;
         }
-        else if (TMid == 1) { // MSC stream data
-            uint8_t DSCTy   = getBits_6 (d, lOffset + 2);
-            uint8_t SubChId = getBits_6 (d, lOffset + 8);
-            uint8_t PS_flag = getBits_1 (d, lOffset + 14);
-            bindDataStreamService(TMid, SId, i, SubChId, PS_flag, DSCTy);
+        else {
+            SId = getBits(d, lOffset, 16);
+            lOffset += 16;
         }
-        else if (TMid == 3) { // MSC packet data
-            int16_t SCId    = getBits (d, lOffset + 2, 12);
-            uint8_t PS_flag = getBits_1 (d, lOffset + 14);
-            uint8_t CA_flag = getBits_1 (d, lOffset + 15);
-            bindPacketService(TMid, SId, i, SCId, PS_flag, CA_flag);
+
+        if (findServiceId(SId) == nullptr) {
+            return false;
         }
-        else {
-            // reserved
+        SIds[numSIds++] = SId;
+
+        const int16_t numberofComponents = getBits_4(d, lOffset + 4);
+        used = lOffset / 8 + 1 + 2 * numberofComponents;
+    }
+
+    for (size_t i = 0; i < numSIds; i++) {
+        countService(SIds[i]);
+    }
+    return true;
+}
+
+bool FIBProcessor::isRepeatedFIG(const uint8_t *d)
+{
+    const uint8_t FIGtype = getBits_3 (d, 0);
+    const bool isFIG0 = FIGtype == 0;
+    const uint8_t extension = getBits_5 (d, 8 + 3);
+    if (FIGtype > 2 or (isFIG0 and
+                (extension == 0 or extension == 10 or extension == 19))) {
+        return false;
+    }
+
+    FigCacheEntry fig;
+    fig.length = getBits_5 (d, 3) + 1;
+    if (fig.length > 30) {
+        return false;
+    }
+    fig.bytes.fill(0);
+    for (size_t i = 0; i < fig.length; i++) {
+        fig.bytes[i] = getBits_8 (d, 8 * i);
+    }
+
+    // FNV-1a
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < fig.length; i++) {
+        hash = (hash ^ fig.bytes[i]) * 0x100000001b3;
+    }
+
+    using namespace std::chrono;
+    const auto now = steady_clock::now();
+    const uint64_t version = std::atomic_load(&snapshot)->version;
+
+    if (timeLastFigCacheCleanup + figCacheWindow < now) {
+        for (auto it = figCache.begin(); it != figCache.end();) {
+            if (it->second.timeLastSeen + figCacheWindow < now) {
+                it = figCache.erase(it);
+            }
+            else {
+                ++it;
+            }
         }
-        lOffset += 16;
+        timeLastFigCacheCleanup = now;
     }
-    return lOffset / 8;     // in Bytes
+
+    auto it = figCache.find(hash);
+    if (it != figCache.end() and
+            it->second.length == fig.length and
+            it->second.bytes == fig.bytes and
+            it->second.version == version and
+            it->second.timeDecoded + figCacheWindow > now and
+            (not isFIG0 or extension != 2 or refreshFIG0Extension2(d))) {
+        it->second.timeLastSeen = now;
+        figCacheHits++;
+        return true;
+    }
+
+    fig.version = version;
+    fig.timeDecoded = now;
+    fig.timeLastSeen = now;
+    figCache[hash] = fig;
+    figCacheMisses++;
+    return false;
 }
 
 //      The Extension 3 of FIG type 0 (FIG 0/3) gives
@@ -409,10 +564,10 @@ int16_t FIBProcessor::HandleFIG0Extension3(uint8_t *d, int16_t used)
 
     used += 56 / 8;
     if (packetComp) {
-        packetComp->subchannelId = SubChId;
-        packetComp->DSCTy = DSCTy;
-        packetComp->DGflag = DGflag;
-        packetComp->packetAddress = packetAddress;
+        ensembleDirty |= update(packetComp->subchannelId, SubChId);
+        ensembleDirty |= update(packetComp->DSCTy, DSCTy);
+        ensembleDirty |= update(packetComp->DGflag, DGflag);
+        ensembleDirty |= update(packetComp->packetAddress, packetAddress);
     }
     return used;
 }
@@ -437,7 +592,7 @@ int16_t FIBProcessor::HandleFIG0Extension5(uint8_t* d, int16_t offset)
         if (getBits_1 (d, loffset + 1) == 0) {
             subChId = getBits_6 (d, loffset + 2);
             language = getBits_8 (d, loffset + 8);
-            subChannels[subChId].language = language;
+            ensembleDirty |= update(subChannels[subChId].language, language);
         }
         loffset += 16;
     }
@@ -510,7 +665,7 @@ void FIBProcessor::FIG0Extension9(uint8_t *d)
     dateTime.minuteOffset = (getBits_1 (d, offset + 7) == 1) ? 30 : 0;
     timeOffsetReceived = true;
 
-    ensembleEcc = getBits(d, offset + 8, 8);
+    ensembleDirty |= update(ensembleEcc, getBits(d, offset + 8, 8));
 }
 
 void FIBProcessor::FIG0Extension10(uint8_t *fig)
@@ -642,7 +797,7 @@ void FIBProcessor::FIG0Extension14 (uint8_t *d)
 
         for (int i = 0; i < 64; i++) {
             if (subChannels[i].subChId == subChId) {
-                subChannels[i].fecScheme = fecScheme;
+                ensembleDirty |= update(subChannels[i].fecScheme, fecScheme);
             }
         }
 
@@ -665,14 +820,14 @@ void FIBProcessor::FIG0Extension17(uint8_t *d)
         if (L_flag) {       // language field present
             Language = getBits_8 (d, offset + 24);
             if (s) {
-                s->language = Language;
+                ensembleDirty |= update(s->language, Language);
             }
             offset += 8;
         }
 
         type = getBits_5 (d, offset + 27);
         if (s) {
-            s->programType = type;
+            ensembleDirty |= update(s->programType, type);
         }
         if (CC_flag) {          // cc flag
             offset += 40;
@@ -958,9 +1113,12 @@ void FIBProcessor::process_FIG1(uint8_t *d)
                 }
                 // std::clog << "fib-processor:" << "Ensemblename: " << label << std::endl;
                 if (!oe and EId == ensembleId) {
+                    const DabLabel previous = ensembleLabel;
                     ensembleLabel.fig1_flag = getBits(d, offset, 16);
                     ensembleLabel.fig1_label = label;
                     ensembleLabel.setCharset(charSet);
+                    ensembleDirty |= not (ensembleLabel == previous);
+                    publishEnsemble();
                     myRadioInterface.onSetEnsembleLabel(ensembleLabel);
                 }
                 break;
@@ -975,9 +1133,11 @@ void FIBProcessor::process_FIG1(uint8_t *d)
                     label[i] = getBits_8(d, offset);
                     offset += 8;
                 }
+                const DabLabel previous = service->serviceLabel;
                 service->serviceLabel.fig1_flag = getBits(d, offset, 16);
                 service->serviceLabel.fig1_label = label;
                 service->serviceLabel.setCharset(charSet);
+                ensembleDirty |= not (service->serviceLabel == previous);
                 // std::clog << "fib-processor:" << "FIG1/1: SId = %4x\t%s\n", SId, label) << std::endl;
             }
             break;
@@ -1013,9 +1173,11 @@ void FIBProcessor::process_FIG1(uint8_t *d)
 
             component = findComponent(SId, SCidS);
             if (component) {
+                const DabLabel previous = component->componentLabel;
                 component->componentLabel.fig1_flag = getBits(d, offset, 16);
                 component->componentLabel.setCharset(charSet);
                 component->componentLabel.fig1_label = label;
+                ensembleDirty |= not (component->componentLabel == previous);
             }
             //        std::clog << "fib-processor:" << "FIG1/4: Sid = %8x\tp/d=%d\tSCidS=%1X\tflag=%8X\t%s\n",
             //                          SId, pd_flag, SCidS, flagfield, label) << std::endl;
@@ -1031,9 +1193,11 @@ void FIBProcessor::process_FIG1(uint8_t *d)
                     label[i] = getBits_8(d, offset);
                     offset += 8;
                 }
+                const DabLabel previous = service->serviceLabel;
                 service->serviceLabel.fig1_flag = getBits(d, offset, 16);
                 service->serviceLabel.fig1_label = label;
                 service->serviceLabel.setCharset(charSet);
+                ensembleDirty |= not (service->serviceLabel == previous);
 
 #ifdef  MSC_DATA__
                 myRadioInterface.onServiceDetected(SId);
@@ -1073,10 +1237,13 @@ void FIBProcessor::process_FIG1(uint8_t *d)
     }
 }
 
-static void handle_ext_label_data_field(const uint8_t *f, uint8_t len_bytes,
+// Returns true if the label changed
+static bool handle_ext_label_data_field(const uint8_t *f, uint8_t len_bytes,
         bool toggle_flag, uint8_t segment_index, uint8_t rfu,
         DabLabel& label)
 {
+    const DabLabel previous = label;
+
     if (label.toggle_flag != toggle_flag) {
         label.segments.clear();
         label.extended_label_charset = CharacterSet::Undefined;
@@ -1126,6 +1293,7 @@ static void handle_ext_label_data_field(const uint8_t *f, uint8_t len_bytes,
 
     std::vector<uint8_t> labelbytes(f, f + len_character_field);
     label.segments[segment_index] = labelbytes;
+    return not (label == previous);
 }
 
 // UTF-8 or UCS2 Labels
@@ -1184,7 +1352,7 @@ void FIBProcessor::process_FIG2(uint8_t *d)
                     std::clog << "FIG2/0 length error " << (int)figlen << std::endl;
                 }
                 else if (eid == ensembleId) {
-                    handle_ext_label_data_field(figdata, data_len_bytes,
+                    ensembleDirty |= handle_ext_label_data_field(figdata, data_len_bytes,
                             toggle_flag, segment_index, rfu, ensembleLabel);
                 }
             }
@@ -1199,7 +1367,7 @@ void FIBProcessor::process_FIG2(uint8_t *d)
                 else {
                     auto *service = findServiceId(sid);
                     if (service) {
-                        handle_ext_label_data_field(figdata, data_len_bytes,
+                        ensembleDirty |= handle_ext_label_data_field(figdata, data_len_bytes,
                                 toggle_flag, segment_index, rfu, service->serviceLabel);
                     }
                 }
@@ -1227,7 +1395,7 @@ void FIBProcessor::process_FIG2(uint8_t *d)
                 else {
                     auto *component = findComponent(sid, SCIdS);
                     if (component) {
-                        handle_ext_label_data_field(figdata, data_len_bytes,
+                        ensembleDirty |= handle_ext_label_data_field(figdata, data_len_bytes,
                                 toggle_flag, segment_index, rfu, component->componentLabel);
                     }
                 }
@@ -1248,7 +1416,7 @@ void FIBProcessor::process_FIG2(uint8_t *d)
                 else {
                     auto *service = findServiceId(sid);
                     if (service) {
-                        handle_ext_label_data_field(figdata, data_len_bytes,
+                        ensembleDirty |= handle_ext_label_data_field(figdata, data_len_bytes,
                                 toggle_flag, segment_index, rfu, service->serviceLabel);
                     }
                 }
@@ -1257,44 +1425,97 @@ void FIBProcessor::process_FIG2(uint8_t *d)
     }
 }
 
-// locate a reference to the entry for the Service serviceId
-Service *FIBProcessor::findServiceId(uint32_t serviceId)
+void EnsembleIndex::clear()
+{
+    services.clear();
+    components.clear();
+    packetComponents.clear();
+    serviceComponents.clear();
+}
+
+void EnsembleIndex::addService(const Service& s, size_t position)
 {
+    services.emplace(s.serviceId, position);
+}
+
+void EnsembleIndex::addComponent(const ServiceComponent& sc, size_t position)
+{
+    components.emplace(componentKey(sc.SId, sc.componentNr), position);
+    if (sc.TMid == 03) {
+        // The first one wins, as with a search from the start
+        packetComponents.emplace(sc.SCId, position);
+    }
+    serviceComponents[sc.SId].push_back(position);
+}
+
+void EnsembleIndex::rebuild(const std::vector<Service>& services,
+        const std::vector<ServiceComponent>& components)
+{
+    clear();
     for (size_t i = 0; i < services.size(); i++) {
-        if (services[i].serviceId == serviceId) {
-            return &services[i];
-        }
+        addService(services[i], i);
     }
+    for (size_t i = 0; i < components.size(); i++) {
+        addComponent(components[i], i);
+    }
+}
 
-    return nullptr;
+const Service *EnsembleSnapshot::findService(uint32_t SId) const
+{
+    const auto it = index.services.find(SId);
+    return it == index.services.end() ? nullptr : &services[it->second];
 }
 
-ServiceComponent *FIBProcessor::findComponent(uint32_t serviceId, int16_t SCIdS)
+const ServiceComponent *EnsembleSnapshot::findComponent(uint32_t SId, int16_t SCIdS) const
 {
-    auto comp = std::find_if(components.begin(), components.end(),
-                [&](const ServiceComponent& sc) {
-                    return sc.SId == serviceId && sc.componentNr == SCIdS;
-                });
+    const auto it = index.components.find(EnsembleIndex::componentKey(SId, SCIdS));
+    return it == index.components.end() ? nullptr : &components[it->second];
+}
 
-    if (comp == components.end()) {
+const ServiceComponent *EnsembleSnapshot::findPacketComponent(uint16_t SCId) const
+{
+    const auto it = index.packetComponents.find(SCId);
+    return it == index.packetComponents.end() ? nullptr : &components[it->second];
+}
+
+const Subchannel *EnsembleSnapshot::findSubchannel(int16_t subChId) const
+{
+    if (subChId < 0 or (size_t)subChId >= subChannels.size() or
+            not subChannels[subChId].valid()) {
         return nullptr;
     }
-    else {
-        return &(*comp);
-    }
+    return &subChannels[subChId];
 }
 
-ServiceComponent *FIBProcessor::findPacketComponent(int16_t SCId)
+std::vector<const ServiceComponent*> EnsembleSnapshot::findComponents(uint32_t SId) const
 {
-    for (auto& component : components) {
-        if (component.TMid != 03) {
-            continue;
-        }
-        if (component.SCId == SCId) {
-            return &component;
+    std::vector<const ServiceComponent*> c;
+    const auto it = index.serviceComponents.find(SId);
+    if (it != index.serviceComponents.end()) {
+        for (const size_t i : it->second) {
+            c.push_back(&components[i]);
         }
     }
-    return nullptr;
+    return c;
+}
+
+// locate a reference to the entry for the Service serviceId
+Service *FIBProcessor::findServiceId(uint32_t serviceId)
+{
+    const auto it = index.services.find(serviceId);
+    return it == index.services.end() ? nullptr : &services[it->second];
+}
+
+ServiceComponent *FIBProcessor::findComponent(uint32_t serviceId, int16_t SCIdS)
+{
+    const auto it = index.components.find(EnsembleIndex::componentKey(serviceId, SCIdS));
+    return it == index.components.end() ? nullptr : &components[it->second];
+}
+
+ServiceComponent *FIBProcessor::findPacketComponent(int16_t SCId)
+{
+    const auto it = index.packetComponents.find(SCId);
+    return it == index.packetComponents.end() ? nullptr : &components[it->second];
 }
 
 //  bindAudioService is the main processor for - what the name suggests -
@@ -1310,21 +1531,16 @@ void FIBProcessor::bindAudioService(
     Service *s = findServiceId(SId);
     if (!s) return;
 
-    if (std::find_if(components.begin(), components.end(),
-                [&](const ServiceComponent& sc) {
-                    return sc.SId == s->serviceId && sc.componentNr == compnr;
-                }) == components.end()) {
-        ServiceComponent newcomp;
-        newcomp.TMid         = TMid;
-        newcomp.componentNr  = compnr;
-        newcomp.SId          = SId;
-        newcomp.subchannelId = subChId;
-        newcomp.PS_flag      = ps_flag;
-        newcomp.ASCTy        = ASCTy;
-        components.push_back(newcomp);
+    ServiceComponent newcomp;
+    newcomp.TMid         = TMid;
+    newcomp.componentNr  = compnr;
+    newcomp.SId          = s->serviceId;
+    newcomp.subchannelId = subChId;
+    newcomp.PS_flag      = ps_flag;
+    newcomp.ASCTy        = ASCTy;
+    addComponent(newcomp);
 
-        //  std::clog << "fib-processor:" << "service %8x (comp %d) is audio\n", SId, compnr) << std::endl;
-    }
+    //  std::clog << "fib-processor:" << "service %8x (comp %d) is audio\n", SId, compnr) << std::endl;
 }
 
 void FIBProcessor::bindDataStreamService(
@@ -1338,21 +1554,16 @@ void FIBProcessor::bindDataStreamService(
     Service *s = findServiceId(SId);
     if (!s) return;
 
-    if (std::find_if(components.begin(), components.end(),
-                [&](const ServiceComponent& sc) {
-                    return sc.SId == s->serviceId && sc.componentNr == compnr;
-                }) == components.end()) {
-        ServiceComponent newcomp;
-        newcomp.TMid         = TMid;
-        newcomp.SId          = SId;
-        newcomp.subchannelId = subChId;
-        newcomp.componentNr  = compnr;
-        newcomp.PS_flag      = ps_flag;
-        newcomp.DSCTy        = DSCTy;
-        components.push_back(newcomp);
+    ServiceComponent newcomp;
+    newcomp.TMid         = TMid;
+    newcomp.SId          = s->serviceId;
+    newcomp.subchannelId = subChId;
+    newcomp.componentNr  = compnr;
+    newcomp.PS_flag      = ps_flag;
+    newcomp.DSCTy        = DSCTy;
+    addComponent(newcomp);
 
-        //  std::clog << "fib-processor:" << "service %8x (comp %d) is packet\n", SId, compnr) << std::endl;
-    }
+    //  std::clog << "fib-processor:" << "service %8x (comp %d) is packet\n", SId, compnr) << std::endl;
 }
 
 //      bindPacketService is the main processor for - what the name suggests -
@@ -1369,20 +1580,61 @@ void FIBProcessor::bindPacketService(
     Service *s = findServiceId(SId);
     if (!s) return;
 
-    if (std::find_if(components.begin(), components.end(),
-                [&](const ServiceComponent& sc) {
-                    return sc.SId == s->serviceId && sc.componentNr == compnr;
-                }) == components.end()) {
-        ServiceComponent newcomp;
-        newcomp.TMid        = TMid;
-        newcomp.SId         = SId;
-        newcomp.componentNr = compnr;
-        newcomp.SCId        = SCId;
-        newcomp.PS_flag     = ps_flag;
-        newcomp.CAflag      = CAflag;
+    ServiceComponent newcomp;
+    newcomp.TMid        = TMid;
+    newcomp.SId         = s->serviceId;
+    newcomp.componentNr = compnr;
+    newcomp.SCId        = SCId;
+    newcomp.PS_flag     = ps_flag;
+    newcomp.CAflag      = CAflag;
+    addComponent(newcomp);
+
+    //  std::clog << "fib-processor:" << "service %8x (comp %d) is packet\n", SId, compnr) << std::endl;
+}
+
+void FIBProcessor::addComponent(const ServiceComponent& newcomp)
+{
+    ServiceComponent *sc = findComponent(newcomp.SId, newcomp.componentNr);
+    if (sc == nullptr) {
         components.push_back(newcomp);
+        index.addComponent(components.back(), components.size() - 1);
+        ensembleDirty = true;
+        return;
+    }
+
+    if (unconfirmedServices.count(newcomp.SId) == 0) {
+        return;
+    }
 
-        //  std::clog << "fib-processor:" << "service %8x (comp %d) is packet\n", SId, compnr) << std::endl;
+    // Only compare what FIG 0/2 says about the component, the rest comes
+    // from other FIGs
+    bool same = sc->TMid == newcomp.TMid and sc->PS_flag == newcomp.PS_flag;
+    switch (newcomp.TMid) {
+        case 0:
+            same = same and sc->ASCTy == newcomp.ASCTy and
+                sc->subchannelId == newcomp.subchannelId;
+            break;
+        case 1:
+            same = same and sc->DSCTy == newcomp.DSCTy and
+                sc->subchannelId == newcomp.subchannelId;
+            break;
+        case 3:
+            same = same and sc->SCId == newcomp.SCId and
+                sc->CAflag == newcomp.CAflag;
+            break;
+    }
+
+    if (not same) {
+        const DabLabel label = sc->componentLabel;
+        *sc = newcomp;
+        sc->componentLabel = label;
+        index.rebuild(services, components);
+        ensembleDirty = true;
+
+        std::stringstream ss;
+        ss << "service " << std::hex << newcomp.SId << std::dec <<
+            " component " << newcomp.componentNr;
+        cacheContradiction(ss.str());
     }
 }
 
@@ -1407,18 +1659,23 @@ void FIBProcessor::dropService(uint32_t SId)
                 }
                 ), components.end());
 
+    index.rebuild(services, components);
+    ensembleDirty = true;
+
     // Check for orphaned subchannels
+    std::vector<bool> subChannelUsed(subChannels.size(), false);
+    for (const auto& c : components) {
+        if (c.subchannelId >= 0 and (size_t)c.subchannelId < subChannels.size()) {
+            subChannelUsed[c.subchannelId] = true;
+        }
+    }
+
     for (auto& sub : subChannels) {
         if (sub.subChId == -1) {
             continue;
         }
 
-        auto c_it = std::find_if(components.begin(), components.end(),
-                [&](const ServiceComponent& c) {
-                    return c.subchannelId == sub.subChId;
-                });
-
-        const bool drop = c_it == components.end();
+        const bool drop = not subChannelUsed[sub.subChId];
         if (drop) {
             ss << ", subch " << sub.subChId;
             sub.subChId = -1;
@@ -1434,9 +1691,17 @@ void FIBProcessor::clearEnsemble()
     components.clear();
     subChannels.resize(64);
     services.clear();
+    index.clear();
     serviceRepeatCount.clear();
     timeLastServiceDecrement = std::chrono::steady_clock::now();
     timeLastFCT0Frame = std::chrono::system_clock::now();
+    figCache.clear();
+    preloadPending = false;
+    unconfirmedServices.clear();
+    unconfirmedSubchannels.reset();
+    cacheContradicted = false;
+    ensembleDirty = true;
+    publishEnsemble();
 
     // Clear active announcements
     std::lock_guard<std::recursive_mutex> ann_lock(activeAnnouncementsMutex_);
@@ -1447,22 +1712,175 @@ void FIBProcessor::clearEnsemble()
     announcementSupportMap_.clear();
 }
 
-std::vector<Service> FIBProcessor::getServiceList() const
+void FIBProcessor::publishEnsemble()
+{
+    if (not ensembleDirty) {
+        return;
+    }
+    ensembleDirty = false;
+
+    const auto current = std::atomic_load(&snapshot);
+
+    auto next = std::make_shared<EnsembleSnapshot>();
+    next->version = current->version + 1;
+    next->ensembleId = ensembleId;
+    next->ensembleEcc = ensembleEcc;
+    next->ensembleLabel = ensembleLabel;
+    next->services = services;
+    next->components = components;
+    next->index = index;
+    next->subChannels = subChannels;
+    std::atomic_store(&snapshot, std::shared_ptr<const EnsembleSnapshot>(std::move(next)));
+}
+
+void FIBProcessor::finishFIB()
+{
+    publishEnsemble();
+
+    // Whatever plays from the corrected database must tune again
+    if (cacheContradicted) {
+        cacheContradicted = false;
+        myRadioInterface.onRestartService();
+    }
+}
+
+void FIBProcessor::preloadEnsemble(const CachedEnsemble& ensemble)
 {
     std::lock_guard<std::recursive_mutex> lock(mutex);
-    return services;
+    clearEnsemble();
+
+    ensembleId = ensemble.ensembleId;
+    ensembleEcc = ensemble.ensembleEcc;
+    ensembleLabel = ensemble.ensembleLabel;
+
+    subChannels.assign(64, Subchannel());
+    for (const auto& sub : ensemble.subChannels) {
+        if (sub.subChId >= 0 and sub.subChId < 64) {
+            subChannels[sub.subChId] = sub;
+            unconfirmedSubchannels.set(sub.subChId);
+        }
+    }
+
+    services = ensemble.services;
+    for (const auto& s : services) {
+        unconfirmedServices.insert(s.serviceId);
+    }
+
+    for (const auto& sc : ensemble.components) {
+        if (sc.subchannelId >= 0 and sc.subchannelId < 64) {
+            components.push_back(sc);
+        }
+    }
+    index.rebuild(services, components);
+
+    for (const auto& support : ensemble.announcementSupport) {
+        storeAnnouncementSupport(support);
+    }
+
+    preloadPending = true;
+    fibsSincePreload = 0;
+    ensembleDirty = true;
+    publishEnsemble();
+
+    std::clog << "fib-processor: preloaded ensemble " << std::hex <<
+        ensembleId << std::dec << " with " << services.size() <<
+        " services from the cache" << std::endl;
+
+    myRadioInterface.onNewEnsemble(ensembleId);
+    myRadioInterface.onSetEnsembleLabel(ensembleLabel);
+    for (const auto& s : ensemble.services) {
+        myRadioInterface.onServiceDetected(s.serviceId);
+    }
+    for (const auto& support : ensemble.announcementSupport) {
+        myRadioInterface.onAnnouncementSupportUpdate(support);
+    }
 }
 
-Service FIBProcessor::getService(uint32_t sId) const
+CachedEnsemble FIBProcessor::getCachedEnsemble() const
+{
+    CachedEnsemble e;
+    const auto ensemble = getEnsembleSnapshot();
+    e.ensembleId = ensemble->ensembleId;
+    e.ensembleEcc = ensemble->ensembleEcc;
+    e.ensembleLabel = ensemble->ensembleLabel;
+    e.services = ensemble->services;
+    e.components = ensemble->components;
+    for (const auto& sub : ensemble->subChannels) {
+        if (sub.valid()) {
+            e.subChannels.push_back(sub);
+        }
+    }
+
+    std::lock_guard<std::recursive_mutex> lock(announcementSupportMutex_);
+    for (const auto& support : announcementSupportMap_) {
+        e.announcementSupport.push_back(support.second);
+    }
+    return e;
+}
+
+bool FIBProcessor::isPreloadPending() const
 {
     std::lock_guard<std::recursive_mutex> lock(mutex);
+    return preloadPending;
+}
 
-    auto srv = std::find_if(services.begin(), services.end(),
-                [&](const Service& s) {
-                    return s.serviceId == sId;
-                });
+uint64_t FIBProcessor::getCacheContradictions() const
+{
+    return cacheContradictions;
+}
 
-    if (srv != services.end()) {
+void FIBProcessor::cacheContradiction(const std::string& what)
+{
+    std::clog << "fib-processor: the FIC contradicts the cached " <<
+        what << std::endl;
+    cacheContradictions++;
+    cacheContradicted = true;
+}
+
+//  Another ensemble than the cached one is on the channel
+void FIBProcessor::discardCachedEnsemble()
+{
+    cacheContradiction("ensemble");
+    clearEnsemble();
+    subChannels.assign(64, Subchannel());
+    ensembleEcc = 0;
+    ensembleLabel = DabLabel();
+    ensembleDirty = true;
+    cacheContradicted = true;
+}
+
+//  The FIGs had the time to describe the whole ensemble, what they did
+//  not describe is gone
+void FIBProcessor::confirmCachedEnsemble()
+{
+    preloadPending = false;
+
+    for (const auto SId : unconfirmedServices) {
+        std::stringstream ss;
+        ss << "service " << std::hex << SId;
+        cacheContradiction(ss.str());
+        dropService(SId);
+    }
+    unconfirmedServices.clear();
+    unconfirmedSubchannels.reset();
+}
+
+std::shared_ptr<const EnsembleSnapshot> FIBProcessor::getEnsembleSnapshot() const
+{
+    return std::atomic_load(&snapshot);
+}
+
+std::vector<Service> FIBProcessor::getServiceList() const
+{
+    return getEnsembleSnapshot()->services;
+}
+
+Service FIBProcessor::getService(uint32_t sId) const
+{
+    const auto ensemble = getEnsembleSnapshot();
+    const Service *srv = ensemble->findService(sId);
+
+    if (srv) {
         return *srv;
     }
     else {
@@ -1473,11 +1891,9 @@ Service FIBProcessor::getService(uint32_t sId) const
 std::list<ServiceComponent> FIBProcessor::getComponents(const Service& s) const
 {
     std::list<ServiceComponent> c;
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    for (const auto& component : components) {
-        if (component.SId == s.serviceId) {
-            c.push_back(component);
-        }
+    const auto ensemble = getEnsembleSnapshot();
+    for (const auto component : ensemble->findComponents(s.serviceId)) {
+        c.push_back(*component);
     }
 
     return c;
@@ -1485,26 +1901,22 @@ std::list<ServiceComponent> FIBProcessor::getComponents(const Service& s) const
 
 Subchannel FIBProcessor::getSubchannel(const ServiceComponent& sc) const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    return subChannels.at(sc.subchannelId);
+    return getEnsembleSnapshot()->subChannels.at(sc.subchannelId);
 }
 
 uint16_t FIBProcessor::getEnsembleId() const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    return ensembleId;
+    return getEnsembleSnapshot()->ensembleId;
 }
 
 uint8_t FIBProcessor::getEnsembleEcc() const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    return ensembleEcc;
+    return getEnsembleSnapshot()->ensembleEcc;
 }
 
 DabLabel FIBProcessor::getEnsembleLabel() const
 {
-    std::lock_guard<std::recursive_mutex> lock(mutex);
-    return ensembleLabel;
+    return getEnsembleSnapshot()->ensembleLabel;
 }
 
 std::chrono::system_clock::time_point FIBProcessor::getTimeLastFCT0Frame() const
@@ -1513,6 +1925,14 @@ std::chrono::system_clock::time_point FIBProcessor::getTimeLastFCT0Frame() const
     return timeLastFCT0Frame;
 }
 
+FigCacheStats FIBProcessor::getFigCacheStats() const
+{
+    FigCacheStats s;
+    s.hits = figCacheHits;
+    s.misses = figCacheMisses;
+    return s;
+}
+
 // Active announcement management methods
 
 /**
@@ -28,14 +28,77 @@
 #include <vector>
 #include <list>
 #include <unordered_map>
+#include <unordered_set>
 #include <chrono>
 #include <array>
+#include <atomic>
+#include <bitset>
+#include <memory>
 #include <mutex>
 #include <cstdint>
 #include <cstdio>
 #include "msc-handler.h"
 #include "radio-controller.h"
 #include "announcement-types.h"
+#include "ensemble-cache.h"
+
+/* Positions of the services and service components in the vectors of an
+ * ensemble database, by the keys the FIGs refer to them with. The
+ * subchannels need no index, their vector is indexed by SubChId. */
+struct EnsembleIndex {
+    // By SId
+    std::unordered_map<uint32_t, size_t> services;
+    // By SId and SCIdS, see componentKey()
+    std::unordered_map<uint64_t, size_t> components;
+    // Packet mode components by SCId
+    std::unordered_map<uint16_t, size_t> packetComponents;
+    // All components of a service by SId, in the order of the vector
+    std::unordered_map<uint32_t, std::vector<size_t> > serviceComponents;
+
+    static uint64_t componentKey(uint32_t SId, int16_t SCIdS) {
+        return ((uint64_t)SId << 16) | (uint16_t)SCIdS;
+    }
+
+    void clear();
+    void addService(const Service& s, size_t position);
+    void addComponent(const ServiceComponent& sc, size_t position);
+    void rebuild(const std::vector<Service>& services,
+            const std::vector<ServiceComponent>& components);
+};
+
+/* An immutable copy of the ensemble database. The FIBProcessor publishes
+ * a new one every time the FIGs change the database, readers that keep a
+ * snapshot see a consistent ensemble for as long as they hold it. */
+struct EnsembleSnapshot {
+    // Incremented at every change. Readers that compare it with the
+    // version they last saw can skip their work when nothing changed.
+    uint64_t version = 0;
+
+    uint16_t ensembleId = 0;
+    uint8_t ensembleEcc = 0;
+    DabLabel ensembleLabel;
+    std::vector<Service> services;
+    std::vector<ServiceComponent> components;
+    // Indexed by subchannel id
+    std::vector<Subchannel> subChannels;
+    EnsembleIndex index;
+
+    // Lookups in constant time, nullptr when missing. The pointers are
+    // valid as long as the snapshot is held.
+    const Service *findService(uint32_t SId) const;
+    const ServiceComponent *findComponent(uint32_t SId, int16_t SCIdS) const;
+    const ServiceComponent *findPacketComponent(uint16_t SCId) const;
+    const Subchannel *findSubchannel(int16_t subChId) const;
+    std::vector<const ServiceComponent*> findComponents(uint32_t SId) const;
+};
+
+struct FigCacheStats {
+    // FIGs that were byte-identical to one decoded in the last
+    // FIBProcessor::figCacheWindow, and were not decoded again
+    uint64_t hits = 0;
+    // FIGs that could be cached, but had to be decoded
+    uint64_t misses = 0;
+};
 
 class FIBProcessor {
     public:
@@ -45,7 +108,8 @@ class FIBProcessor {
         void processFIB(uint8_t *p, uint16_t fib);
         void clearEnsemble();
 
-        // Called from the frontend
+        // Called from the frontend, without waiting for the FIC thread
+        std::shared_ptr<const EnsembleSnapshot> getEnsembleSnapshot() const;
         uint16_t getEnsembleId() const;
         uint8_t getEnsembleEcc() const;
         DabLabel getEnsembleLabel() const;
@@ -54,6 +118,28 @@ class FIBProcessor {
         std::list<ServiceComponent> getComponents(const Service& s) const;
         Subchannel getSubchannel(const ServiceComponent& sc) const;
         std::chrono::system_clock::time_point getTimeLastFCT0Frame() const;
+        FigCacheStats getFigCacheStats() const;
+
+        // A repeated FIG is decoded again at least this often
+        static constexpr std::chrono::seconds figCacheWindow{10};
+
+        /* Fill the database with an ensemble from the EnsembleCache, so
+         * that a service can be played before the FIC describes it. The
+         * FIGs then confirm or correct it: when they describe a cached
+         * subchannel or service component differently, or another
+         * ensemble, the controller gets onRestartService. What the FIGs
+         * did not confirm after cacheConfirmFIBs FIBs is dropped. */
+        void preloadEnsemble(const CachedEnsemble& ensemble);
+        CachedEnsemble getCachedEnsemble() const;
+
+        // The FIGs did not confirm or correct the preloaded ensemble yet
+        bool isPreloadPending() const;
+
+        // Cached entries that turned out wrong, since the construction
+        uint64_t getCacheContradictions() const;
+
+        // About ten seconds of FIC in transmission mode I
+        static constexpr size_t cacheConfirmFIBs = 1250;
 
         // Announcement support methods (FIG 0/18)
         // Store announcement support info from FIG 0/18
@@ -104,7 +190,33 @@ class FIBProcessor {
                 int16_t ps_flag,
                 int16_t CAflag);
 
+        // Adds the component, or corrects the one of a cached service
+        void addComponent(const ServiceComponent& newcomp);
+
         void dropService(uint32_t SId);
+        // Count that FIG 0/2 signalled the service
+        void countService(uint32_t SId);
+
+        /* Most FIGs repeat without change. Returns true if the FIG is
+         * byte-identical to one that was decoded recently, while the
+         * ensemble did not change, and only updates what the repetition
+         * itself means. Otherwise the FIG is remembered and has to be
+         * decoded. FIG 0/0, 0/10 and 0/19 carry counters, time or
+         * timestamps and are always decoded. */
+        bool isRepeatedFIG(const uint8_t *d);
+        bool refreshFIG0Extension2(const uint8_t *d);
+
+        // With the mutex held. Publishes a new snapshot if a FIG changed
+        // the database since the last one.
+        void publishEnsemble();
+
+        // With the mutex held, at the end of every FIB
+        void finishFIB();
+
+        // The FIGs disagree with the preloaded ensemble
+        void cacheContradiction(const std::string& what);
+        void discardCachedEnsemble();
+        void confirmCachedEnsemble();
 
         void process_FIG0(uint8_t *);
         void process_FIG1(uint8_t *);
@@ -150,10 +262,42 @@ class FIBProcessor {
         std::vector<Subchannel> subChannels;
         std::vector<ServiceComponent> components;
         std::vector<Service> services;
+        // Kept up to date with services and components
+        EnsembleIndex index;
+        // Set by whatever changes the database, cleared by publishEnsemble()
+        bool ensembleDirty = false;
         std::unordered_map<uint32_t, uint8_t> serviceRepeatCount;
         std::chrono::steady_clock::time_point timeLastServiceDecrement;
         std::chrono::system_clock::time_point timeLastFCT0Frame;
 
+        // Only replaced with std::atomic_store, read with std::atomic_load
+        std::shared_ptr<const EnsembleSnapshot> snapshot;
+
+        struct FigCacheEntry {
+            // The FIG with its header, packed
+            std::array<uint8_t, 32> bytes;
+            uint8_t length = 0;
+            // Version of the ensemble when the FIG was decoded
+            uint64_t version = 0;
+            std::chrono::steady_clock::time_point timeDecoded;
+            std::chrono::steady_clock::time_point timeLastSeen;
+        };
+        // Keyed by a hash of the packed FIG
+        std::unordered_map<uint64_t, FigCacheEntry> figCache;
+        std::chrono::steady_clock::time_point timeLastFigCacheCleanup;
+        std::atomic<uint64_t> figCacheHits = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> figCacheMisses = ATOMIC_VAR_INIT(0);
+
+        // What preloadEnsemble() put in the database and the FIGs did
+        // not describe yet
+        bool preloadPending = false;
+        size_t fibsSincePreload = 0;
+        std::unordered_set<uint32_t> unconfirmedServices;
+        std::bitset<64> unconfirmedSubchannels;
+        // Set when the database was corrected during the current FIB
+        bool cacheContradicted = false;
+        std::atomic<uint64_t> cacheContradictions = ATOMIC_VAR_INIT(0);
+
         // Announcement support storage (FIG 0/18)
         // Maps Service ID to announcement support information
         std::unordered_map<uint32_t, ServiceAnnouncementSupport> announcementSupportMap_;
@@ -54,11 +54,20 @@ FicHandler::FicHandler(RadioControllerInterface& mr) :
     fibProcessor(mr),
     myRadioInterface(mr),
     bitBuffer_out(768),
-    ofdm_input(2304),
-    viterbiBlock(3072 + 24)
+    ofdm_input(2304)
 {
-    PI_15 = getPCodes(15 - 1);
-    PI_16 = getPCodes(16 - 1);
+    /**
+     * a block of 2304 bits is considered to be a codeword
+     * In the first step we have 21 blocks with puncturing according to PI_16
+     * each 128 bit block contains 4 subblocks of 32 bits
+     * on which the given puncturing is applied
+     * In the second step we have 3 blocks with puncturing according to PI_15.
+     * The final block of 24 bits is punctured according to PI_X
+     */
+    setDepunctureTable(buildDepunctureTable({
+                {21, getPCodes(16 - 1)},
+                {3, getPCodes(15 - 1)} }));
+
     std::vector<uint8_t> shiftRegister(9, 1);
 
     for (int i = 0; i < 768; i++) {
@@ -136,65 +145,18 @@ void FicHandler::processFicBlock(const softbit_t *data, int16_t blkno)
  * \brief processFicInput
  * we have a vector of 2304 (0 .. 2303) soft bits that has
  * to be de-punctured and de-conv-ed into a block of 768 bits
- * In this approach we first create the full 3072 block (i.e.
- * we first depuncture, and then we apply the deconvolution
- * In the next coding step, we will combine this function with the
- * one above
+ * The depuncturing table was computed in the constructor, the
+ * viterbi decoder places the soft bits directly in the full
+ * 3072 + 24 bit codeword.
  */
 void FicHandler::processFicInput(const softbit_t *ficblock, int16_t ficno)
 {
-    int16_t input_counter = 0;
-    int16_t i, k;
-    int32_t local         = 0;
-
-    memset(viterbiBlock.data(), 0, viterbiBlock.size() * sizeof(*viterbiBlock.data()));
-
-    /**
-     * a block of 2304 bits is considered to be a codeword
-     * In the first step we have 21 blocks with puncturing according to PI_16
-     * each 128 bit block contains 4 subblocks of 32 bits
-     * on which the given puncturing is applied
-     */
-    for (i = 0; i < 21; i ++) {
-        for (k = 0; k < 32 * 4; k ++) {
-            if (PI_16 [k % 32] != 0) {
-                viterbiBlock[local] = ficblock[input_counter ++];
-            }
-            local ++;
-        }
-    }
-
-    /**
-     * In the second step
-     * we have 3 blocks with puncturing according to PI_15
-     * each 128 bit block contains 4 subblocks of 32 bits
-     * on which the given puncturing is applied
-     */
-    for (i = 0; i < 3; i ++) {
-        for (k = 0; k < 32 * 4; k ++) {
-            if (PI_15 [k % 32] != 0) {
-                viterbiBlock[local] = ficblock[input_counter ++];
-            }
-            local++;
-        }
-    }
-
-    /**
-     * we have a final block of 24 bits  with puncturing according to PI_X
-     * This block constitutes the 6 * 4 bits of the register itself.
-     */
-    for (k = 0; k < 24; k ++) {
-        if (PI_X [k] != 0) {
-            viterbiBlock[local] = ficblock[input_counter++];
-        }
-        local ++;
-    }
+    int16_t i;
 
     /**
-     * Now we have the full word ready for deconvolution
      * deconvolution is according to DAB standard section 11.2
      */
-    deconvolve(viterbiBlock.data(), bitBuffer_out.data());
+    deconvolvePunctured(ficblock, bitBuffer_out.data());
 
     /**
      * if everything worked as planned, we now have a
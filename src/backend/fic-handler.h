@@ -49,11 +49,8 @@ class FicHandler: public Viterbi
     private:
         RadioControllerInterface& myRadioInterface;
         void        processFicInput(const softbit_t *ficblock, int16_t ficno);
-        const int8_t *PI_15;
-        const int8_t *PI_16;
         std::vector<uint8_t> bitBuffer_out;
         std::vector<softbit_t> ofdm_input;
-        std::vector<softbit_t> viterbiBlock;
         int16_t     index = 0;
         int16_t     bitsperBlock = 2 * 1536;
         int16_t     ficno = 0;
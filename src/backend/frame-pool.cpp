@@ -0,0 +1,127 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <iostream>
+#include <utility>
+#include "frame-pool.h"
+
+OfdmFrame::OfdmFrame(const DABParams& params, FramePool *pool) :
+    prs(params.T_u),
+    dataSymbols((params.L - 1) * params.T_s),
+    nullSymbol(params.T_null),
+    T_s(params.T_s),
+    pool(pool)
+{
+}
+
+FrameRef::FrameRef(OfdmFrame *f) :
+    frame(f)
+{
+    frame->refcount.fetch_add(1, std::memory_order_relaxed);
+}
+
+FrameRef::FrameRef(const FrameRef& other) :
+    frame(other.frame)
+{
+    if (frame) {
+        frame->refcount.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+FrameRef::FrameRef(FrameRef&& other) noexcept :
+    frame(other.frame)
+{
+    other.frame = nullptr;
+}
+
+FrameRef& FrameRef::operator=(FrameRef other) noexcept
+{
+    std::swap(frame, other.frame);
+    return *this;
+}
+
+FrameRef::~FrameRef()
+{
+    reset();
+}
+
+void FrameRef::reset()
+{
+    if (frame) {
+        // The last owner gives the frame back. acq_rel makes sure all
+        // writes done by the other owners are visible to the next user.
+        if (frame->refcount.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            frame->pool->recycle(frame);
+        }
+        frame = nullptr;
+    }
+}
+
+FramePool::FramePool(const DABParams& params, size_t size) :
+    params(params)
+{
+    frames.reserve(size);
+    free_frames.reserve(size);
+    for (size_t i = 0; i < size; i++) {
+        frames.emplace_back(new OfdmFrame(params, this));
+        free_frames.push_back(frames.back().get());
+    }
+}
+
+FrameRef FramePool::acquire()
+{
+    std::unique_lock<std::mutex> lock(mutex);
+
+    if (free_frames.empty()) {
+        std::clog << "FramePool: all " << frames.size() <<
+            " frames in use, adding one" << std::endl;
+        frames.emplace_back(new OfdmFrame(params, this));
+        // recycle() must never allocate
+        free_frames.reserve(frames.size());
+        return FrameRef(frames.back().get());
+    }
+
+    OfdmFrame *frame = free_frames.back();
+    free_frames.pop_back();
+    return FrameRef(frame);
+}
+
+size_t FramePool::size() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return frames.size();
+}
+
+size_t FramePool::available() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return free_frames.size();
+}
+
+void FramePool::recycle(OfdmFrame *frame)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    free_frames.push_back(frame);
+}
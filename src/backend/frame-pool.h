@@ -0,0 +1,173 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef FRAME_POOL_H
+#define FRAME_POOL_H
+
+/*
+ *  The samples of a transmission frame travel from the OFDMProcessor
+ *  to the OfdmDecoder and the TIIDecoder, which run in their own threads.
+ *  Instead of allocating new vectors for every frame, the frames are
+ *  taken from a FramePool and handed around by reference counted
+ *  FrameRef handles. When the last handle is dropped, the frame goes
+ *  back to the pool, so that the steady state does no heap allocation.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <vector>
+#ifdef __MINGW32__
+#include <malloc.h>
+#endif
+#include "dab-constants.h"
+
+constexpr size_t CACHE_LINE_SIZE = 64;
+
+// Allocator that places the buffer at the start of a cache line
+template <typename T>
+struct CacheAlignedAllocator {
+    using value_type = T;
+
+    CacheAlignedAllocator() = default;
+    template <typename U>
+    CacheAlignedAllocator(const CacheAlignedAllocator<U>&) {}
+
+    T* allocate(size_t n)
+    {
+        void *p = nullptr;
+#ifdef __MINGW32__
+        p = _aligned_malloc(n * sizeof(T), CACHE_LINE_SIZE);
+#else
+        if (posix_memalign(&p, CACHE_LINE_SIZE, n * sizeof(T)) != 0) {
+            p = nullptr;
+        }
+#endif
+        if (p == nullptr) {
+            throw std::bad_alloc();
+        }
+        return static_cast<T*>(p);
+    }
+
+    void deallocate(T *p, size_t)
+    {
+#ifdef __MINGW32__
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const CacheAlignedAllocator<T>&, const CacheAlignedAllocator<U>&)
+{ return true; }
+
+template <typename T, typename U>
+bool operator!=(const CacheAlignedAllocator<T>&, const CacheAlignedAllocator<U>&)
+{ return false; }
+
+using SampleBuffer = std::vector<DSPCOMPLEX, CacheAlignedAllocator<DSPCOMPLEX> >;
+
+class FramePool;
+
+struct OfdmFrame {
+    OfdmFrame(const DABParams& params, FramePool *pool);
+    OfdmFrame(const OfdmFrame& other) = delete;
+    OfdmFrame& operator=(const OfdmFrame& other) = delete;
+
+    // Symbol 0, the PRS without cyclic prefix (T_u samples)
+    SampleBuffer prs;
+
+    // Symbols 1 to L-1 with their cyclic prefix (T_s samples each), one
+    // after the other so that they can be transformed in one batch. The
+    // OfdmDecoder replaces the useful part of each symbol by its spectrum.
+    SampleBuffer dataSymbols;
+
+    DSPCOMPLEX *dataSymbol(int16_t sym) { return &dataSymbols[(sym - 1) * T_s]; }
+    const DSPCOMPLEX *dataSymbol(int16_t sym) const { return &dataSymbols[(sym - 1) * T_s]; }
+
+    // The T_null samples of the NULL symbol that follows the frame
+    SampleBuffer nullSymbol;
+
+    private:
+        friend class FrameRef;
+        const int32_t T_s;
+        FramePool *pool;
+        std::atomic<int> refcount = ATOMIC_VAR_INIT(0);
+};
+
+/* Shared ownership of a frame of the pool. Copying the handle
+ * is cheap and does not allocate. */
+class FrameRef {
+    public:
+        FrameRef() = default;
+        FrameRef(const FrameRef& other);
+        FrameRef(FrameRef&& other) noexcept;
+        FrameRef& operator=(FrameRef other) noexcept;
+        ~FrameRef();
+
+        void reset(void);
+
+        OfdmFrame& operator*() const { return *frame; }
+        OfdmFrame* operator->() const { return frame; }
+        explicit operator bool() const { return frame != nullptr; }
+
+    private:
+        friend class FramePool;
+        explicit FrameRef(OfdmFrame *f);
+
+        OfdmFrame *frame = nullptr;
+};
+
+class FramePool {
+    public:
+        /* Preallocate size frames for the given transmission mode */
+        FramePool(const DABParams& params, size_t size);
+        FramePool(const FramePool& other) = delete;
+        FramePool& operator=(const FramePool& other) = delete;
+
+        /* Take a frame from the pool. If all frames are in use, the pool
+         * grows by one frame. The content of the frame is unspecified. */
+        FrameRef acquire(void);
+
+        size_t size(void) const;
+        size_t available(void) const;
+
+    private:
+        friend class FrameRef;
+        void recycle(OfdmFrame *frame);
+
+        const DABParams& params;
+
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<OfdmFrame> > frames;
+        std::vector<OfdmFrame*> free_frames;
+};
+
+#endif
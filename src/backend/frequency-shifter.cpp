@@ -0,0 +1,269 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "frequency-shifter.h"
+#include "various/cpu_features.h"
+#include "various/MathHelper.h"
+
+#if defined(WELLE_HAVE_X86_SIMD)
+#  include <immintrin.h>
+#endif
+
+static_assert(sizeof(DSPCOMPLEX) == 2 * sizeof(float),
+        "The kernels work on interleaved float samples");
+static_assert(FrequencyShifter::anchorInterval % FrequencyShifter::lanes == 0,
+        "The NCO must be re-seeded on a lane boundary");
+
+//  The kernels work on the interleaved real and imaginary parts and
+//  avoid std::complex multiplication, which checks for NaN and infinity.
+
+//  Multiply v[i] by start[i % lanes] * step^(i / lanes), n is a
+//  multiple of lanes.
+static void rotate_generic(DSPCOMPLEX *v, int32_t n,
+        const DSPCOMPLEX *start, DSPCOMPLEX step)
+{
+    constexpr int32_t lanes = FrequencyShifter::lanes;
+    float *f = reinterpret_cast<float*>(v);
+    float z_re[lanes];
+    float z_im[lanes];
+    for (int32_t k = 0; k < lanes; k++) {
+        z_re[k] = start[k].real();
+        z_im[k] = start[k].imag();
+    }
+    const float s_re = step.real();
+    const float s_im = step.imag();
+
+    for (int32_t i = 0; i < n; i += lanes) {
+        float *p = f + 2 * i;
+        for (int32_t k = 0; k < lanes; k++) {
+            const float re = p[2 * k];
+            const float im = p[2 * k + 1];
+            p[2 * k]     = re * z_re[k] - im * z_im[k];
+            p[2 * k + 1] = im * z_re[k] + re * z_im[k];
+
+            const float zr = z_re[k];
+            z_re[k] = zr * s_re - z_im[k] * s_im;
+            z_im[k] = z_im[k] * s_re + zr * s_im;
+        }
+    }
+}
+
+//  Sum of |f[j]| * weights[j] for j < n
+static float weighted_sum_generic(const float *f, const float *weights, int32_t n)
+{
+    constexpr int32_t lanes = 8;
+    float acc[lanes] = {};
+
+    int32_t j = 0;
+    for (; j + lanes <= n; j += lanes) {
+        for (int32_t k = 0; k < lanes; k++) {
+            acc[k] += std::abs(f[j + k]) * weights[j + k];
+        }
+    }
+    for (; j < n; j++) {
+        acc[0] += std::abs(f[j]) * weights[j];
+    }
+
+    float sum = 0;
+    for (int32_t k = 0; k < lanes; k++) {
+        sum += acc[k];
+    }
+    return sum;
+}
+
+#if defined(WELLE_HAVE_X86_SIMD)
+//  Complex multiplication of four interleaved samples by b_re + j b_im
+__attribute__((target("avx2")))
+static inline __m256 cmul_AVX2(__m256 a, __m256 b_re, __m256 b_im)
+{
+    const __m256 a_swapped = _mm256_permute_ps(a, 0xB1);
+    return _mm256_addsub_ps(_mm256_mul_ps(a, b_re),
+            _mm256_mul_ps(a_swapped, b_im));
+}
+
+__attribute__((target("avx2")))
+static void rotate_AVX2(DSPCOMPLEX *v, int32_t n,
+        const DSPCOMPLEX *start, DSPCOMPLEX step)
+{
+    float *f = reinterpret_cast<float*>(v);
+    const float *s = reinterpret_cast<const float*>(start);
+    __m256 z0 = _mm256_loadu_ps(s);
+    __m256 z1 = _mm256_loadu_ps(s + 8);
+    const __m256 s_re = _mm256_set1_ps(step.real());
+    const __m256 s_im = _mm256_set1_ps(step.imag());
+
+    for (int32_t i = 0; i < n; i += FrequencyShifter::lanes) {
+        float *p = f + 2 * i;
+        const __m256 a0 = _mm256_loadu_ps(p);
+        const __m256 a1 = _mm256_loadu_ps(p + 8);
+        _mm256_storeu_ps(p, cmul_AVX2(a0,
+                    _mm256_moveldup_ps(z0), _mm256_movehdup_ps(z0)));
+        _mm256_storeu_ps(p + 8, cmul_AVX2(a1,
+                    _mm256_moveldup_ps(z1), _mm256_movehdup_ps(z1)));
+
+        z0 = cmul_AVX2(z0, s_re, s_im);
+        z1 = cmul_AVX2(z1, s_re, s_im);
+    }
+}
+
+__attribute__((target("avx2")))
+static float weighted_sum_AVX2(const float *f, const float *weights, int32_t n)
+{
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+
+    int32_t j = 0;
+    for (; j + 16 <= n; j += 16) {
+        const __m256 a0 = _mm256_andnot_ps(sign, _mm256_loadu_ps(f + j));
+        const __m256 a1 = _mm256_andnot_ps(sign, _mm256_loadu_ps(f + j + 8));
+        acc0 = _mm256_add_ps(acc0, _mm256_mul_ps(a0, _mm256_loadu_ps(weights + j)));
+        acc1 = _mm256_add_ps(acc1, _mm256_mul_ps(a1, _mm256_loadu_ps(weights + j + 8)));
+    }
+
+    const __m256 acc = _mm256_add_ps(acc0, acc1);
+    __m128 sum = _mm_add_ps(_mm256_castps256_ps128(acc),
+            _mm256_extractf128_ps(acc, 1));
+    sum = _mm_add_ps(sum, _mm_movehl_ps(sum, sum));
+    sum = _mm_add_ss(sum, _mm_shuffle_ps(sum, sum, 1));
+
+    float result = _mm_cvtss_f32(sum);
+    for (; j < n; j++) {
+        result += std::abs(f[j]) * weights[j];
+    }
+    return result;
+}
+#endif
+
+FrequencyShifter::FrequencyShifter() :
+    rotate(rotate_generic),
+    oscillatorTable(INPUT_RATE)
+{
+    for (int i = 0; i < INPUT_RATE; i ++)
+        oscillatorTable[i] = DSPCOMPLEX(cos(2.0 * M_PI * i / INPUT_RATE),
+                sin(2.0 * M_PI * i / INPUT_RATE));
+
+#if defined(WELLE_HAVE_X86_SIMD)
+    if (cpu_features::has_avx2()) {
+        rotate = rotate_AVX2;
+    }
+#endif
+}
+
+DSPCOMPLEX FrequencyShifter::oscillator(int64_t phase) const
+{
+    phase %= INPUT_RATE;
+    if (phase < 0)
+        phase += INPUT_RATE;
+    return oscillatorTable[phase];
+}
+
+void FrequencyShifter::shiftWithTable(DSPCOMPLEX *v, int32_t n, int32_t phase)
+{
+    for (int32_t i = 0; i < n; i ++) {
+        localPhase  -= phase;
+        localPhase   = (localPhase + INPUT_RATE) % INPUT_RATE;
+        v[i]    *= oscillatorTable[localPhase];
+    }
+}
+
+void FrequencyShifter::shift(DSPCOMPLEX *v, int32_t n, int32_t phase)
+{
+    //  Sample i of the block is multiplied with the table entry
+    //  localPhase - (i + 1) * phase, lane k starts at sample k of
+    //  the block and advances by lanes samples at a time.
+    const DSPCOMPLEX step = oscillator(-(int64_t)lanes * phase);
+
+    int32_t i = 0;
+    while (n - i >= lanes) {
+        const int32_t len = std::min(anchorInterval, (n - i) & ~(lanes - 1));
+
+        DSPCOMPLEX start[lanes];
+        for (int32_t k = 0; k < lanes; k++) {
+            start[k] = oscillator(localPhase - (int64_t)(k + 1) * phase);
+        }
+        rotate(v + i, len, start, step);
+
+        int64_t p = ((int64_t)localPhase - (int64_t)len * phase) % INPUT_RATE;
+        localPhase = p < 0 ? p + INPUT_RATE : p;
+        i += len;
+    }
+
+    shiftWithTable(v + i, n - i, phase);
+}
+
+void FrequencyShifter::rewind(int32_t n, int32_t phase)
+{
+    int64_t p = ((int64_t)localPhase + (int64_t)n * phase) % INPUT_RATE;
+    localPhase = p < 0 ? p + INPUT_RATE : p;
+}
+
+LevelTracker::LevelTracker(double alpha) :
+    weightedSum(weighted_sum_generic),
+    alpha(alpha),
+    weights(2 * blockSize),
+    decay(blockSize + 1)
+{
+    for (int32_t k = 0; k <= blockSize; k++) {
+        decay[k] = pow(1 - alpha, k);
+    }
+
+    for (int32_t i = 0; i < blockSize; i++) {
+        weights[2 * i] = weights[2 * i + 1] = decay[blockSize - 1 - i];
+    }
+
+#if defined(WELLE_HAVE_X86_SIMD)
+    if (cpu_features::has_avx2()) {
+        weightedSum = weighted_sum_AVX2;
+    }
+#endif
+}
+
+float LevelTracker::updateSampleBySample(float level, const DSPCOMPLEX *v, int32_t n) const
+{
+    for (int32_t i = 0; i < n; i ++) {
+        level = alpha * l1_norm(v[i]) + (1 - alpha) * level;
+    }
+    return level;
+}
+
+float LevelTracker::update(float level, const DSPCOMPLEX *v, int32_t n) const
+{
+    //  After len samples x_i, the average is
+    //  (1 - alpha)^len * level + alpha * sum x_i (1 - alpha)^(len - 1 - i)
+    while (n > 0) {
+        const int32_t len = std::min(n, blockSize);
+        const float *w = &weights[2 * (blockSize - len)];
+        const float sum = weightedSum(
+                reinterpret_cast<const float*>(v), w, 2 * len);
+        level = decay[len] * level + alpha * sum;
+
+        v += len;
+        n -= len;
+    }
+    return level;
+}
@@ -0,0 +1,107 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef FREQUENCY_SHIFTER_H
+#define FREQUENCY_SHIFTER_H
+
+/*
+ *  Front-end processing of the OFDMProcessor, which touches every input
+ *  sample: the frequency correction and the tracking of the signal level.
+ *
+ *  Both have a per sample reference implementation, which is what the
+ *  OFDMProcessor used to do, and a block implementation that is
+ *  vectorised and selected at runtime according to the CPU.
+ */
+
+#include <cstdint>
+#include <vector>
+#include "dab-constants.h"
+
+class FrequencyShifter {
+    public:
+        FrequencyShifter(void);
+
+        void reset(void) { localPhase = 0; }
+
+        /* Multiply the n samples of v with the local oscillator. The
+         * oscillator phase moves by -phase Hz per sample, and continues
+         * where the previous call stopped.
+         *
+         * The block version runs a recursive complex NCO on several lanes,
+         * re-seeded from the oscillator table every anchorInterval
+         * samples, so that the rounding errors cannot accumulate. */
+        void shift(DSPCOMPLEX *v, int32_t n, int32_t phase);
+        void shiftWithTable(DSPCOMPLEX *v, int32_t n, int32_t phase);
+
+        /* Undo the phase advance of the last n samples shifted by phase,
+         * for samples that are given back to be shifted again later. */
+        void rewind(int32_t n, int32_t phase);
+
+        int32_t getLocalPhase(void) const { return localPhase; }
+
+        static constexpr int32_t lanes = 8;
+        static constexpr int32_t anchorInterval = 256;
+
+    private:
+        DSPCOMPLEX oscillator(int64_t phase) const;
+
+        using rotate_fn = void (*)(DSPCOMPLEX *v, int32_t n,
+                const DSPCOMPLEX *start, DSPCOMPLEX step);
+        rotate_fn rotate;
+
+        std::vector<DSPCOMPLEX> oscillatorTable;
+        int32_t localPhase = 0;
+};
+
+class LevelTracker {
+    public:
+        /* Exponential moving average of the L1 norm of the samples,
+         * level = alpha * l1_norm(sample) + (1 - alpha) * level */
+        LevelTracker(double alpha);
+
+        /* The block version computes the average over a whole block
+         * as a weighted sum, which does not have the dependency from
+         * one sample to the next. */
+        float update(float level, const DSPCOMPLEX *v, int32_t n) const;
+        float updateSampleBySample(float level, const DSPCOMPLEX *v, int32_t n) const;
+
+        static constexpr int32_t blockSize = 4096;
+
+    private:
+        using weighted_sum_fn = float (*)(const float *f,
+                const float *weights, int32_t n);
+        weighted_sum_fn weightedSum;
+
+        double alpha;
+
+        // weights[2i] = weights[2i + 1] = (1 - alpha)^(blockSize - 1 - i),
+        // one weight for the real and one for the imaginary part
+        std::vector<float> weights;
+
+        // decay[k] = (1 - alpha)^k
+        std::vector<float> decay;
+};
+
+#endif
@@ -37,9 +37,11 @@
 //  Note CIF counts from 0 .. 3
 MscHandler::MscHandler(
         const DABParams& p,
-        bool show_crcErrors) :
+        bool show_crcErrors,
+        bool singleThreaded) :
     bitsperBlock(2 * p.K),
     show_crcErrors(show_crcErrors),
+    singleThreaded(singleThreaded),
     cifVector(864 * CUSize)
 {
     if (p.dabMode == 4) {  // 2 CIFS per 76 blocks
@@ -56,6 +58,8 @@ MscHandler::MscHandler(
                 numberofblocksperCIF = 18;
         }
     }
+
+    selectedBlocks.resize(numberofblocksperCIF, false);
 }
 
 bool MscHandler::addSubchannel(
@@ -81,7 +85,8 @@ bool MscHandler::addSubchannel(
                 sub.bitrate(),
                 sub.protectionSettings,
                 handler,
-                dumpFileName);
+                dumpFileName,
+                singleThreaded);
 
      /* TODO dealing with data
       s.dabHandler = std::make_shared<DabData>(radioInterface,
@@ -97,6 +102,7 @@ bool MscHandler::addSubchannel(
       */
 
     streams.push_back(std::move(s));
+    updateSelectedBlocks();
 
     work_to_be_done = true;
     return true;
@@ -113,12 +119,41 @@ bool MscHandler::removeSubchannel(const Subchannel& sub)
 
     if (it != streams.end()) {
         streams.erase(it);
+        updateSelectedBlocks();
         return true;
     }
 
     return false;
 }
 
+bool MscHandler::removeSubchannel(const ProgrammeHandlerInterface& handler)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    auto it = std::find_if(streams.begin(), streams.end(),
+            [&](const SelectedStream& stream) {
+                return &stream.handler == &handler;
+            } );
+
+    if (it != streams.end()) {
+        streams.erase(it);
+        updateSelectedBlocks();
+        return true;
+    }
+
+    return false;
+}
+
+void MscHandler::drain(void)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto& stream : streams) {
+        if (stream.dabHandler) {
+            stream.dabHandler->drain();
+        }
+    }
+}
+
 //  add blocks. First is (should be) block 5, last is (should be) 76
 //  Note that this method is called from within the ofdm-processor thread
 //  while the set_xxx methods are called from within the
@@ -136,7 +171,9 @@ void MscHandler::processMscBlock(const softbit_t *fbits, int16_t blkno)
     int16_t currentblk = (blkno - 4) % numberofblocksperCIF;
 
     //  and the normal operation is:
-    memcpy(&cifVector[currentblk * bitsperBlock], fbits, bitsperBlock * sizeof(softbit_t));
+    if (fbits) {
+        memcpy(&cifVector[currentblk * bitsperBlock], fbits, bitsperBlock * sizeof(softbit_t));
+    }
 
     if (currentblk < numberofblocksperCIF - 1)
         return;
@@ -162,5 +199,40 @@ void MscHandler::stopProcessing()
     std::lock_guard<std::mutex> lock(mutex);
     work_to_be_done = false;
     streams.clear();
+    updateSelectedBlocks();
+}
+
+//  A subchannel occupies CUs startAddr .. startAddr + length - 1
+//  of the CIF, each block of the CIF holds bitsperBlock / CUSize CUs.
+//  Called with the mutex held.
+void MscHandler::updateSelectedBlocks()
+{
+    std::fill(selectedBlocks.begin(), selectedBlocks.end(), false);
+
+    for (const auto& stream : streams) {
+        if (stream.subCh.length <= 0) {
+            continue;
+        }
+
+        const int32_t firstBit = stream.subCh.startAddr * CUSize;
+        const int32_t lastBit =
+            (stream.subCh.startAddr + stream.subCh.length) * CUSize - 1;
+
+        for (int32_t blk = firstBit / bitsperBlock;
+                blk <= lastBit / bitsperBlock and blk < numberofblocksperCIF;
+                blk++) {
+            selectedBlocks[blk] = true;
+        }
+    }
+}
+
+void MscHandler::getSymbolSelection(std::vector<bool>& mask, int16_t L)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+
+    mask.assign(L, false);
+    for (int16_t sym = 4; sym < L; sym++) {
+        mask[sym] = selectedBlocks[(sym - 4) % numberofblocksperCIF];
+    }
 }
 
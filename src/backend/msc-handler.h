@@ -46,7 +46,10 @@ class DabVirtual;
 class MscHandler
 {
     public:
-        MscHandler(const DABParams& p, bool show_crcErrors);
+        /* Single-threaded, the subchannels are decoded by the
+         * caller of processMscBlock instead of a thread each. */
+        MscHandler(const DABParams& p, bool show_crcErrors,
+                bool singleThreaded = false);
 
         // Stop processing and remove all subchannels
         void stopProcessing(void);
@@ -59,10 +62,26 @@ class MscHandler
 
         bool removeSubchannel(const Subchannel& sub);
 
+        /* Remove the subchannel the handler was added with, even if the
+         * ensemble now describes it differently */
+        bool removeSubchannel(const ProgrammeHandlerInterface& handler);
+
+        // Wait until the subchannels decoded all the data they were given
+        void drain(void);
+
     private:
         friend class OfdmDecoder;
+
+        /* Process the soft bits of OFDM symbol blkno. fbits can be nullptr
+         * for a symbol that was not demodulated because it carries no
+         * CU of a selected subchannel. */
         void processMscBlock(const softbit_t *fbits, int16_t blkno);
 
+        /* Fill mask with one entry per OFDM symbol of a frame of L symbols,
+         * true if the symbol carries CUs of a selected subchannel.
+         * The FIC symbols are always false. */
+        void getSymbolSelection(std::vector<bool>& mask, int16_t L);
+
         struct SelectedStream {
             SelectedStream(
                 ProgrammeHandlerInterface& handler,
@@ -86,9 +105,15 @@ class MscHandler
         std::mutex mutex;
         std::list<SelectedStream> streams;
 
+        // Blocks of the CIF that overlap a selected subchannel,
+        // updated whenever the streams change
+        std::vector<bool> selectedBlocks;
+        void updateSelectedBlocks(void);
+
         const int16_t bitsperBlock;
         int16_t numberofblocksperCIF;
         bool show_crcErrors;
+        const bool singleThreaded;
 
         std::vector<softbit_t> cifVector;
         int16_t cifCount = 0; // msc blocks in CIF
@@ -0,0 +1,232 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+#include "null-detector.h"
+#include "various/cpu_features.h"
+
+#if defined(WELLE_HAVE_X86_SIMD)
+#  include <immintrin.h>
+#endif
+
+//  env[i] = l1_norm(v[i])
+static void envelope_generic(const DSPCOMPLEX *v, float *env, int32_t n)
+{
+    const float *f = reinterpret_cast<const float*>(v);
+    for (int32_t i = 0; i < n; i++) {
+        env[i] = std::abs(f[2 * i]) + std::abs(f[2 * i + 1]);
+    }
+}
+
+//  True if the moving sum before a sample shows the edge
+static inline bool is_edge(bool start, float strength, float level)
+{
+    return start ?
+        not (strength / NullDetector::window > NullDetector::startThreshold * level) :
+        not (strength / NullDetector::window < NullDetector::endThreshold * level);
+}
+
+//  Sample i enters the moving sum with newEnv[i], and the one window
+//  samples earlier leaves it with oldEnv[i]. Returns the number of
+//  samples consumed before the edge, or n.
+static int32_t scan_generic(const float *oldEnv, const float *newEnv,
+        int32_t n, bool start, const NullDetector::LevelWeights& w,
+        float& strength, float& level, bool& found)
+{
+    for (int32_t i = 0; i < n; i++) {
+        if (is_edge(start, strength, level)) {
+            found = true;
+            return i;
+        }
+        strength += newEnv[i] - oldEnv[i];
+        level = w.alpha * newEnv[i] + (1 - w.alpha) * level;
+    }
+    found = false;
+    return n;
+}
+
+#if defined(WELLE_HAVE_X86_SIMD)
+__attribute__((target("avx2")))
+static void envelope_AVX2(const DSPCOMPLEX *v, float *env, int32_t n)
+{
+    const float *f = reinterpret_cast<const float*>(v);
+    const __m256 sign = _mm256_set1_ps(-0.0f);
+
+    int32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m256 a0 = _mm256_andnot_ps(sign, _mm256_loadu_ps(f + 2 * i));
+        const __m256 a1 = _mm256_andnot_ps(sign, _mm256_loadu_ps(f + 2 * i + 8));
+        // The horizontal add works within each 128 bit half,
+        // which leaves the samples in the order 0 1 4 5 2 3 6 7
+        const __m256 sum = _mm256_hadd_ps(a0, a1);
+        _mm256_storeu_ps(env + i, _mm256_castpd_ps(_mm256_permute4x64_pd(
+                        _mm256_castps_pd(sum), _MM_SHUFFLE(3, 1, 2, 0))));
+    }
+
+    envelope_generic(v + i, env + i, n - i);
+}
+
+//  Inclusive prefix sum of the eight floats of x
+__attribute__((target("avx2")))
+static inline __m256 prefix_sum_AVX2(__m256 x)
+{
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(
+                _mm256_slli_si256(_mm256_castps_si256(x), 4)));
+    x = _mm256_add_ps(x, _mm256_castsi256_ps(
+                _mm256_slli_si256(_mm256_castps_si256(x), 8)));
+    // Add the total of the lower half to the upper half
+    const __m256 low_total = _mm256_permute_ps(x, _MM_SHUFFLE(3, 3, 3, 3));
+    return _mm256_add_ps(x, _mm256_permute2f128_ps(low_total, low_total, 0x08));
+}
+
+__attribute__((target("avx2")))
+static int32_t scan_AVX2(const float *oldEnv, const float *newEnv,
+        int32_t n, bool start, const NullDetector::LevelWeights& w,
+        float& strength, float& level, bool& found)
+{
+    static_assert(NullDetector::lanes == 8, "The kernel works on eight lanes");
+    const __m256 window = _mm256_set1_ps(NullDetector::window);
+    const __m256 threshold = _mm256_set1_ps(start ?
+            NullDetector::startThreshold : NullDetector::endThreshold);
+    const __m256 drop = _mm256_loadu_ps(w.drop);
+    const float alpha = w.alpha;
+
+    int32_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        //  The moving sum before each sample of the group
+        const __m256 e = _mm256_loadu_ps(newEnv + i);
+        const __m256 d = _mm256_sub_ps(e, _mm256_loadu_ps(oldEnv + i));
+        const __m256 total = prefix_sum_AVX2(d);
+        const __m256 sums = _mm256_add_ps(_mm256_set1_ps(strength),
+                _mm256_sub_ps(total, d));
+
+        //  and the level before each sample
+        const __m256 l = _mm256_set1_ps(level);
+        __m256 change = _mm256_mul_ps(drop, l);
+        change = _mm256_sub_ps(_mm256_setzero_ps(), change);
+        for (int32_t j = 0; j < 7; j++) {
+            change = _mm256_add_ps(change, _mm256_mul_ps(
+                        _mm256_loadu_ps(w.weights[j]),
+                        _mm256_broadcast_ss(newEnv + i + j)));
+        }
+        const __m256 levels = _mm256_add_ps(l, change);
+
+        const __m256 average = _mm256_div_ps(sums, window);
+        const __m256 limit = _mm256_mul_ps(threshold, levels);
+        const int edges = _mm256_movemask_ps(start ?
+                _mm256_cmp_ps(average, limit, _CMP_NGT_UQ) :
+                _mm256_cmp_ps(average, limit, _CMP_NLT_UQ));
+
+        float s[8];
+        float lv[8];
+        _mm256_storeu_ps(s, sums);
+        _mm256_storeu_ps(lv, levels);
+
+        if (edges) {
+            const int32_t k = __builtin_ctz(edges);
+            strength = s[k];
+            level = lv[k];
+            found = true;
+            return i + k;
+        }
+
+        strength = s[7] + (newEnv[i + 7] - oldEnv[i + 7]);
+        level = lv[7] + alpha * (newEnv[i + 7] - lv[7]);
+    }
+
+    const int32_t consumed = scan_generic(oldEnv + i, newEnv + i, n - i,
+            start, w, strength, level, found);
+    return i + consumed;
+}
+#endif
+
+NullDetector::NullDetector(double alpha) :
+    envelope(envelope_generic),
+    scan(scan_generic),
+    envelopeBuffer(window + blockSize)
+{
+    //  The level before sample k of a group is
+    //  (1 - alpha)^k level + alpha sum_{j<k} (1 - alpha)^(k - 1 - j) e_j
+    levelWeights.alpha = alpha;
+    for (int32_t k = 0; k < lanes; k++) {
+        levelWeights.drop[k] = 1 - pow(1 - alpha, k);
+    }
+    for (int32_t j = 0; j < lanes; j++) {
+        for (int32_t k = 0; k < lanes; k++) {
+            levelWeights.weights[j][k] = j < k ?
+                alpha * pow(1 - alpha, k - 1 - j) : 0;
+        }
+    }
+
+#if defined(WELLE_HAVE_X86_SIMD)
+    if (cpu_features::has_avx2()) {
+        envelope = envelope_AVX2;
+        scan = scan_AVX2;
+    }
+#endif
+}
+
+void NullDetector::reset(const DSPCOMPLEX *v)
+{
+    envelope(v, envelopeBuffer.data(), window);
+    currentStrength = 0;
+    for (int32_t i = 0; i < window; i++) {
+        currentStrength += envelopeBuffer[i];
+    }
+}
+
+int32_t NullDetector::findNullStart(const DSPCOMPLEX *v, int32_t n,
+        float& level, bool& found)
+{
+    return find(true, v, n, level, found);
+}
+
+int32_t NullDetector::findNullEnd(const DSPCOMPLEX *v, int32_t n,
+        float& level, bool& found)
+{
+    return find(false, v, n, level, found);
+}
+
+int32_t NullDetector::find(bool start, const DSPCOMPLEX *v, int32_t n,
+        float& level, bool& found)
+{
+    if (n > blockSize) {
+        throw std::logic_error("NullDetector: block too large");
+    }
+
+    float *oldEnv = envelopeBuffer.data();
+    float *newEnv = oldEnv + window;
+    envelope(v, newEnv, n);
+
+    const int32_t consumed = scan(oldEnv, newEnv, n, start, levelWeights,
+            currentStrength, level, found);
+
+    //  Keep the envelope of the last window samples consumed
+    std::copy(oldEnv + consumed, oldEnv + consumed + window, oldEnv);
+    return consumed;
+}
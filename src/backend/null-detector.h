@@ -0,0 +1,107 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#ifndef NULL_DETECTOR_H
+#define NULL_DETECTOR_H
+
+/*
+ *  Detection of the null symbol at the start of a DAB frame, used by the
+ *  OFDMProcessor while it is not synchronised.
+ *
+ *  The average of the L1 norm of the last `window` samples is compared
+ *  to the long term signal level. The null symbol starts when the average
+ *  falls below startThreshold * level, and ends when it rises above
+ *  endThreshold * level again.
+ *
+ *  The detector works on blocks: the envelope of a whole block is
+ *  computed at once, and the vectorised kernel computes the moving sum
+ *  and the level before `lanes` samples at a time, as prefix sums. The
+ *  edge is still reported at the exact sample, as by the per sample
+ *  version, so that the caller knows where to continue. The kernels are
+ *  selected at runtime according to the CPU.
+ */
+
+#include <cstdint>
+#include <vector>
+#include "dab-constants.h"
+
+class NullDetector {
+    public:
+        /* alpha is the one of the LevelTracker of the OFDMProcessor */
+        NullDetector(double alpha);
+
+        /* Start over with the first window samples of v, which must
+         * already be accounted for in the level. */
+        void reset(const DSPCOMPLEX *v);
+
+        /* Consume the samples of v, one at a time and updating the level,
+         * as long as the edge is not seen. Returns the number of samples
+         * consumed, found tells whether the edge was seen right after
+         * them. */
+        int32_t findNullStart(const DSPCOMPLEX *v, int32_t n,
+                float& level, bool& found);
+        int32_t findNullEnd(const DSPCOMPLEX *v, int32_t n,
+                float& level, bool& found);
+
+        static constexpr int32_t window = 50;
+        static constexpr double startThreshold = 0.50;
+        static constexpr double endThreshold = 0.75;
+
+        // The largest block the detector is given at once
+        static constexpr int32_t blockSize = 2048;
+
+        static constexpr int32_t lanes = 8;
+
+        // For sample k of a group of lanes samples, the level before it
+        // is level - drop[k] * level + sum_j weights[j][k] * envelope_j,
+        // the sum running over the samples j before k.
+        struct LevelWeights {
+            double alpha;
+            float drop[lanes];
+            float weights[lanes][lanes];
+        };
+
+    private:
+        int32_t find(bool start, const DSPCOMPLEX *v, int32_t n,
+                float& level, bool& found);
+
+        using envelope_fn = void (*)(const DSPCOMPLEX *v, float *env, int32_t n);
+        envelope_fn envelope;
+
+        using scan_fn = int32_t (*)(const float *oldEnv, const float *newEnv,
+                int32_t n, bool start, const LevelWeights& w,
+                float& strength, float& level, bool& found);
+        scan_fn scan;
+
+        LevelWeights levelWeights;
+
+        // The envelope of the last window samples consumed, followed by
+        // the envelope of the block being scanned
+        std::vector<float> envelopeBuffer;
+        float currentStrength = 0;
+};
+
+#endif
@@ -27,6 +27,7 @@
  *  its invocation results in 2 * Tu bits
  */
 
+#include <algorithm>
 #include <cstddef>
 #include "ofdm-decoder.h"
 #include "various/profiling.h"
@@ -43,32 +44,44 @@ OfdmDecoder::OfdmDecoder(
         const DABParams& p,
         RadioControllerInterface& mr,
         FicHandler& ficHandler,
-        MscHandler& mscHandler) :
+        MscHandler& mscHandler,
+        size_t queueDepth,
+        bool singleThreaded,
+        size_t fftThreads) :
     params(p),
     radioInterface(mr),
     ficHandler(ficHandler),
     mscHandler(mscHandler),
-    pending_symbols(params.L),
-    phaseReference(params.T_u),
+    singleThreaded(singleThreaded),
     fft_handler(p.T_u),
-    interleaver(p),
-    ibits(2 * params.K)
+    fft_batch(p.T_u, p.L - 1, p.T_s, p.T_s - p.T_u, fftThreads),
+    demodulator(p),
+    ibits(2 * params.K),
+    selectedSymbols(params.L, false),
+    transformedSymbols(params.L - 1, false)
 {
     T_g = params.T_s - params.T_u;
     fft_buffer = fft_handler.getVector();
+    setQueueDepth(queueDepth);
 
     /**
      * When implemented in a thread, the thread controls the
      * reading in of the data and processing the data through
      * functions for handling symbol 0, FIC symbols and MSC symbols.
+     * Single-threaded, the caller of pushAllSymbols does all of this.
      */
-    thread = std::thread(&OfdmDecoder::workerthread, this);
+    if (singleThreaded) {
+        running = true;
+    }
+    else {
+        thread = std::thread(&OfdmDecoder::workerthread, this);
+    }
 }
 
 OfdmDecoder::~OfdmDecoder()
 {
     running = false;
-    pending_symbols_cv.notify_all();
+    wakeUp();
     if (thread.joinable()) {
         thread.join();
     }
@@ -77,75 +90,173 @@ OfdmDecoder::~OfdmDecoder()
 void OfdmDecoder::reset()
 {
     running = false;
-    pending_symbols_cv.notify_all();
+    wakeUp();
     if (thread.joinable()) {
         thread.join();
     }
 
-    thread = std::thread(&OfdmDecoder::workerthread, this);
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending_frames.clear();
+    }
+
+    if (singleThreaded) {
+        running = true;
+    }
+    else {
+        thread = std::thread(&OfdmDecoder::workerthread, this);
+    }
 }
 
 /**
  * The code in the thread executes a simple loop,
- * waiting for the next symbols and executing the interpretation
- * operation for that symbols.
+ * waiting for the next frame and decoding all its symbols.
+ * The mutex is only held to take the frame from the queue and
+ * to give it back, so that the OFDMProcessor is never blocked
+ * by the decoding.
  */
 void OfdmDecoder::workerthread()
 {
-    int currentSym = 0;
-
     running = true;
 
     while (running) {
-        std::unique_lock<std::mutex> lock(mutex);
-        pending_symbols_cv.wait_for(lock, std::chrono::milliseconds(100));
+        FrameRef frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            pending_frames_cv.wait_for(lock, std::chrono::milliseconds(100),
+                    [this]() { return not pending_frames.empty() or not running; });
+
+            if (pending_frames.empty()) {
+                continue;
+            }
 
-        if (currentSym == 0) {
-            constellationPoints.clear();
-            constellationPoints.reserve(
-                    (params.L-1) * params.K / constellationDecimation);
+            frame = std::move(pending_frames.front());
+            pending_frames.erase(pending_frames.begin());
+            queue_space_cv.notify_one();
         }
 
-        while (num_pending_symbols > 0 && running) {
+        decodeFrame(std::move(frame));
+    }
 
-            if (currentSym == 0)
-                processPRS();
-            else
-                decodeDataSymbol(currentSym);
+    std::clog << "OFDM-decoder:" <<  "closing down now" << std::endl;
+}
 
-            currentSym = (currentSym + 1) % (params.L);
-            num_pending_symbols -= 1;
+void OfdmDecoder::decodeFrame(FrameRef frame)
+{
+    processPRS(frame->prs);
 
-            if (currentSym == 0) {
-                radioInterface.onConstellationPoints(
-                        std::move(constellationPoints));
-                constellationPoints.clear();
-                constellationPoints.reserve(
-                        (params.L-1) * params.K / constellationDecimation);
-            }
-        }
+    /**
+     * All data symbols we need are transformed in one batch, in place
+     * in the frame. The differential demodulation then works on the
+     * contiguous spectra, every symbol being the phase reference of
+     * the next one.
+     */
+    for (int16_t sym = 1; sym < params.L; sym++) {
+        transformedSymbols[sym - 1] = needsTransform(sym);
+    }
+    fft_batch.do_FFT(frame->dataSymbols.data(), transformedSymbols);
+    PROFILE(SymbolsFFT);
+
+    const DSPCOMPLEX *reference = fft_buffer;
+    for (int16_t sym = 1; sym < params.L and running; sym++) {
+        const DSPCOMPLEX *spectrum = frame->dataSymbol(sym) + T_g;
+        decodeDataSymbol(spectrum, reference, sym);
+        reference = spectrum;
     }
 
-    std::clog << "OFDM-decoder:" <<  "closing down now" << std::endl;
+    // Give the buffers back to the pool as soon as possible
+    frame.reset();
+
+    if (constellation) {
+        radioInterface.onConstellationPoints(
+                std::move(constellationPoints));
+    }
+
+    std::lock_guard<std::mutex> lock(mutex);
+    queueStats.framesDecoded++;
+}
+
+void OfdmDecoder::setFicOnly(bool fic_only)
+{
+    ficOnlyRequested = fic_only;
+}
+
+void OfdmDecoder::setConstellationEnabled(bool enabled)
+{
+    constellationRequested = enabled;
 }
 
-void OfdmDecoder::pushAllSymbols(std::vector<std::vector<DSPCOMPLEX> >&& syms)
+void OfdmDecoder::pushAllSymbols(FrameRef frame)
 {
+    if (singleThreaded) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queueStats.framesPushed++;
+            queueStats.highWaterMark = std::max<size_t>(queueStats.highWaterMark, 1);
+        }
+        decodeFrame(std::move(frame));
+        return;
+    }
+
     std::unique_lock<std::mutex> lock(mutex);
 
-    pending_symbols = std::move(syms);
-    num_pending_symbols = pending_symbols.size();
-    pending_symbols_cv.notify_one();
+    if (backpressure) {
+        queue_space_cv.wait(lock, [this]() {
+                return pending_frames.size() < queueStats.depth or
+                    not running or not backpressure; });
+    }
+
+    // The decoder cannot keep up, drop the oldest frames to
+    // bound the latency.
+    while (pending_frames.size() >= queueStats.depth) {
+        pending_frames.erase(pending_frames.begin());
+        queueStats.framesDropped++;
+    }
+
+    pending_frames.push_back(std::move(frame));
+    queueStats.framesPushed++;
+    queueStats.highWaterMark =
+        std::max(queueStats.highWaterMark, pending_frames.size());
+    pending_frames_cv.notify_one();
+}
+
+void OfdmDecoder::setQueueDepth(size_t depth)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    queueStats.depth = std::max<size_t>(depth, 1);
+    pending_frames.reserve(queueStats.depth);
+    queue_space_cv.notify_all();
+}
+
+void OfdmDecoder::setBackpressure(bool b)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    backpressure = b;
+    queue_space_cv.notify_all();
+}
+
+void OfdmDecoder::wakeUp()
+{
+    // Taking the mutex makes sure the waiting threads see running
+    { std::lock_guard<std::mutex> lock(mutex); }
+    pending_frames_cv.notify_all();
+    queue_space_cv.notify_all();
+}
+
+FrameQueueStats OfdmDecoder::getQueueStats() const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    return queueStats;
 }
 
 /**
  * handle symbol 0 as collected from the buffer
  */
-void OfdmDecoder::processPRS()
+void OfdmDecoder::processPRS(const SampleBuffer& symbol)
 {
     PROFILE(ProcessPRS);
     memcpy (fft_buffer,
-            pending_symbols[0].data(),
+            symbol.data(),
             params.T_u * sizeof(DSPCOMPLEX));
     fft_handler.do_FFT ();
     /**
@@ -159,62 +270,86 @@ void OfdmDecoder::processPRS()
         snrCount = 0;
     }
     /**
-     * we are now in the frequency domain, and we keep the carriers
-     * as coming from the FFT as phase reference.
+     * we are now in the frequency domain, and the carriers stay in
+     * fft_buffer as phase reference for the first data symbol.
      */
-    memcpy(phaseReference.data(), fft_buffer, params.T_u * sizeof (DSPCOMPLEX));
+
+    /**
+     * The mode and which MSC symbols we have to decode are decided
+     * once per frame, the CIFs are aligned on the frame.
+     */
+    ficOnly = ficOnlyRequested;
+    constellation = not ficOnly and constellationRequested;
+    if (not ficOnly) {
+        mscHandler.getSymbolSelection(selectedSymbols, params.L);
+    }
+    if (constellation) {
+        constellationPoints.clear();
+        constellationPoints.reserve(
+                (params.L-1) * params.K / constellationDecimation);
+    }
+}
+
+/**
+ * The FIC is always decoded, the MSC symbols only when they carry
+ * CUs of a selected subchannel.
+ */
+bool OfdmDecoder::needsDemodulation(int32_t sym_ix) const
+{
+    return sym_ix < 4 or selectedSymbols[sym_ix];
+}
+
+/**
+ * Symbols without selected CUs are not transformed, unless the next
+ * symbol needs them as phase reference.
+ */
+bool OfdmDecoder::needsTransform(int32_t sym_ix) const
+{
+    if (ficOnly) {
+        return sym_ix < 4;
+    }
+
+    return needsDemodulation(sym_ix) or
+        (sym_ix + 1 < params.L and needsDemodulation(sym_ix + 1));
 }
 
 /**
- * For the other symbols, the first step is to go from
- * time to frequency domain, to get the carriers.
+ * For the other symbols, the carriers were already taken from
+ * time to frequency domain by the batch FFT.
  *
  * \brief decodeDataSymbol
- * do the transforms and hand over the result to the fichandler or mschandler
+ * demodulate the carriers and hand over the result to the fichandler or mschandler
  */
-void OfdmDecoder::decodeDataSymbol(int32_t sym_ix)
+void OfdmDecoder::decodeDataSymbol(const DSPCOMPLEX *spectrum,
+        const DSPCOMPLEX *reference, int32_t sym_ix)
 {
+    if (ficOnly and sym_ix >= 4) {
+        return;
+    }
+
     PROFILE(ProcessSymbol);
-    memcpy (fft_buffer,
-            pending_symbols[sym_ix].data() + T_g,
-            params.T_u * sizeof (DSPCOMPLEX));
-    //fftlabel:
-    /**
-     * first step: do the FFT
-     */
-    fft_handler.do_FFT();
 
-    /**
-     * a little optimization: we do not interchange the
-     * positive/negative frequencies to their right positions.
-     * The de-interleaving understands this
-     */
+    // Symbols without selected CUs are not demodulated
+    if (not needsDemodulation(sym_ix)) {
+        mscHandler.processMscBlock(nullptr, sym_ix);
+        PROFILE(SymbolSkipped);
+        return;
+    }
 
-    PROFILE(Deinterleaver);
     /**
-     * Note that from here on, we are only interested in the
-     * K useful carriers of the FFT output
+     * decoding is computing the phase difference between
+     * carriers with the same index in subsequent symbols.
+     * The carrier of a symbols is the reference for the carrier
+     * on the same position in the next symbols
      */
-    for (int16_t i = 0; i < params.K; i ++) {
-        int16_t index = interleaver.mapIn(i);
-        if (index < 0)
-            index += params.T_u;
-        /**
-         * decoding is computing the phase difference between
-         * carriers with the same index in subsequent symbols.
-         * The carrier of a symbols is the reference for the carrier
-         * on the same position in the next symbols
-         */
-        const DSPCOMPLEX r1 = fft_buffer[index] * conj (phaseReference[index]);
-        phaseReference[index] = fft_buffer[index];
-        const DSPFLOAT ab1 = 127.0f / l1_norm(r1);
-        /// split the real and the imaginary part and scale it
-
-        ibits[i]            = -real (r1) * ab1;
-        ibits[params.K + i] = -imag (r1) * ab1;
-
-        if (i % constellationDecimation == 0) {
-            constellationPoints.push_back(r1);
+    PROFILE(Deinterleaver);
+    demodulator.demodulate(spectrum, reference, ibits.data());
+
+    if (constellation) {
+        for (int32_t i = 0; i < params.K; i += constellationDecimation) {
+            const int32_t index = demodulator.carrierIndex(i);
+            constellationPoints.push_back(
+                    spectrum[index] * conj(reference[index]));
         }
     }
 
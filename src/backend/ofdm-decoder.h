@@ -33,10 +33,22 @@
 #include <cstdint>
 #include "fft.h"
 #include "dab-constants.h"
-#include "freq-interleaver.h"
+#include "differential-demod.h"
 #include "radio-controller.h"
 #include "fic-handler.h"
 #include "msc-handler.h"
+#include "frame-pool.h"
+
+struct FrameQueueStats {
+    // Configured number of frames that can wait for the decoder
+    size_t depth = 0;
+    // Largest number of frames that were waiting at the same time
+    size_t highWaterMark = 0;
+    uint64_t framesPushed = 0;
+    uint64_t framesDecoded = 0;
+    // Frames that were discarded because the queue was full
+    uint64_t framesDropped = 0;
+};
 
 class OfdmDecoder
 {
@@ -45,10 +57,31 @@ class OfdmDecoder
                 const DABParams& p,
                 RadioControllerInterface& mr,
                 FicHandler& ficHandler,
-                MscHandler& mscHandler);
+                MscHandler& mscHandler,
+                size_t queueDepth,
+                bool singleThreaded = false,
+                size_t fftThreads = 1);
         ~OfdmDecoder();
-        void    pushAllSymbols(std::vector<std::vector<DSPCOMPLEX> >&& sym);
+
+        /* Queue a frame for decoding. When the queue is full, the oldest
+         * waiting frame is dropped, or with backpressure, the call waits
+         * until the decoder has taken a frame.
+         * Single-threaded, the frame is decoded before the call returns. */
+        void    pushAllSymbols(FrameRef frame);
         void    reset();
+
+        void    setQueueDepth(size_t depth);
+        void    setBackpressure(bool backpressure);
+        FrameQueueStats getQueueStats(void) const;
+
+        /* In FIC-only mode, only the PRS and the FIC symbols are
+         * processed, the MSC is ignored and no constellation points
+         * are collected. Takes effect at the next frame. */
+        void    setFicOnly(bool ficOnly);
+
+        /* Collect the constellation points for onConstellationPoints.
+         * Takes effect at the next frame. */
+        void    setConstellationEnabled(bool enabled);
     private:
         int16_t get_snr(DSPCOMPLEX *, uint8_t method);
 
@@ -58,23 +91,49 @@ class OfdmDecoder
         MscHandler& mscHandler;
         std::atomic<bool> running = ATOMIC_VAR_INIT(false);
 
-        std::condition_variable pending_symbols_cv;
-        std::mutex mutex;
-        int num_pending_symbols = 0;
-        std::vector<std::vector<DSPCOMPLEX> > pending_symbols;
+        std::condition_variable pending_frames_cv;
+        std::condition_variable queue_space_cv;
+        mutable std::mutex mutex;
+        // Oldest frame first, never holds more than queueStats.depth frames
+        std::vector<FrameRef> pending_frames;
+        FrameQueueStats queueStats;
+        bool backpressure = false;
 
+        const bool singleThreaded;
         std::thread thread;
         void workerthread(void);
-        void processPRS();
-        void decodeDataSymbol(int32_t n);
+        void wakeUp(void);
+        void decodeFrame(FrameRef frame);
+        void processPRS(const SampleBuffer& symbol);
+        void decodeDataSymbol(const DSPCOMPLEX *spectrum,
+                const DSPCOMPLEX *reference, int32_t n);
 
         int32_t T_g;
-        std::vector<DSPCOMPLEX> phaseReference;
         fft::Forward fft_handler;
+        // Spectrum of the PRS, phase reference of the first data symbol
         DSPCOMPLEX   *fft_buffer;
-        FrequencyInterleaver interleaver;
+        // Transforms the data symbols of a frame in place
+        fft::BatchForward fft_batch;
+        // Deinterleaves the carriers of a symbol to soft bits
+        DifferentialDemodulator demodulator;
 
         std::vector<softbit_t> ibits;
+
+        // OFDM symbols of the current frame that carry a selected
+        // subchannel, refreshed from the MscHandler at every frame.
+        std::vector<bool> selectedSymbols;
+        bool needsDemodulation(int32_t sym_ix) const;
+
+        // Data symbols to transform in the current frame, indexed from 0
+        // for symbol 1
+        std::vector<bool> transformedSymbols;
+        bool needsTransform(int32_t sym_ix) const;
+
+        std::atomic<bool> ficOnlyRequested = ATOMIC_VAR_INIT(false);
+        bool ficOnly = false; // Latched for the current frame
+        std::atomic<bool> constellationRequested = ATOMIC_VAR_INIT(true);
+        bool constellation = false; // Latched for the current frame
+
         int16_t snrCount = 0;
         float snr = 0;
 
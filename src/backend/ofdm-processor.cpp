@@ -30,13 +30,34 @@
  *
  */
 
+#include <algorithm>
 #include <cstddef>
 #include "ofdm-processor.h"
 #include "various/profiling.h"
 #include <iostream>
+#include <stdexcept>
 //
 #define SEARCH_RANGE        (2 * 36)
 #define CORRELATION_LENGTH  24
+//  Weight of a sample in the long term signal level sLevel
+static const double LEVEL_ALPHA = 0.00001;
+//  How long to wait for input samples before checking if we still run
+#define INPUT_WAIT_TIMEOUT_MS   20
+
+/**
+ * Adds the phase differences between the samples of the cyclic prefix
+ * and the corresponding samples at the end of the symbol to corr.
+ * With FixedT_u and FixedT_s, the loop bounds are known at compile time.
+ */
+template<int32_t FixedT_u, int32_t FixedT_s>
+static void correlatePrefix(const DSPCOMPLEX *buf,
+        int32_t t_u, int32_t t_s, DSPCOMPLEX& corr)
+{
+    const int32_t T_u = FixedT_u ? FixedT_u : t_u;
+    const int32_t T_s = FixedT_s ? FixedT_s : t_s;
+    for (int32_t i = T_u; i < T_s; i ++)
+        corr += buf[i] * conj(buf[i - T_u]);
+}
 
 /**
   * \brief OFDMProcessor
@@ -63,14 +84,23 @@ OFDMProcessor::OFDMProcessor(
     input(inputInterface),
     params(params),
     ficHandler(fic),
-    tiiDecoder(params, ri),
+    // One frame being filled, one being decoded, one for the TII decoder
+    // and the frames waiting in the queue.
+    framePool(params, rro.frameQueueDepth + 3),
+    tiiDecoder(params, ri, rro.singleThreaded),
+    singleThreaded(rro.singleThreaded),
     T_null(params.T_null),
     T_u(params.T_u),
     T_s(params.T_s),
     T_F(params.T_F),
-    oscillatorTable(INPUT_RATE),
+    levelTracker(LEVEL_ALPHA),
+    nullDetector(LEVEL_ALPHA),
+    syncBlockInput(NullDetector::blockSize),
+    syncBlock(NullDetector::blockSize),
     phaseRef(params, rro.fftPlacementMethod),
-    ofdmDecoder(params, ri, fic, msc),
+    ofdmDecoder(params, ri, fic, msc, rro.frameQueueDepth, rro.singleThreaded,
+            rro.fftThreads),
+    signalDetector(params),
     fft_handler(params.T_u),
     fft_buffer(fft_handler.getVector())
 {
@@ -89,10 +119,6 @@ OFDMProcessor::OFDMProcessor(
      * the decoded symbols
      */
 
-    for (int i = 0; i < INPUT_RATE; i ++)
-        oscillatorTable[i] = DSPCOMPLEX(cos(2.0 * M_PI * i / INPUT_RATE),
-                sin(2.0 * M_PI * i / INPUT_RATE));
-
     //  and for the correlation
     refArg.resize(CORRELATION_LENGTH);
     for (int i = 0; i < CORRELATION_LENGTH; i ++)  {
@@ -101,6 +127,12 @@ OFDMProcessor::OFDMProcessor(
     }
 
     correlationVector.resize(SEARCH_RANGE + CORRELATION_LENGTH);
+
+    //  At most the rest of a block, and what was left over before
+    pushedBackSamples.reserve(2 * NullDetector::blockSize);
+
+    ofdmDecoder.setBackpressure(rro.frameQueueBackpressure);
+    setDiagnosticSubscriptions(ri.getDiagnosticSubscriptions());
 }
 
 OFDMProcessor::~OFDMProcessor()
@@ -123,80 +155,81 @@ void OFDMProcessor::restart()
 
     coarseCorrector    = 0;
     fineCorrector      = 0;
-    syncBufferIndex    = 0;
     sLevel             = 0;
-    localPhase         = 0;
+    frequencyShifter.reset();
+    pushedBackSamples.clear();
+    pushedBackIndex    = 0;
     input.restart();
     running            = true;
-    threadHandle       = std::thread(&OFDMProcessor::run, this);
+    if (not singleThreaded) {
+        threadHandle   = std::thread(&OFDMProcessor::run, this);
+    }
+}
+
+void OFDMProcessor::runSingleThreaded(const std::function<bool()>& keep_running)
+{
+    if (not singleThreaded) {
+        throw std::logic_error("OFDMProcessor not configured single-threaded");
+    }
+
+    keepRunning = keep_running;
+    running = true;
+    run();
+    keepRunning = nullptr;
 }
 
 class InputFailure { };
 class NotRunningAnymore { };
 
 /**
- * \brief getSample
- * Profiling shows that getting a sample, together
- * with the frequency shift, is a real performance killer.
- * we therefore distinguish between getting a single sample
- * and getting a vector full of samples
+ * \brief checkpoint
+ * Between two frames, let the caller of runSingleThreaded decide
+ * whether to go on. Stopping makes the next readSamples throw.
  */
-
-DSPCOMPLEX OFDMProcessor::getSample(int32_t phase)
+void OFDMProcessor::checkpoint()
 {
-    DSPCOMPLEX temp;
-    if (!running)
-        throw NotRunningAnymore();
-    /// bufferContent is an indicator for the value of ...->Samples ()
-    if (bufferContent == 0) {
-        bufferContent = input.getSamplesToRead ();
-        while ((bufferContent == 0) && running) {
-            if (not input.is_ok()) {
-                throw InputFailure();
-            }
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            bufferContent = input.getSamplesToRead ();
-        }
+    if (keepRunning and not keepRunning()) {
+        running = false;
     }
+}
 
+/**
+ * \brief readSamples
+ * Read n samples from the input, without any processing, waiting
+ * until they are available. The samples pushed back by the null
+ * detection come first.
+ */
+int32_t OFDMProcessor::readSamples(DSPCOMPLEX *v, int32_t n)
+{
     if (!running)
         throw NotRunningAnymore();
-    //
-    //  so here, bufferContent > 0
-    input.getSamples (&temp, 1);
-    bufferContent --;
 
-    //
-    //  OK, we have a sample!!
-    //  first: adjust frequency. We need Hz accuracy
-    localPhase  -= phase;
-    localPhase  = (localPhase + INPUT_RATE) % INPUT_RATE;
-    temp        *= oscillatorTable[localPhase];
-    sLevel      = 0.00001 * l1_norm(temp) + (1 - 0.00001) * sLevel;
-#define N   5
-    sampleCnt   ++;
-    if (++ sampleCnt > INPUT_RATE / N) {
-        radioInterface.onFrequencyCorrectorChange(
-                fineCorrector, coarseCorrector);
-        sampleCnt = 0;
+    const int32_t pushedBack = std::min<int32_t>(n,
+            pushedBackSamples.size() - pushedBackIndex);
+    if (pushedBack > 0) {
+        std::copy(pushedBackSamples.begin() + pushedBackIndex,
+                pushedBackSamples.begin() + pushedBackIndex + pushedBack, v);
+        pushedBackIndex += pushedBack;
+        if (pushedBackIndex == pushedBackSamples.size()) {
+            pushedBackSamples.clear();
+            pushedBackIndex = 0;
+        }
+        v += pushedBack;
+        n -= pushedBack;
+        if (n == 0)
+            return pushedBack;
     }
-    return temp;
-}
-
-void OFDMProcessor::getSamples(DSPCOMPLEX *v, int16_t n, int32_t phase)
-{
-    int32_t     i;
 
-    if (!running)
-        throw NotRunningAnymore();
     if (n > bufferContent) {
+        //  The input wakes us up when it has new samples, the timeout
+        //  is for checking running and the input state.
         bufferContent = input.getSamplesToRead ();
         while ((bufferContent < n) && running) {
             if (not input.is_ok()) {
                 throw InputFailure();
             }
-            std::this_thread::sleep_for(std::chrono::microseconds(10));
-            bufferContent = input.getSamplesToRead();
+            bufferContent = input.waitForSamples(n,
+                    std::chrono::milliseconds(INPUT_WAIT_TIMEOUT_MS));
         }
     }
     if (!running)
@@ -205,16 +238,25 @@ void OFDMProcessor::getSamples(DSPCOMPLEX *v, int16_t n, int32_t phase)
     //  so here, bufferContent >= n
     n = input.getSamples (v, n);
     bufferContent -= n;
+    return pushedBack + n;
+}
 
-    //  OK, we have samples!!
-    //  first: adjust frequency. We need Hz accuracy
-    for (i = 0; i < n; i ++) {
-        localPhase  -= phase;
-        localPhase   = (localPhase + INPUT_RATE) % INPUT_RATE;
-        v[i]    *= oscillatorTable[localPhase];
-        sLevel   = 0.00001 * l1_norm(v[i]) + (1 - 0.00001) * sLevel;
-    }
+/**
+ * \brief pushBackSamples
+ * Give back the last n samples returned by readSamples, they will be
+ * returned again by the next call.
+ */
+void OFDMProcessor::pushBackSamples(const DSPCOMPLEX *v, int32_t n)
+{
+    pushedBackSamples.erase(pushedBackSamples.begin(),
+            pushedBackSamples.begin() + pushedBackIndex);
+    pushedBackIndex = 0;
+    pushedBackSamples.insert(pushedBackSamples.begin(), v, v + n);
+}
 
+void OFDMProcessor::countSamples(int32_t n)
+{
+#define N   5
     sampleCnt += n;
     if (sampleCnt > INPUT_RATE / N) {
         radioInterface.onFrequencyCorrectorChange(
@@ -223,6 +265,86 @@ void OFDMProcessor::getSamples(DSPCOMPLEX *v, int16_t n, int32_t phase)
     }
 }
 
+void OFDMProcessor::getSamples(DSPCOMPLEX *v, int16_t n, int32_t phase)
+{
+    n = readSamples(v, n);
+
+    //  OK, we have samples!!
+    //  first: adjust frequency. We need Hz accuracy
+    //  Both are done on the whole block, see frequency-shifter.h
+    frequencyShifter.shift(v, n, phase);
+    sLevel = levelTracker.update(sLevel, v, n);
+
+    countSamples(n);
+}
+
+/**
+ * \brief findNull
+ * Look for the start or the end of the null symbol, block by block.
+ * On success, the samples after the edge are pushed back, so that
+ * reading continues right after it. Gives up after maxSamples samples,
+ * as the per sample loops did, the samples following are pushed back
+ * as well.
+ */
+bool OFDMProcessor::findNull(bool start, int32_t maxSamples, int32_t phase)
+{
+    int32_t counter = 0;
+    while (true) {
+        const int32_t n = readSamples(syncBlockInput.data(),
+                std::min(NullDetector::blockSize, maxSamples + 1 - counter));
+
+        std::copy(syncBlockInput.begin(), syncBlockInput.begin() + n,
+                syncBlock.begin());
+        frequencyShifter.shift(syncBlock.data(), n, phase);
+
+        bool found;
+        const int32_t consumed = start ?
+            nullDetector.findNullStart(syncBlock.data(), n, sLevel, found) :
+            nullDetector.findNullEnd(syncBlock.data(), n, sLevel, found);
+
+        if (consumed < n) {
+            pushBackSamples(&syncBlockInput[consumed], n - consumed);
+            frequencyShifter.rewind(n - consumed, phase);
+        }
+        countSamples(consumed);
+
+        counter += consumed;
+        if (found)
+            return true;
+        if (counter > maxSamples)
+            return false;
+    }
+}
+
+/**
+ * \brief detectSignal
+ * In scan mode, decide from the first samples whether the channel is
+ * worth synchronising on, see SignalDetector. Without a DAB signal, the
+ * scan is told at once rather than after several failed attempts.
+ */
+void OFDMProcessor::detectSignal()
+{
+    signalDetector.reset();
+    auto verdict = SignalDetector::Verdict::Undecided;
+    while (verdict == SignalDetector::Verdict::Undecided) {
+        getSamples(syncBlock.data(), T_u, 0);
+        verdict = signalDetector.process(syncBlock.data());
+    }
+
+    const char *verdictName =
+        verdict == SignalDetector::Verdict::Dab ? "DAB signal" :
+        verdict == SignalDetector::Verdict::NotDab ? "no DAB signal" : "empty";
+    std::clog << "ofdm-processor: " << "channel " << verdictName <<
+        " after " << signalDetector.getSamplesUsed() * 1000 / INPUT_RATE <<
+        " ms, band ratio " << signalDetector.getBandRatio() <<
+        " dB, null depth " << signalDetector.getNullDepth() << std::endl;
+
+    if (verdict != SignalDetector::Verdict::Dab) {
+        radioInterface.onSignalPresence(false);
+        scanMode = false;
+        attempts = 0;
+    }
+}
 
 /***
  *    \brief run
@@ -235,87 +357,59 @@ void OFDMProcessor::getSamples(DSPCOMPLEX *v, int16_t n, int32_t phase)
 void OFDMProcessor::run()
 {
     int32_t startIndex;
-    int32_t i;
-    int32_t counter;
-    float currentStrength;
-    constexpr int32_t syncBufferSize  = 32768;
-    constexpr int32_t syncBufferMask  = syncBufferSize - 1;
-    float envBuffer[syncBufferSize];
+    uint32_t subscribed;
 
-    std::vector<DSPCOMPLEX> ofdmBuffer(params.L * params.T_s);
-    std::vector<std::vector<DSPCOMPLEX> > allSymbols;
+    FrameRef frame;
 
     try {
 
+        if (scanMode) {
+            detectSignal();
+        }
+
         //Initing:
         /// first, we need samples to get a reasonable sLevel
         sLevel   = 0;
-        for (i = 0; i < T_F / 2; i ++) {
-            l1_norm(getSample (0));
+        for (int32_t i = 0; i < T_F / 2; i += NullDetector::blockSize) {
+            getSamples(syncBlock.data(),
+                    std::min(NullDetector::blockSize, T_F / 2 - i), 0);
         }
 notSynced:
         PROFILE(NotSynced);
+        checkpoint();
         if (scanMode && ++attempts > 5) {
             radioInterface.onSignalPresence(false);
             scanMode  = false;
             attempts  = 0;
         }
-        syncBufferIndex  = 0;
-        currentStrength  = 0;
-
-        //  read in T_s samples for a next attempt;
-        syncBufferIndex = 0;
-        currentStrength  = 0;
-        for (i = 0; i < 50; i ++) {
-            DSPCOMPLEX sample         = getSample (0);
-            envBuffer [syncBufferIndex]   = l1_norm(sample);
-            currentStrength           += envBuffer [syncBufferIndex];
-            syncBufferIndex ++;
-        }
+
+        //  read in 50 samples for a next attempt;
+        getSamples(syncBlock.data(), NullDetector::window, 0);
+        nullDetector.reset(syncBlock.data());
         /**
-         * We now have initial values for currentStrength (i.e. the sum
-         * over the last 50 samples) and sLevel, the long term average.
+         * We now have initial values for the sum over the last 50
+         * samples, kept by the nullDetector, and sLevel, the long term
+         * average.
          */
         //SyncOnNull:
         /**
          * here we start looking for the null level, i.e. a dip
          */
-        counter  = 0;
         radioInterface.onSyncChange(false);
-        while (currentStrength / 50  > 0.50 * sLevel) {
-            DSPCOMPLEX sample =
-                getSample (coarseCorrector + fineCorrector);
-            envBuffer [syncBufferIndex] = l1_norm(sample);
-            //  update the levels
-            currentStrength += envBuffer [syncBufferIndex] -
-                envBuffer [(syncBufferIndex - 50) & syncBufferMask];
-            syncBufferIndex = (syncBufferIndex + 1) & syncBufferMask;
-            counter ++;
-            if (counter > T_F) { // hopeless
-                //           fprintf (stderr, "%f %f\n", currentStrength / 50, sLevel);
-                goto notSynced;
-            }
+        if (not findNull(true, T_F, coarseCorrector + fineCorrector)) {
+            // hopeless
+            goto notSynced;
         }
         /**
          * It seemed we found a dip that started app 65/100 * 50 samples earlier.
          * We now start looking for the end of the null period.
          */
-        counter  = 0;
         //SyncOnEndNull:
         PROFILE(SyncOnEndNull);
-        while (currentStrength / 50 < 0.75 * sLevel) {
-            DSPCOMPLEX sample = getSample (coarseCorrector + fineCorrector);
-            envBuffer [syncBufferIndex] = l1_norm(sample);
-            //  update the levels
-            currentStrength += envBuffer [syncBufferIndex] -
-                envBuffer [(syncBufferIndex - 50) & syncBufferMask];
-            syncBufferIndex = (syncBufferIndex + 1) & syncBufferMask;
-            counter   ++;
-            //
-            if (counter > T_null + 50) { // hopeless
-                std::clog << "ofdm-processor: " << "SyncOnEndNull failed" << std::endl;
-                goto notSynced;
-            }
+        if (not findNull(false, T_null + 50, coarseCorrector + fineCorrector)) {
+            // hopeless
+            std::clog << "ofdm-processor: " << "SyncOnEndNull failed" << std::endl;
+            goto notSynced;
         }
         /**
          * The end of the null period is identified, probably about 40
@@ -323,6 +417,9 @@ notSynced:
          */
 SyncOnPhase:
         PROFILE(SyncOnPhase);
+        checkpoint();
+        // The diagnostic streams to send for this frame
+        subscribed = diagnostics;
         /**
          * We now have to find the exact first sample of the non-null period.
          * We use a correlation that will find the first sample after the
@@ -333,7 +430,14 @@ SyncOnPhase:
          * now read in Tu samples. The precise number is not really important
          * as long as we can be sure that the first sample to be identified
          * is part of the samples read.
+         *
+         * The samples go straight into symbol 0 of a frame from the pool,
+         * which we keep until the frame is complete.
          */
+        if (not frame) {
+            frame = framePool.acquire();
+        }
+        SampleBuffer& ofdmBuffer = frame->prs;
         getSamples(ofdmBuffer.data(), T_u, coarseCorrector + fineCorrector);
         //
         /// and then, call upon the phase synchronizer to verify/compute
@@ -341,8 +445,11 @@ SyncOnPhase:
         startIndex = phaseRef.findIndex(ofdmBuffer.data(),
                 impulseResponseBuffer);
         PROFILE(FindIndex);
-        radioInterface.onNewImpulseResponse(std::move(impulseResponseBuffer));
-        impulseResponseBuffer.clear();
+        // Without subscriber, the buffer is kept for the next frame
+        if (subscribed & DIAGNOSTIC_IMPULSE_RESPONSE) {
+            radioInterface.onNewImpulseResponse(std::move(impulseResponseBuffer));
+            impulseResponseBuffer.clear();
+        }
 
         if (startIndex < 0) { // no sync, try again
             std::clog << "ofdm-processor: " << "SyncOnPhase failed" << std::endl;
@@ -379,12 +486,6 @@ SyncOnPhase:
             rro = receiver_options;
         }
 
-        std::vector<complexf> prs;
-        if (rro.decodeTII) {
-            prs.resize(T_u);
-            std::copy(ofdmBuffer.begin(), ofdmBuffer.begin() + T_u, prs.begin());
-        }
-
         //  Here we look only at the PRS when we need a coarse
         //  frequency synchronization.
         //  The width is limited to 2 * 35 kHz (i.e. positive and negative)
@@ -417,10 +518,6 @@ SyncOnPhase:
             lastValidCoarseCorrector = coarseCorrector;
         }
 
-        allSymbols.resize(params.L);
-        allSymbols[0] = move(ofdmBuffer);
-        ofdmBuffer.resize(params.L * params.T_s);
-
         /**
          * after symbol 0, we will just read in the other (params.L - 1) symbols
          */
@@ -434,15 +531,19 @@ SyncOnPhase:
          */
         DSPCOMPLEX FreqCorr = DSPCOMPLEX(0, 0);
         for (int sym = 1; sym < params.L; sym ++) {
-            auto& buf = allSymbols[sym];
-            buf.resize(T_s);
-            getSamples(buf.data(), T_s, coarseCorrector + fineCorrector);
-            for (int i = T_u; i < T_s; i ++)
-                FreqCorr += buf[i] * conj(buf[i - T_u]);
+            DSPCOMPLEX *buf = frame->dataSymbol(sym);
+            getSamples(buf, T_s, coarseCorrector + fineCorrector);
+            if (params.dabMode == 1) {
+                correlatePrefix<DABModeI::T_u, DABModeI::T_s>(
+                        buf, T_u, T_s, FreqCorr);
+            }
+            else {
+                correlatePrefix<0, 0>(buf, T_u, T_s, FreqCorr);
+            }
         }
 
         PROFILE(PushAllSymbols);
-        ofdmDecoder.pushAllSymbols(move(allSymbols));
+        ofdmDecoder.pushAllSymbols(frame);
 
         //NewOffset:
         /// we integrate the newly found frequency error with the
@@ -454,27 +555,29 @@ SyncOnPhase:
          * OK,  here we are at the end of the frame
          * Assume everything went well and skip T_null samples
          */
-        syncBufferIndex  = 0;
-        currentStrength  = 0;
-
         PROFILE(DecodeTII);
         // The NULL is interesting to save because it carries the TII.
-        std::vector<DSPCOMPLEX> nullSymbol(T_null);
+        // The OfdmDecoder does not use it, we can still write to the frame.
+        SampleBuffer& nullSymbol = frame->nullSymbol;
         getSamples(nullSymbol.data(), T_null, coarseCorrector + fineCorrector);
         if (rro.decodeTII) {
-            tiiDecoder.pushSymbols(nullSymbol, prs);
+            tiiDecoder.pushSymbols(frame);
         }
 
         PROFILE(OnNewNull);
-        radioInterface.onNewNullSymbol(std::move(nullSymbol));
+        if (subscribed & DIAGNOSTIC_NULL_SYMBOL) {
+            radioInterface.onNewNullSymbol(
+                    std::vector<DSPCOMPLEX>(nullSymbol.begin(), nullSymbol.end()));
+        }
+
+        // The frame now belongs to the decoders
+        frame.reset();
 
         /**
          * The first sample to be found for the next frame should be T_g
          * samples ahead
          * Here we just check the fineCorrector
          */
-        counter  = 0;
-
         if (fineCorrector > params.carrierDiff / 2) {
             coarseCorrector += params.carrierDiff;
             fineCorrector -= params.carrierDiff;
@@ -521,6 +624,8 @@ void OFDMProcessor::setReceiverOptions(const RadioReceiverOptions rro)
     bool need_reset = (receiver_options.disableCoarseCorrector != rro.disableCoarseCorrector);
     receiver_options = rro;
     phaseRef.selectFFTWindowPlacement(rro.fftPlacementMethod);
+    ofdmDecoder.setQueueDepth(rro.frameQueueDepth);
+    ofdmDecoder.setBackpressure(rro.frameQueueBackpressure);
     lock.unlock();
 
     if (need_reset) {
@@ -531,6 +636,29 @@ void OFDMProcessor::setReceiverOptions(const RadioReceiverOptions rro)
 void OFDMProcessor::set_scanMode(bool b)
 {
     scanMode = b;
+    attempts = 0;
+}
+
+void OFDMProcessor::setFicOnly(bool b)
+{
+    ofdmDecoder.setFicOnly(b);
+}
+
+void OFDMProcessor::setDiagnosticSubscriptions(uint32_t streams)
+{
+    diagnostics = streams;
+    ofdmDecoder.setConstellationEnabled(streams & DIAGNOSTIC_CONSTELLATION);
+    input.setSpectrumSamplesEnabled(streams & DIAGNOSTIC_SPECTRUM);
+}
+
+uint32_t OFDMProcessor::getDiagnosticSubscriptions() const
+{
+    return diagnostics;
+}
+
+FrameQueueStats OFDMProcessor::getFrameQueueStats() const
+{
+    return ofdmDecoder.getQueueStats();
 }
 
 #define RANGE 36
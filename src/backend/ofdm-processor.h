@@ -36,9 +36,13 @@
 #include "dab-constants.h"
 #include <thread>
 #include <atomic>
+#include <functional>
 #include <mutex>
 #include <vector>
 #include "phasereference.h"
+#include "channel-scan.h"
+#include "frequency-shifter.h"
+#include "null-detector.h"
 #include "ofdm-decoder.h"
 #include "tii-decoder.h"
 #include "virtual_input.h"
@@ -60,28 +64,46 @@ class OFDMProcessor
                 RadioReceiverOptions rro);
         ~OFDMProcessor();
 
-        /* Start or restart the OFDMProcessor */
+        /* Start or restart the OFDMProcessor. Single-threaded, this
+         * only resets the state, runSingleThreaded does the work. */
         void restart();
 
+        /* Process the input on the calling thread until keepRunning,
+         * called between two frames, returns false or the input fails. */
+        void runSingleThreaded(const std::function<bool()>& keepRunning);
+
         void stop();
         void resetCoarseCorrector();
         void setReceiverOptions(const RadioReceiverOptions rro);
         void set_scanMode(bool);
+        void setFicOnly(bool);
+
+        /* Which of the diagnostic streams to compute, a mask of
+         * DiagnosticStream values. Takes effect at the next frame. */
+        void setDiagnosticSubscriptions(uint32_t streams);
+        uint32_t getDiagnosticSubscriptions(void) const;
+        FrameQueueStats getFrameQueueStats(void) const;
 
     private:
         std::mutex receiver_options_mutex;
         RadioReceiverOptions receiver_options;
 
         std::thread threadHandle;
-        int32_t syncBufferIndex = 0;
         RadioControllerInterface& radioInterface;
         InputInterface& input;
         const DABParams& params;
         FicHandler& ficHandler;
         std::vector<float> impulseResponseBuffer;
+
+        // Must outlive the decoders that hold frames
+        FramePool framePool;
         TIIDecoder tiiDecoder;
 
         std::atomic<bool> running = ATOMIC_VAR_INIT(false);
+        std::atomic<uint32_t> diagnostics = ATOMIC_VAR_INIT(DIAGNOSTIC_ALL);
+        const bool singleThreaded;
+        std::function<bool()> keepRunning;
+        void checkpoint(void);
 
         int32_t T_null;
         int32_t T_u;
@@ -89,9 +111,20 @@ class OFDMProcessor
         int32_t T_F;
         int32_t coarseSyncCounter = 0;
 
-        std::vector<DSPCOMPLEX> oscillatorTable;
+        FrequencyShifter frequencyShifter;
+        const LevelTracker levelTracker;
+        NullDetector nullDetector;
+
+        // Samples read from the input while looking for the null symbol,
+        // but not consumed. They are read again before the input, and
+        // are not frequency shifted yet.
+        std::vector<DSPCOMPLEX> pushedBackSamples;
+        size_t pushedBackIndex = 0;
 
-        int32_t localPhase = 0;
+        // The block the null detection is working on, as read from the
+        // input and frequency shifted
+        std::vector<DSPCOMPLEX> syncBlockInput;
+        std::vector<DSPCOMPLEX> syncBlock;
 
         float sLevel = 0;
         int32_t sampleCnt = 0;
@@ -109,14 +142,19 @@ class OFDMProcessor
 
         bool scanMode = false;
         int attempts = 0;
+        SignalDetector signalDetector;
 
         int32_t bufferContent = 0;
 
         fft::Forward fft_handler;
         DSPCOMPLEX *fft_buffer; // of size T_u
 
-        DSPCOMPLEX getSample(int32_t);
+        int32_t readSamples(DSPCOMPLEX *, int32_t);
+        void pushBackSamples(const DSPCOMPLEX *, int32_t);
+        void countSamples(int32_t);
         void getSamples(DSPCOMPLEX *, int16_t, int32_t);
+        bool findNull(bool start, int32_t maxSamples, int32_t phase);
+        void detectSignal(void);
         void run(void);
         int16_t processPRS(DSPCOMPLEX *v, const FreqsyncMethod& freqsyncMethod);
         int16_t getMiddle(DSPCOMPLEX *);
@@ -20,7 +20,9 @@
  *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  *
  */
+#include    <stdexcept>
 #include    "protTables.h"
+#include    "protection.h"
 
 static const
 int8_t  p_codes[24][32] = {
@@ -55,3 +57,36 @@ const int8_t *getPCodes(int16_t x)
     return p_codes[x];
 }
 
+
+std::vector<uint32_t> buildDepunctureTable(const PunctureProfile& profile)
+{
+    std::vector<uint32_t> table;
+    uint32_t position = 0;
+
+    for (const auto& block : profile) {
+        const int16_t L = block.first;
+        const int8_t *PI = block.second;
+
+        if (L > 0 && PI == nullptr) {
+            throw std::logic_error("Invalid usage of NULL puncturing vector");
+        }
+
+        for (int16_t i = 0; i < L; i ++) {
+            for (int16_t j = 0; j < 128; j ++) {
+                if (PI[j % 32] != 0) {
+                    table.push_back(position);
+                }
+                position ++;
+            }
+        }
+    }
+
+    for (int16_t i = 0; i < 24; i ++) {
+        if (PI_X[i] != 0) {
+            table.push_back(position);
+        }
+        position ++;
+    }
+
+    return table;
+}
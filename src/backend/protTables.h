@@ -24,8 +24,19 @@
 #ifndef PROTTABLES
 #define PROTTABLES
 #include    <stdint.h>
+#include    <utility>
+#include    <vector>
 
 const int8_t *getPCodes(int16_t);
 
+//  A protection profile is a sequence of tuples (L, PI): L blocks
+//  of 128 bits, punctured per 32 bits according to PI
+using PunctureProfile = std::vector<std::pair<int16_t, const int8_t *>>;
+
+//  Entry k of the table is the position in the depunctured mother
+//  codeword of the k-th received soft bit. The final 24 bits of
+//  the encoder register, punctured according to PI_X, are included.
+std::vector<uint32_t> buildDepunctureTable(const PunctureProfile& profile);
+
 #endif
 
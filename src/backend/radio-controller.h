@@ -33,6 +33,7 @@
 #ifndef RADIOCONTROLLER_H
 #define RADIOCONTROLLER_H
 
+#include <chrono>
 #include <cstddef>
 #include <vector>
 #include <string>
@@ -79,6 +80,17 @@ struct mot_file_t {
 
 enum class message_level_t { Information, Error };
 
+/* The diagnostic streams, as a bit mask. The receiver only computes
+ * and copies the data of a stream while it is subscribed. */
+enum DiagnosticStream : uint32_t {
+    DIAGNOSTIC_NONE             = 0,
+    DIAGNOSTIC_IMPULSE_RESPONSE = 1 << 0, // onNewImpulseResponse
+    DIAGNOSTIC_NULL_SYMBOL      = 1 << 1, // onNewNullSymbol
+    DIAGNOSTIC_CONSTELLATION    = 1 << 2, // onConstellationPoints
+    DIAGNOSTIC_SPECTRUM         = 1 << 3, // InputInterface::getSpectrumSamples
+    DIAGNOSTIC_ALL              = 0xf,
+};
+
 /* Definition of the interface all radio controllers must implement.
  * The RadioController handles events that are common to all programmes
  * being listened to.
@@ -117,6 +129,11 @@ class RadioControllerInterface {
         /* For every FIB, tell if the CRC check passed. fib points to a bit-vector with 256 bits of FIB data  */
         virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) = 0;
 
+        /* The diagnostic streams the controller needs when the receiver
+         * is created, a mask of DiagnosticStream values. They can be
+         * changed later with RadioReceiver::setDiagnosticSubscriptions. */
+        virtual uint32_t getDiagnosticSubscriptions(void) const { return DIAGNOSTIC_ALL; }
+
         /* When a new channel impulse response vector was calculated */
         virtual void onNewImpulseResponse(std::vector<float>&& data) = 0;
 
@@ -231,7 +248,18 @@ public:
     virtual void reset(void) = 0;
     virtual int32_t getSamples(DSPCOMPLEX* buffer, int32_t size) = 0;
     virtual std::vector<DSPCOMPLEX> getSpectrumSamples(int size) = 0;
+
+    /* Keep a copy of the received samples for getSpectrumSamples. The
+     * inputs stop copying while this is disabled. */
+    virtual void setSpectrumSamplesEnabled(bool enabled) { (void)enabled; }
     virtual int32_t getSamplesToRead(void) = 0;
+
+    /* Block until at least n samples can be read, or until the timeout
+     * expires. Returns getSamplesToRead(), which is less than n after a
+     * timeout. */
+    virtual int32_t waitForSamples(int32_t n,
+            std::chrono::milliseconds timeout) = 0;
+
     virtual float setGain(int gain) = 0;
     virtual float getGain(void) const = 0;
     virtual int getGainCount(void) = 0;
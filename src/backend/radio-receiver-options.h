@@ -32,6 +32,9 @@
 
 #pragma once
 
+#include <cstddef>
+#include <string>
+
 // see OFDMProcessor::processPRS() for more information about these methods
 enum class FreqsyncMethod { GetMiddle = 0, CorrelatePRS = 1, PatternOfZeros = 2 };
 
@@ -81,5 +84,37 @@ struct RadioReceiverOptions {
     // Which method to use for the freqsyncmethod used in the coarse corrector.
     // Has no effect when coarse corrector is disabled.
     FreqsyncMethod freqsyncMethod = FreqsyncMethod::PatternOfZeros;
+
+    // Number of transmission frames that can wait for the OFDM decoder.
+    // When the decoder falls behind by more frames, the oldest are
+    // dropped and counted in the RadioReceiverStats.
+    size_t frameQueueDepth = 4;
+
+    // When the input can wait, e.g. when decoding a file offline, let the
+    // OFDMProcessor wait for the OFDM decoder instead of dropping frames.
+    bool frameQueueBackpressure = false;
+
+    // Run the whole chain, from the OFDMProcessor to the audio decoders,
+    // on the thread that calls RadioReceiver::runSingleThreaded(), so that
+    // a file always decodes the same way. Only read at construction, and
+    // only useful with an input that never needs to wait for samples.
+    bool singleThreaded = false;
+
+    // Number of threads that share the FFT of the data symbols of a frame,
+    // including the thread of the OfdmDecoder. Only read at construction.
+    size_t fftThreads = 1;
+
+    // Deliver the RadioControllerInterface callbacks on a thread of their
+    // own, through a lock-free queue of eventQueueDepth events, so that a
+    // slow controller does not hold up the demodulation. Events that do
+    // not fit in the queue are dropped and counted in the RadioReceiverStats.
+    // Only read at construction, and ignored with singleThreaded.
+    bool asyncEvents = false;
+    size_t eventQueueDepth = 1024;
+
+    // Directory in which RadioReceiver::useEnsembleCache() keeps the
+    // ensemble last received on every channel. The directory must exist.
+    // Empty disables the cache. Only read at construction.
+    std::string ensembleCacheDirectory;
 };
 
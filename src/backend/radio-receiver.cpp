@@ -69,11 +69,18 @@ RadioReceiver::RadioReceiver(
                 RadioReceiverOptions rro,
                 int transmission_mode) :
     params(transmission_mode),
-    mscHandler(params, false),
-    ficHandler(rci),
+    ensembleCache(rro.ensembleCacheDirectory.empty() ? nullptr :
+            new EnsembleCache(rro.ensembleCacheDirectory)),
+    timeRestart(chrono::steady_clock::now()),
+    asyncController(rro.asyncEvents and not rro.singleThreaded ?
+            new AsyncRadioController(rci, rro.eventQueueDepth) : nullptr),
+    controller(asyncController ?
+            static_cast<RadioControllerInterface&>(*asyncController) : rci),
+    mscHandler(params, false, rro.singleThreaded),
+    ficHandler(controller),
     ofdmProcessor(input,
         params,
-        rci,
+        controller,
         mscHandler,
         ficHandler,
         rro)
@@ -81,7 +88,15 @@ RadioReceiver::RadioReceiver(
 
 void RadioReceiver::restart(bool doScan)
 {
+    // The input might be tuned to another channel from now on
+    saveEnsembleCache();
+    cacheChannel.clear();
+    ensemblePreloaded = false;
+    timeRestart = chrono::steady_clock::now();
+    timeToPlay = -1;
+
     ofdmProcessor.set_scanMode(doScan);
+    ofdmProcessor.setFicOnly(doScan);
     mscHandler.stopProcessing();
     ficHandler.clearEnsemble();
     ofdmProcessor.restart();
@@ -89,17 +104,67 @@ void RadioReceiver::restart(bool doScan)
 
 void RadioReceiver::restart_decoder()
 {
+    saveEnsembleCache();
+    ensemblePreloaded = false;
     mscHandler.stopProcessing();
     ficHandler.clearEnsemble();
 }
 
 void RadioReceiver::stop()
 {
+    saveEnsembleCache();
+    cacheChannel.clear();
     ofdmProcessor.stop();
     mscHandler.stopProcessing();
     ficHandler.clearEnsemble();
 }
 
+bool RadioReceiver::useEnsembleCache(const std::string& channel, bool preload)
+{
+    if (not ensembleCache) {
+        return false;
+    }
+
+    cacheChannel = channel;
+
+    CachedEnsemble ensemble;
+    if (preload and ensembleCache->load(channel, ensemble)) {
+        ficHandler.fibProcessor.preloadEnsemble(ensemble);
+        ensemblePreloaded = true;
+    }
+    return ensemblePreloaded;
+}
+
+bool RadioReceiver::saveEnsembleCache()
+{
+    if (not ensembleCache or cacheChannel.empty()) {
+        return false;
+    }
+
+    // Half confirmed, the cache already has the ensemble the preload
+    // came from
+    if (ficHandler.fibProcessor.isPreloadPending()) {
+        return false;
+    }
+
+    const auto ensemble = ficHandler.fibProcessor.getCachedEnsemble();
+    if (ensemble.ensembleId == 0 or ensemble.services.empty()) {
+        return false;
+    }
+
+    if (not ensembleCache->save(cacheChannel, ensemble)) {
+        clog << "Could not save the ensemble of channel " << cacheChannel <<
+            " to the cache" << endl;
+        return false;
+    }
+    return true;
+}
+
+void RadioReceiver::runSingleThreaded(const std::function<bool()>& keepRunning)
+{
+    ofdmProcessor.runSingleThreaded(keepRunning);
+}
+
 void RadioReceiver::setReceiverOptions(const RadioReceiverOptions rro)
 {
     string fsm;
@@ -113,10 +178,26 @@ void RadioReceiver::setReceiverOptions(const RadioReceiverOptions rro)
         "TII: " << rro.decodeTII <<
         " disable coarse corr: " << rro.disableCoarseCorrector <<
         " freqsync: " << fsm <<
-        " fft placement: " << fftPlacementMethodToString(rro.fftPlacementMethod) << endl;
+        " fft placement: " << fftPlacementMethodToString(rro.fftPlacementMethod) <<
+        " frame queue depth: " << rro.frameQueueDepth << endl;
     ofdmProcessor.setReceiverOptions(rro);
 }
 
+void RadioReceiver::setFicOnly(bool ficOnly)
+{
+    ofdmProcessor.setFicOnly(ficOnly);
+}
+
+void RadioReceiver::setDiagnosticSubscriptions(uint32_t streams)
+{
+    ofdmProcessor.setDiagnosticSubscriptions(streams);
+}
+
+uint32_t RadioReceiver::getDiagnosticSubscriptions() const
+{
+    return ofdmProcessor.getDiagnosticSubscriptions();
+}
+
 bool RadioReceiver::playSingleProgramme(ProgrammeHandlerInterface& handler,
         const std::string& dumpFileName, const Service& s)
 {
@@ -143,6 +224,16 @@ bool RadioReceiver::removeServiceToDecode(const Service& s)
     return false;
 }
 
+bool RadioReceiver::removeServiceToDecode(const ProgrammeHandlerInterface& handler)
+{
+    return mscHandler.removeSubchannel(handler);
+}
+
+void RadioReceiver::drainDecoders(void)
+{
+    mscHandler.drain();
+}
+
 bool RadioReceiver::playProgramme(ProgrammeHandlerInterface& handler,
         const Service& s, const std::string& dumpFileName, bool unique)
 {
@@ -160,6 +251,12 @@ bool RadioReceiver::playProgramme(ProgrammeHandlerInterface& handler,
                     sc.audioType() == AudioServiceComponentType::DABPlus) {
                     mscHandler.addSubchannel(
                             handler, sc.audioType(), dumpFileName, subch);
+                    ofdmProcessor.setFicOnly(false);
+
+                    if (timeToPlay < 0) {
+                        timeToPlay = chrono::duration_cast<chrono::milliseconds>(
+                                chrono::steady_clock::now() - timeRestart).count();
+                    }
                     return true;
                 }
             }
@@ -169,6 +266,11 @@ bool RadioReceiver::playProgramme(ProgrammeHandlerInterface& handler,
     return false;
 }
 
+std::shared_ptr<const EnsembleSnapshot> RadioReceiver::getEnsembleSnapshot(void) const
+{
+    return ficHandler.fibProcessor.getEnsembleSnapshot();
+}
+
 uint16_t RadioReceiver::getEnsembleId(void) const
 {
     return ficHandler.fibProcessor.getEnsembleId();
@@ -201,10 +303,11 @@ std::list<ServiceComponent> RadioReceiver::getComponents(const Service& s) const
 
 bool RadioReceiver::serviceHasAudioComponent(const Service& s) const
 {
-    for (const auto& sc : getComponents(s)) {
-        if (sc.transportMode() == TransportMode::Audio and
-                (sc.audioType() == AudioServiceComponentType::DAB or
-                 sc.audioType() == AudioServiceComponentType::DABPlus)) {
+    const auto ensemble = getEnsembleSnapshot();
+    for (const auto sc : ensemble->findComponents(s.serviceId)) {
+        if (sc->transportMode() == TransportMode::Audio and
+                (sc->audioType() == AudioServiceComponentType::DAB or
+                 sc->audioType() == AudioServiceComponentType::DABPlus)) {
             return true;
         }
     }
@@ -226,5 +329,13 @@ RadioReceiverStats RadioReceiver::getReceiverStats() const
 {
     RadioReceiverStats s;
     s.timeLastFCT0Frame = ficHandler.fibProcessor.getTimeLastFCT0Frame();
+    s.frameQueue = ofdmProcessor.getFrameQueueStats();
+    s.figCache = ficHandler.fibProcessor.getFigCacheStats();
+    s.ensembleCache.preloaded = ensemblePreloaded;
+    s.ensembleCache.contradictions = ficHandler.fibProcessor.getCacheContradictions();
+    s.ensembleCache.timeToPlay = timeToPlay;
+    if (asyncController) {
+        s.eventQueue = asyncController->getStats();
+    }
     return s;
 }
@@ -33,11 +33,15 @@
 #ifndef RADIO_RECEIVER_H
 #define RADIO_RECEIVER_H
 
+#include <atomic>
 #include <chrono>
+#include <functional>
 #include <memory>
 #include <string>
 #include "radio-controller.h"
 #include "radio-receiver-options.h"
+#include "async-radio-controller.h"
+#include "ensemble-cache.h"
 #include "fic-handler.h"
 #include "msc-handler.h"
 #include "ofdm-processor.h"
@@ -47,6 +51,19 @@ const char* freqSyncMethodToString(FreqsyncMethod method);
 
 struct RadioReceiverStats {
     std::chrono::system_clock::time_point timeLastFCT0Frame;
+
+    // Frames between the OFDMProcessor and the OfdmDecoder
+    FrameQueueStats frameQueue;
+
+    // Events between the backend and the RadioControllerInterface, all
+    // zero unless RadioReceiverOptions::asyncEvents is set
+    EventQueueStats eventQueue;
+
+    // FIGs that the FIBProcessor did not decode again
+    FigCacheStats figCache;
+
+    // The ensemble of the last restart, and how long it took to play
+    EnsembleCacheStats ensembleCache;
 };
 
 class RadioReceiver {
@@ -58,18 +75,49 @@ class RadioReceiver {
                 int transmission_mode = 1);
 
         /* Restart the receiver, and specify if we want
-         * to scan or receive. */
+         * to scan or receive. A scan runs in FIC-only mode.
+         * Saves the ensemble, see useEnsembleCache. */
         void restart(bool doScan);
 
         /* Keep the demodulator running, but clear the data
          * decoders (both FIC and MSC) */
         void restart_decoder();
 
+        /* With RadioReceiverOptions::ensembleCacheDirectory, keep the
+         * ensemble of the channel the input is tuned to in the cache.
+         * Call after restart(). With preload, the ensemble cached for the
+         * channel is loaded right away, so that a service can be played
+         * before the FIC describes it, see FIBProcessor::preloadEnsemble.
+         * Returns true if it was. */
+        bool useEnsembleCache(const std::string& channel, bool preload = true);
+
+        /* Write the ensemble to the cache. Also done by restart(),
+         * restart_decoder() and stop(). Not while the FIC has not
+         * confirmed a preloaded ensemble yet. */
+        bool saveEnsembleCache();
+
         void stop();
 
+        /* With RadioReceiverOptions::singleThreaded, decode the input on
+         * the calling thread, after restart(). keepRunning is called
+         * between two frames on this thread, and can tune services. */
+        void runSingleThreaded(const std::function<bool()>& keepRunning);
+
         /* Update the currently running receiver with new configuration */
         void setReceiverOptions(const RadioReceiverOptions rro);
 
+        /* Only demodulate the PRS and the FIC, skipping all MSC symbols.
+         * Useful for scanning and for receivers that only monitor the
+         * ensemble. Playing a programme leaves FIC-only mode. */
+        void setFicOnly(bool ficOnly);
+
+        /* Subscribe to the diagnostic streams of the RadioControllerInterface,
+         * a mask of DiagnosticStream values. The streams that are not in
+         * the mask are neither computed nor sent. The initial subscriptions
+         * come from RadioControllerInterface::getDiagnosticSubscriptions. */
+        void setDiagnosticSubscriptions(uint32_t streams);
+        uint32_t getDiagnosticSubscriptions(void) const;
+
         /* Play the audio component of the service. Returns true if an
          * audio subchannel was found and tuned to. */
         bool playSingleProgramme(ProgrammeHandlerInterface& handler,
@@ -80,6 +128,21 @@ class RadioReceiver {
 
         bool removeServiceToDecode(const Service& s);
 
+        /* Stop the programme decoded by the handler, from the subchannel
+         * it was tuned to. Unlike the above, works after the FIC moved
+         * or dropped the service. */
+        bool removeServiceToDecode(const ProgrammeHandlerInterface& handler);
+
+        /* Wait until the programme decoders decoded all the MSC data the
+         * demodulator gave them. Once the input gives no more samples,
+         * the counters of the handlers are then final. */
+        void drainDecoders(void);
+
+        /* The whole ensemble database at once. Unlike the getters below,
+         * which each look at the latest database, the snapshot does not
+         * change while the caller holds it. */
+        std::shared_ptr<const EnsembleSnapshot> getEnsembleSnapshot(void) const;
+
         uint16_t getEnsembleId(void) const;
         uint8_t getEnsembleEcc(void) const;
         DabLabel getEnsembleLabel(void) const;
@@ -110,6 +173,18 @@ class RadioReceiver {
 
         DABParams params; // Defaults to TM1 parameters
 
+        // Only with RadioReceiverOptions::ensembleCacheDirectory
+        std::unique_ptr<EnsembleCache> ensembleCache;
+        std::string cacheChannel;
+        std::atomic<bool> ensemblePreloaded = ATOMIC_VAR_INIT(false);
+
+        std::chrono::steady_clock::time_point timeRestart;
+        std::atomic<int64_t> timeToPlay = ATOMIC_VAR_INIT(-1);
+
+        // Outlives the FicHandler and the OFDMProcessor that send to it
+        std::unique_ptr<AsyncRadioController> asyncController;
+        RadioControllerInterface& controller;
+
         MscHandler mscHandler;
         FicHandler ficHandler;
         OFDMProcessor ofdmProcessor;
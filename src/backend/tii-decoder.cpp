@@ -134,9 +134,11 @@ float tii_measurement_t::getDelayKm(void) const
     return delay_samples * km_per_sample;
 }
 
-TIIDecoder::TIIDecoder(const DABParams& params, RadioControllerInterface& ri) :
+TIIDecoder::TIIDecoder(const DABParams& params, RadioControllerInterface& ri,
+        bool singleThreaded) :
     m_radioInterface(ri),
     m_params(params),
+    m_singleThreaded(singleThreaded),
     m_fft_null(params.T_u),
     m_fft_prs(params.T_u)
 {
@@ -157,7 +159,9 @@ TIIDecoder::TIIDecoder(const DABParams& params, RadioControllerInterface& ri) :
         }
     }
 
-    m_thread = thread(&TIIDecoder::run, this);
+    if (not m_singleThreaded) {
+        m_thread = thread(&TIIDecoder::run, this);
+    }
 }
 
 TIIDecoder::~TIIDecoder()
@@ -172,14 +176,18 @@ TIIDecoder::~TIIDecoder()
     }
 }
 
-void TIIDecoder::pushSymbols(
-        const std::vector<complexf>& null,
-        const std::vector<complexf>& prs)
+void TIIDecoder::pushSymbols(const FrameRef& frame)
 {
+    if (m_singleThreaded) {
+        if (m_params.dabMode == 1) {
+            decodeFrame(*frame);
+        }
+        return;
+    }
+
     unique_lock<mutex> lock(m_state_mutex);
     if (m_state == State::Idle) {
-        m_prs = prs;
-        m_null = null;
+        m_frame = frame;
         m_state = State::NullPrsReady;
     }
     lock.unlock();
@@ -188,9 +196,6 @@ void TIIDecoder::pushSymbols(
 
 void TIIDecoder::run()
 {
-    const size_t spacing = m_params.T_u;
-    const size_t nullsize = m_params.T_null;
-
     while (true) {
         unique_lock<mutex> lock(m_state_mutex);
         while (not (m_state == State::NullPrsReady or
@@ -204,116 +209,127 @@ void TIIDecoder::run()
 
         lock.unlock();
         // We are in NullPrsReady state, and the state will not change now
+        decodeFrame(*m_frame);
 
-        // Take the NULL symbol from that frame, but skip the cyclic prefix and
-        // truncate
-        size_t null_skip = nullsize - spacing;
+        lock.lock();
+        m_frame.reset();
+        m_state = State::Idle;
+        lock.unlock();
+    }
+}
 
-        if (m_null.size() != nullsize) {
-            throw out_of_range("NULL length: " + to_string(m_prs.size()) +
-                    " vs " + to_string(nullsize));
-        }
-        copy(m_null.begin() + null_skip, m_null.begin() + null_skip + spacing,
-                m_fft_null.getVector());
-        m_fft_null.do_FFT();
-
-        // The phase reference symbol, assume cyclic prefix absent
-        if (m_prs.size() < spacing) {
-            throw out_of_range("PRS length: " + to_string(m_prs.size()) +
-                    " vs " + to_string(spacing));
-        }
-        copy(m_prs.begin(), m_prs.begin() + spacing, m_fft_prs.getVector());
-        m_fft_prs.do_FFT();
-
-        /* In TM1, the carriers repeat four times:
-         * [-768, -384[
-         * [-384, 0[
-         * ]0, 384]
-         * ]384, 768]
-         * A consequence of the fact that the 0 bin is never used is that the
-         * first carrier of each pair is even for negative k, odd for positive k
-         *
-         * We multiply the first carrier of the pair with the conjugate of the second
-         * carrier in the pair. As they have the same phase, this will make them
-         * correlate, whereas noise will not correlate. Also, we accumulate the
-         * measurements over the four blocks.
-         */
-        vector<complexf> blocks_multiplied(192);
-        vector<float> prs_power_sq(192);
-
-        /* Equivalent numpy code
-        blocks = [null_fft[-768:-384], null_fft[-384:], null_fft[1:385], null_fft[385:769]]
-        blocks_multiplied = np.zeros(384//2, dtype=np.complex128)
-        for block in blocks:
-            even_odd = block.reshape(-1, 2)
-            b = even_odd[...,0] * np.conj(even_odd[...,1])
-            blocks_multiplied += b
-        */
+void TIIDecoder::decodeFrame(const OfdmFrame& frame)
+{
+    const size_t spacing = m_params.T_u;
+    const size_t nullsize = m_params.T_null;
 
+    const SampleBuffer& null_symbol = frame.nullSymbol;
+    const SampleBuffer& prs = frame.prs;
+
+    // Take the NULL symbol from that frame, but skip the cyclic prefix and
+    // truncate
+    size_t null_skip = nullsize - spacing;
+
+    if (null_symbol.size() != nullsize) {
+        throw out_of_range("NULL length: " + to_string(prs.size()) +
+                " vs " + to_string(nullsize));
+    }
+    copy(null_symbol.begin() + null_skip, null_symbol.begin() + null_skip + spacing,
+            m_fft_null.getVector());
+    m_fft_null.do_FFT();
+
+    // The phase reference symbol, assume cyclic prefix absent
+    if (prs.size() < spacing) {
+        throw out_of_range("PRS length: " + to_string(prs.size()) +
+                " vs " + to_string(spacing));
+    }
+    copy(prs.begin(), prs.begin() + spacing, m_fft_prs.getVector());
+    m_fft_prs.do_FFT();
+
+    /* In TM1, the carriers repeat four times:
+     * [-768, -384[
+     * [-384, 0[
+     * ]0, 384]
+     * ]384, 768]
+     * A consequence of the fact that the 0 bin is never used is that the
+     * first carrier of each pair is even for negative k, odd for positive k
+     *
+     * We multiply the first carrier of the pair with the conjugate of the second
+     * carrier in the pair. As they have the same phase, this will make them
+     * correlate, whereas noise will not correlate. Also, we accumulate the
+     * measurements over the four blocks.
+     */
+    vector<complexf> blocks_multiplied(192);
+    vector<float> prs_power_sq(192);
+
+    /* Equivalent numpy code
+    blocks = [null_fft[-768:-384], null_fft[-384:], null_fft[1:385], null_fft[385:769]]
+    blocks_multiplied = np.zeros(384//2, dtype=np.complex128)
+    for block in blocks:
+        even_odd = block.reshape(-1, 2)
+        b = even_odd[...,0] * np.conj(even_odd[...,1])
+        blocks_multiplied += b
+    */
+
+    for (size_t i = 0; i < 192; i++) {
+        const complexf *p = m_fft_prs.getVector();
+        prs_power_sq[i] = norm(p[1 + 2*i]);
+    }
+
+    const size_t k_start[] = {2048 - 768, 2048 - 384, 1, 385};
+    const complexf *n = m_fft_null.getVector();
+    for (size_t k : k_start) {
         for (size_t i = 0; i < 192; i++) {
-            const complexf *p = m_fft_prs.getVector();
-            prs_power_sq[i] = norm(p[1 + 2*i]);
+            // The two consecutive carriers should have the
+            // same phase. By multiplying with the conjugate,
+            // we should get a value with low imaginary component.
+            // In terms of units, this resembles a norm.
+            blocks_multiplied[i] += n[k+2*i] * conj(n[k+2*i+1]);
         }
+    }
 
-        const size_t k_start[] = {2048 - 768, 2048 - 384, 1, 385};
-        const complexf *n = m_fft_null.getVector();
-        for (size_t k : k_start) {
-            for (size_t i = 0; i < 192; i++) {
-                // The two consecutive carriers should have the
-                // same phase. By multiplying with the conjugate,
-                // we should get a value with low imaginary component.
-                // In terms of units, this resembles a norm.
-                blocks_multiplied[i] += n[k+2*i] * conj(n[k+2*i+1]);
-            }
-        }
+    auto ix_to_k = [](int ix) -> carrier_t {
+        if (ix <= 1024)
+            return ix;
+        else
+            return ix - 2048; };
 
-        auto ix_to_k = [](int ix) -> carrier_t {
-            if (ix <= 1024)
-                return ix;
-            else
-                return ix - 2048; };
+    const float threshold_factor = 0.4f;
 
-        const float threshold_factor = 0.4f;
+    vector<carrier_t> carriers;
+    for (size_t i = 0; i < 192; i++) {
+        const float threshold = prs_power_sq[i] * threshold_factor;
+        if (abs(blocks_multiplied[i]) > threshold) {
+            // Convert back from "pair index" to k
+            const carrier_t k = ix_to_k(i*2 + 1);
+            carriers.push_back(k);
+        }
+    }
 
-        vector<carrier_t> carriers;
-        for (size_t i = 0; i < 192; i++) {
-            const float threshold = prs_power_sq[i] * threshold_factor;
-            if (abs(blocks_multiplied[i]) > threshold) {
-                // Convert back from "pair index" to k
-                const carrier_t k = ix_to_k(i*2 + 1);
-                carriers.push_back(k);
+    unordered_map<CombPattern, int> cp_count;
+    for (const carrier_t k : carriers) {
+        if (m_cp_per_carrier.count(k)) {
+            for (const auto& cps : m_cp_per_carrier[k]) {
+                cp_count[cps]++;
             }
         }
+    }
 
-        unordered_map<CombPattern, int> cp_count;
-        for (const carrier_t k : carriers) {
-            if (m_cp_per_carrier.count(k)) {
-                for (const auto& cps : m_cp_per_carrier[k]) {
-                    cp_count[cps]++;
-                }
-            }
+    size_t num_likely_cps = 0;
+    for (const auto& cp : cp_count) {
+        if (cp.second >= 4) {
+            num_likely_cps++;
         }
+    }
 
-        size_t num_likely_cps = 0;
+    // Sometimes the number of likely CPs is huge because
+    // the threshold is wrong. Skip these cases.
+    if (num_likely_cps < 10) {
         for (const auto& cp : cp_count) {
             if (cp.second >= 4) {
-                num_likely_cps++;
+                analyse_phase(cp.first);
             }
         }
-
-        // Sometimes the number of likely CPs is huge because
-        // the threshold is wrong. Skip these cases.
-        if (num_likely_cps < 10) {
-            for (const auto& cp : cp_count) {
-                if (cp.second >= 4) {
-                    analyse_phase(cp.first);
-                }
-            }
-        }
-
-        lock.lock();
-        m_state = State::Idle;
-        lock.unlock();
     }
 }
 
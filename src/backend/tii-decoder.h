@@ -29,6 +29,7 @@
 #include <condition_variable>
 #include <complex>
 #include "fft.h"
+#include "frame-pool.h"
 #include "radio-controller.h"
 
 using complexf = std::complex<float>;
@@ -63,24 +64,28 @@ namespace std {
 
 class TIIDecoder {
     public:
-        TIIDecoder(const DABParams& params, RadioControllerInterface& ri);
+        /* Single-threaded, the frames are analysed in pushSymbols,
+         * otherwise in a thread of the decoder. */
+        TIIDecoder(const DABParams& params, RadioControllerInterface& ri,
+                bool singleThreaded = false);
         ~TIIDecoder();
         TIIDecoder(const TIIDecoder& other) = delete;
         TIIDecoder& operator=(const TIIDecoder& other) = delete;
 
-        void pushSymbols(
-                const std::vector<complexf>& null,
-                const std::vector<complexf>& prs);
+        /* Analyse the PRS and the NULL symbol of the frame,
+         * unless the previous frame is still being analysed. */
+        void pushSymbols(const FrameRef& frame);
 
     private:
         void run(void);
+        void decodeFrame(const OfdmFrame& frame);
         void analyse_phase(const CombPattern& cp);
 
         RadioControllerInterface& m_radioInterface;
         const DABParams& m_params;
+        const bool m_singleThreaded;
 
-        std::vector<complexf> m_null;
-        std::vector<complexf> m_prs;
+        FrameRef m_frame;
 
         std::unordered_map<carrier_t, std::unordered_set<CombPattern> >
             m_cp_per_carrier;
@@ -0,0 +1,301 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include    "viterbi-simd.h"
+
+#if defined(WELLE_HAVE_X86_SIMD)
+#  include <immintrin.h>
+#endif
+#if defined(WELLE_HAVE_NEON)
+#  include <arm_neon.h>
+#endif
+
+static_assert(RATE == 4, "SIMD Viterbi kernels are written for rate 1/4");
+static_assert(NUMSTATES == 64, "SIMD Viterbi kernels are written for 64 states");
+static_assert(sizeof(COMPUTETYPE) == 2, "SIMD Viterbi kernels use 16-bit metrics");
+
+//  Layout reminder, see Viterbi::BFLY:
+//  butterfly i (0 .. 31) reads the old metrics i and i + 32, and
+//  writes the new metrics 2i and 2i + 1. The decision bit for new
+//  state n is bit (n % 32) of decision word n / 32.
+
+#if defined(WELLE_HAVE_X86_SIMD)
+
+__attribute__((target("sse2")))
+void update_viterbi_blk_SSE2(struct v *vp,
+                             const COMPUTETYPE *branchtab,
+                             const COMPUTETYPE *syms,
+                             int16_t nbits,
+                             COMPUTETYPE maxMetric,
+                             COMPUTETYPE threshold)
+{
+    // SSE2 only has signed 16-bit compares, flipping the sign bit
+    // turns them into unsigned ones.
+    const __m128i bias = _mm_set1_epi16((int16_t)0x8000);
+    const __m128i max = _mm_set1_epi16((int16_t)maxMetric);
+
+    for (int s = 0; s < nbits; s++) {
+        const __m128i sym0 = _mm_set1_epi16((int16_t)syms[s * RATE + 0]);
+        const __m128i sym1 = _mm_set1_epi16((int16_t)syms[s * RATE + 1]);
+        const __m128i sym2 = _mm_set1_epi16((int16_t)syms[s * RATE + 2]);
+        const __m128i sym3 = _mm_set1_epi16((int16_t)syms[s * RATE + 3]);
+
+        const COMPUTETYPE *oldm = vp->old_metrics->t;
+        COMPUTETYPE *newm = vp->new_metrics->t;
+        uint32_t decisions[2] = {0, 0};
+
+        for (int i = 0; i < NUMSTATES / 2; i += 8) {
+            const __m128i *bt = (const __m128i*)&branchtab[i];
+            __m128i metric = _mm_xor_si128(_mm_loadu_si128(bt), sym0);
+            metric = _mm_add_epi16(metric, _mm_xor_si128(_mm_loadu_si128(bt + 4), sym1));
+            metric = _mm_add_epi16(metric, _mm_xor_si128(_mm_loadu_si128(bt + 8), sym2));
+            metric = _mm_add_epi16(metric, _mm_xor_si128(_mm_loadu_si128(bt + 12), sym3));
+            const __m128i invMetric = _mm_sub_epi16(max, metric);
+
+            const __m128i oldLo = _mm_loadu_si128((const __m128i*)&oldm[i]);
+            const __m128i oldHi = _mm_loadu_si128((const __m128i*)&oldm[i + NUMSTATES / 2]);
+
+            const __m128i m0 = _mm_add_epi16(oldLo, metric);
+            const __m128i m1 = _mm_add_epi16(oldHi, invMetric);
+            const __m128i m2 = _mm_add_epi16(oldLo, invMetric);
+            const __m128i m3 = _mm_add_epi16(oldHi, metric);
+
+            const __m128i d0 = _mm_cmpgt_epi16(
+                    _mm_xor_si128(m0, bias), _mm_xor_si128(m1, bias));
+            const __m128i d1 = _mm_cmpgt_epi16(
+                    _mm_xor_si128(m2, bias), _mm_xor_si128(m3, bias));
+
+            const __m128i n0 = _mm_or_si128(
+                    _mm_and_si128(d0, m1), _mm_andnot_si128(d0, m0));
+            const __m128i n1 = _mm_or_si128(
+                    _mm_and_si128(d1, m3), _mm_andnot_si128(d1, m2));
+
+            _mm_storeu_si128((__m128i*)&newm[2 * i], _mm_unpacklo_epi16(n0, n1));
+            _mm_storeu_si128((__m128i*)&newm[2 * i + 8], _mm_unpackhi_epi16(n0, n1));
+
+            const __m128i dBytes = _mm_packs_epi16(
+                    _mm_unpacklo_epi16(d0, d1), _mm_unpackhi_epi16(d0, d1));
+            const uint32_t bits = (uint32_t)_mm_movemask_epi8(dBytes) & 0xFFFF;
+            decisions[i / 16] |= bits << ((2 * i) & 31);
+        }
+
+        vp->decisions[s].w[0] = decisions[0];
+        vp->decisions[s].w[1] = decisions[1];
+
+        if (newm[0] > threshold) {
+            __m128i min = _mm_xor_si128(_mm_loadu_si128((const __m128i*)&newm[0]), bias);
+            for (int i = 8; i < NUMSTATES; i += 8) {
+                min = _mm_min_epi16(min,
+                        _mm_xor_si128(_mm_loadu_si128((const __m128i*)&newm[i]), bias));
+            }
+            min = _mm_min_epi16(min, _mm_srli_si128(min, 8));
+            min = _mm_min_epi16(min, _mm_srli_si128(min, 4));
+            min = _mm_min_epi16(min, _mm_srli_si128(min, 2));
+            const __m128i sub = _mm_set1_epi16(
+                    (int16_t)(_mm_cvtsi128_si32(min) ^ 0x8000));
+
+            for (int i = 0; i < NUMSTATES; i += 8) {
+                __m128i *p = (__m128i*)&newm[i];
+                _mm_storeu_si128(p, _mm_sub_epi16(_mm_loadu_si128(p), sub));
+            }
+        }
+
+        metric_t *tmp = vp->old_metrics;
+        vp->old_metrics = vp->new_metrics;
+        vp->new_metrics = tmp;
+    }
+}
+
+__attribute__((target("avx2")))
+void update_viterbi_blk_AVX2(struct v *vp,
+                             const COMPUTETYPE *branchtab,
+                             const COMPUTETYPE *syms,
+                             int16_t nbits,
+                             COMPUTETYPE maxMetric,
+                             COMPUTETYPE threshold)
+{
+    const __m256i max = _mm256_set1_epi16((int16_t)maxMetric);
+    const __m256i ones = _mm256_set1_epi16(-1);
+
+    for (int s = 0; s < nbits; s++) {
+        const __m256i sym0 = _mm256_set1_epi16((int16_t)syms[s * RATE + 0]);
+        const __m256i sym1 = _mm256_set1_epi16((int16_t)syms[s * RATE + 1]);
+        const __m256i sym2 = _mm256_set1_epi16((int16_t)syms[s * RATE + 2]);
+        const __m256i sym3 = _mm256_set1_epi16((int16_t)syms[s * RATE + 3]);
+
+        const COMPUTETYPE *oldm = vp->old_metrics->t;
+        COMPUTETYPE *newm = vp->new_metrics->t;
+
+        for (int i = 0; i < NUMSTATES / 2; i += 16) {
+            const __m256i *bt = (const __m256i*)&branchtab[i];
+            __m256i metric = _mm256_xor_si256(_mm256_loadu_si256(bt), sym0);
+            metric = _mm256_add_epi16(metric, _mm256_xor_si256(_mm256_loadu_si256(bt + 2), sym1));
+            metric = _mm256_add_epi16(metric, _mm256_xor_si256(_mm256_loadu_si256(bt + 4), sym2));
+            metric = _mm256_add_epi16(metric, _mm256_xor_si256(_mm256_loadu_si256(bt + 6), sym3));
+            const __m256i invMetric = _mm256_sub_epi16(max, metric);
+
+            const __m256i oldLo = _mm256_loadu_si256((const __m256i*)&oldm[i]);
+            const __m256i oldHi = _mm256_loadu_si256((const __m256i*)&oldm[i + NUMSTATES / 2]);
+
+            const __m256i m0 = _mm256_add_epi16(oldLo, metric);
+            const __m256i m1 = _mm256_add_epi16(oldHi, invMetric);
+            const __m256i m2 = _mm256_add_epi16(oldLo, invMetric);
+            const __m256i m3 = _mm256_add_epi16(oldHi, metric);
+
+            // decision is m0 > m1 (unsigned), i.e. the minimum is not m0
+            const __m256i n0 = _mm256_min_epu16(m0, m1);
+            const __m256i n1 = _mm256_min_epu16(m2, m3);
+            const __m256i d0 = _mm256_xor_si256(_mm256_cmpeq_epi16(n0, m0), ones);
+            const __m256i d1 = _mm256_xor_si256(_mm256_cmpeq_epi16(n1, m2), ones);
+
+            // unpack works within 128-bit lanes: lo holds new states
+            // 2i+0..7 and 2i+16..23, hi holds 2i+8..15 and 2i+24..31
+            const __m256i lo = _mm256_unpacklo_epi16(n0, n1);
+            const __m256i hi = _mm256_unpackhi_epi16(n0, n1);
+            _mm256_storeu_si256((__m256i*)&newm[2 * i],
+                    _mm256_permute2x128_si256(lo, hi, 0x20));
+            _mm256_storeu_si256((__m256i*)&newm[2 * i + 16],
+                    _mm256_permute2x128_si256(lo, hi, 0x31));
+
+            // packs also works per lane, which puts the bytes back in order
+            const __m256i dBytes = _mm256_packs_epi16(
+                    _mm256_unpacklo_epi16(d0, d1), _mm256_unpackhi_epi16(d0, d1));
+            vp->decisions[s].w[i / 16] = (uint32_t)_mm256_movemask_epi8(dBytes);
+        }
+
+        if (newm[0] > threshold) {
+            const __m256i a = _mm256_min_epu16(
+                    _mm256_loadu_si256((const __m256i*)&newm[0]),
+                    _mm256_loadu_si256((const __m256i*)&newm[16]));
+            const __m256i b = _mm256_min_epu16(
+                    _mm256_loadu_si256((const __m256i*)&newm[32]),
+                    _mm256_loadu_si256((const __m256i*)&newm[48]));
+            const __m256i ab = _mm256_min_epu16(a, b);
+            const __m128i min8 = _mm_min_epu16(
+                    _mm256_castsi256_si128(ab), _mm256_extracti128_si256(ab, 1));
+            const __m256i sub = _mm256_set1_epi16(
+                    (int16_t)(_mm_cvtsi128_si32(_mm_minpos_epu16(min8)) & 0xFFFF));
+
+            for (int i = 0; i < NUMSTATES; i += 16) {
+                __m256i *p = (__m256i*)&newm[i];
+                _mm256_storeu_si256(p, _mm256_sub_epi16(_mm256_loadu_si256(p), sub));
+            }
+        }
+
+        metric_t *tmp = vp->old_metrics;
+        vp->old_metrics = vp->new_metrics;
+        vp->new_metrics = tmp;
+    }
+}
+
+#endif // WELLE_HAVE_X86_SIMD
+
+#if defined(WELLE_HAVE_NEON)
+
+static inline uint16_t hmin_u16(uint16x8_t v)
+{
+#if defined(__aarch64__)
+    return vminvq_u16(v);
+#else
+    uint16x4_t m = vpmin_u16(vget_low_u16(v), vget_high_u16(v));
+    m = vpmin_u16(m, m);
+    m = vpmin_u16(m, m);
+    return vget_lane_u16(m, 0);
+#endif
+}
+
+void update_viterbi_blk_NEON(struct v *vp,
+                             const COMPUTETYPE *branchtab,
+                             const COMPUTETYPE *syms,
+                             int16_t nbits,
+                             COMPUTETYPE maxMetric,
+                             COMPUTETYPE threshold)
+{
+    static const uint8_t bitWeights[16] = {
+        1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128 };
+    const uint8x16_t weights = vld1q_u8(bitWeights);
+    const uint16x8_t max = vdupq_n_u16(maxMetric);
+
+    for (int s = 0; s < nbits; s++) {
+        const uint16x8_t sym0 = vdupq_n_u16(syms[s * RATE + 0]);
+        const uint16x8_t sym1 = vdupq_n_u16(syms[s * RATE + 1]);
+        const uint16x8_t sym2 = vdupq_n_u16(syms[s * RATE + 2]);
+        const uint16x8_t sym3 = vdupq_n_u16(syms[s * RATE + 3]);
+
+        const COMPUTETYPE *oldm = vp->old_metrics->t;
+        COMPUTETYPE *newm = vp->new_metrics->t;
+        uint32_t decisions[2] = {0, 0};
+
+        for (int i = 0; i < NUMSTATES / 2; i += 8) {
+            uint16x8_t metric = veorq_u16(vld1q_u16(&branchtab[i + 0 * NUMSTATES / 2]), sym0);
+            metric = vaddq_u16(metric, veorq_u16(vld1q_u16(&branchtab[i + 1 * NUMSTATES / 2]), sym1));
+            metric = vaddq_u16(metric, veorq_u16(vld1q_u16(&branchtab[i + 2 * NUMSTATES / 2]), sym2));
+            metric = vaddq_u16(metric, veorq_u16(vld1q_u16(&branchtab[i + 3 * NUMSTATES / 2]), sym3));
+            const uint16x8_t invMetric = vsubq_u16(max, metric);
+
+            const uint16x8_t oldLo = vld1q_u16(&oldm[i]);
+            const uint16x8_t oldHi = vld1q_u16(&oldm[i + NUMSTATES / 2]);
+
+            const uint16x8_t m0 = vaddq_u16(oldLo, metric);
+            const uint16x8_t m1 = vaddq_u16(oldHi, invMetric);
+            const uint16x8_t m2 = vaddq_u16(oldLo, invMetric);
+            const uint16x8_t m3 = vaddq_u16(oldHi, metric);
+
+            const uint16x8x2_t n = vzipq_u16(vminq_u16(m0, m1), vminq_u16(m2, m3));
+            vst1q_u16(&newm[2 * i], n.val[0]);
+            vst1q_u16(&newm[2 * i + 8], n.val[1]);
+
+            const uint16x8x2_t d = vzipq_u16(vcgtq_u16(m0, m1), vcgtq_u16(m2, m3));
+            const uint8x16_t dBytes = vandq_u8(
+                    vcombine_u8(vmovn_u16(d.val[0]), vmovn_u16(d.val[1])),
+                    weights);
+            const uint64x2_t sums = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(dBytes)));
+            const uint32_t bits = (uint32_t)vgetq_lane_u64(sums, 0) |
+                ((uint32_t)vgetq_lane_u64(sums, 1) << 8);
+            decisions[i / 16] |= bits << ((2 * i) & 31);
+        }
+
+        vp->decisions[s].w[0] = decisions[0];
+        vp->decisions[s].w[1] = decisions[1];
+
+        if (newm[0] > threshold) {
+            uint16x8_t min = vld1q_u16(&newm[0]);
+            for (int i = 8; i < NUMSTATES; i += 8) {
+                min = vminq_u16(min, vld1q_u16(&newm[i]));
+            }
+            const uint16x8_t sub = vdupq_n_u16(hmin_u16(min));
+
+            for (int i = 0; i < NUMSTATES; i += 8) {
+                vst1q_u16(&newm[i], vsubq_u16(vld1q_u16(&newm[i]), sub));
+            }
+        }
+
+        metric_t *tmp = vp->old_metrics;
+        vp->old_metrics = vp->new_metrics;
+        vp->new_metrics = tmp;
+    }
+}
+
+#endif // WELLE_HAVE_NEON
@@ -0,0 +1,66 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef __VITERBI_SIMD__
+#define __VITERBI_SIMD__
+
+/*
+ *  Vectorised versions of Viterbi::update_viterbi_blk_GENERIC for the
+ *  64-state, rate 1/4 DAB code. They process the 32 butterflies of one
+ *  decoded bit in parallel, with the same 16-bit wrapping arithmetic as
+ *  the C butterfly, so the decisions and metrics are bit-exact.
+ *
+ *  branchtab is the Viterbi::Branchtab table, maxMetric the largest
+ *  branch metric and threshold the renormalisation threshold.
+ */
+#include    "viterbi.h"
+#include    "cpu_features.h"
+
+#if defined(WELLE_HAVE_X86_SIMD)
+void update_viterbi_blk_SSE2(struct v *vp,
+                             const COMPUTETYPE *branchtab,
+                             const COMPUTETYPE *syms,
+                             int16_t nbits,
+                             COMPUTETYPE maxMetric,
+                             COMPUTETYPE threshold);
+
+void update_viterbi_blk_AVX2(struct v *vp,
+                             const COMPUTETYPE *branchtab,
+                             const COMPUTETYPE *syms,
+                             int16_t nbits,
+                             COMPUTETYPE maxMetric,
+                             COMPUTETYPE threshold);
+#endif
+
+#if defined(WELLE_HAVE_NEON)
+void update_viterbi_blk_NEON(struct v *vp,
+                             const COMPUTETYPE *branchtab,
+                             const COMPUTETYPE *syms,
+                             int16_t nbits,
+                             COMPUTETYPE maxMetric,
+                             COMPUTETYPE threshold);
+#endif
+
+#endif
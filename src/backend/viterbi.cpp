@@ -21,7 +21,10 @@
 #include    <stdio.h>
 #include    <stdlib.h>
 #include    "viterbi.h"
+#include    "viterbi-simd.h"
+#include    "cpu_features.h"
 #include    <cstring>
+#include    <stdexcept>
 
 #ifdef  __MINGW32__
 #  include <intrin.h>
@@ -123,7 +126,13 @@ void renormalize(COMPUTETYPE* X, COMPUTETYPE threshold)
 //  There are (in mode 1) 3 ofdm blocks, giving 4 FIC blocks
 //  There all have a predefined length. In that case we use the
 //  "fast" (i.e. spiral) code, otherwise we use the generic code
-Viterbi::Viterbi(int16_t wordlength)
+Viterbi::Viterbi(int16_t wordlength) :
+    Viterbi(wordlength, bestKernel())
+{
+}
+
+Viterbi::Viterbi(int16_t wordlength, ViterbiKernel kernel) :
+    kernel(kernel)
 {
     int polys[RATE] = POLYS;
     int16_t i, state;
@@ -174,6 +183,40 @@ Viterbi::Viterbi(int16_t wordlength)
 }
 
 
+ViterbiKernel Viterbi::bestKernel()
+{
+    if (cpu_features::has_avx2())
+        return ViterbiKernel::AVX2;
+    if (cpu_features::has_sse2())
+        return ViterbiKernel::SSE2;
+    if (cpu_features::has_neon())
+        return ViterbiKernel::NEON;
+    return ViterbiKernel::Generic;
+}
+
+std::vector<ViterbiKernel> Viterbi::availableKernels()
+{
+    std::vector<ViterbiKernel> kernels = { ViterbiKernel::Generic };
+    if (cpu_features::has_sse2())
+        kernels.push_back(ViterbiKernel::SSE2);
+    if (cpu_features::has_avx2())
+        kernels.push_back(ViterbiKernel::AVX2);
+    if (cpu_features::has_neon())
+        kernels.push_back(ViterbiKernel::NEON);
+    return kernels;
+}
+
+const char *Viterbi::kernelName(ViterbiKernel kernel)
+{
+    switch (kernel) {
+        case ViterbiKernel::Generic: return "generic";
+        case ViterbiKernel::SSE2: return "SSE2";
+        case ViterbiKernel::AVX2: return "AVX2";
+        case ViterbiKernel::NEON: return "NEON";
+    }
+    return "unknown";
+}
+
 Viterbi::~Viterbi()
 {
 #ifdef  __MINGW32__
@@ -236,7 +279,51 @@ void Viterbi::deconvolve(softbit_t *input, uint8_t *output)
         symbols[i] = temp;
     }
 
-    update_viterbi_blk_GENERIC (&vp, symbols, frameBits + (K - 1));
+    update_viterbi_blk (&vp, symbols, frameBits + (K - 1));
+
+    chainback_viterbi (&vp, data, frameBits, 0);
+
+    for (i = 0; i < (uint16_t)frameBits; i ++)
+        output[i] = getbit (data[i >> 3], i & 07);
+}
+
+//  Map a soft bit -127 .. 127 onto the 0 .. 255 metric, without
+//  branches. -128 is clamped to 0 like in deconvolve().
+static inline
+COMPUTETYPE softbitMetric(softbit_t sb)
+{
+    return (COMPUTETYPE)(sb + 127 + (sb == -128));
+}
+
+void Viterbi::setDepunctureTable(std::vector<uint32_t>&& table)
+{
+    depunctureTable = std::move(table);
+
+    //  The punctured positions are never written by
+    //  deconvolvePunctured, they keep the value of a zero soft bit
+    const uint32_t nsymbols = (uint16_t)(frameBits + (K - 1)) * RATE;
+    for (uint32_t i = 0; i < nsymbols; i ++) {
+        symbols[i] = 127;
+    }
+
+    for (const uint32_t position : depunctureTable) {
+        if (position >= nsymbols) {
+            throw std::logic_error("Depuncture table does not fit the codeword");
+        }
+    }
+}
+
+void Viterbi::deconvolvePunctured(const softbit_t *input, uint8_t *output)
+{
+    uint32_t i;
+    const uint32_t *table = depunctureTable.data();
+    const size_t n = depunctureTable.size();
+
+    init_viterbi (&vp, 0);
+    for (size_t k = 0; k < n; k ++)
+        symbols[table[k]] = softbitMetric(input[k]);
+
+    update_viterbi_blk (&vp, symbols, frameBits + (K - 1));
 
     chainback_viterbi (&vp, data, frameBits, 0);
 
@@ -278,6 +365,40 @@ void Viterbi::BFLY(
         (decision0|decision1<<1) << ((2*i)&(sizeof(uint32_t)*8-1));
 }
 
+/* Dispatch to the kernel selected at construction. A kernel
+ * that is not compiled in falls back to the generic code.
+ */
+void Viterbi::update_viterbi_blk(
+        struct v *vp,
+        COMPUTETYPE *syms,
+        int16_t nbits)
+{
+    const COMPUTETYPE max =
+        ((RATE * ((256 - 1) >> METRICSHIFT)) >> PRECISIONSHIFT);
+
+    switch (kernel) {
+#if defined(WELLE_HAVE_X86_SIMD)
+        case ViterbiKernel::SSE2:
+            update_viterbi_blk_SSE2(vp, Branchtab, syms, nbits,
+                    max, RENORMALIZE_THRESHOLD);
+            return;
+        case ViterbiKernel::AVX2:
+            update_viterbi_blk_AVX2(vp, Branchtab, syms, nbits,
+                    max, RENORMALIZE_THRESHOLD);
+            return;
+#endif
+#if defined(WELLE_HAVE_NEON)
+        case ViterbiKernel::NEON:
+            update_viterbi_blk_NEON(vp, Branchtab, syms, nbits,
+                    max, RENORMALIZE_THRESHOLD);
+            return;
+#endif
+        default:
+            update_viterbi_blk_GENERIC(vp, syms, nbits);
+            return;
+    }
+}
+
 /* Update decoder with a block of demodulated symbols
  * Note that nbits is the number of decoded data bits, not the number
  * of symbols!
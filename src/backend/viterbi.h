@@ -3,6 +3,7 @@
 /*
  *  Viterbi.h according to the SPIRAL project
  */
+#include    <vector>
 #include    "dab-constants.h"
 #include    "MathHelper.h"
 
@@ -35,16 +36,42 @@ struct v {
     decision_t *decisions;   /* decisions */
 };
 
+/* Implementations of the butterfly update. All of them give
+ * bit-exact results, the SIMD ones are only faster. */
+enum class ViterbiKernel { Generic, SSE2, AVX2, NEON };
+
 class Viterbi
 {
     public:
+        /* Uses the fastest kernel the CPU supports */
         Viterbi(int16_t);
+        Viterbi(int16_t, ViterbiKernel kernel);
         ~Viterbi(void);
         Viterbi(const Viterbi& other) = delete;
         Viterbi& operator=(const Viterbi& other) = delete;
         void deconvolve(softbit_t *input, uint8_t *output);
 
+        ViterbiKernel getKernel(void) const { return kernel; }
+
+        /* Runtime CPU feature detection */
+        static ViterbiKernel bestKernel(void);
+        static std::vector<ViterbiKernel> availableKernels(void);
+        static const char *kernelName(ViterbiKernel kernel);
+
+    protected:
+        /* Decode a punctured codeword. The table gives, for every
+         * received soft bit, its position in the mother codeword
+         * (see buildDepunctureTable). The soft bits are scattered
+         * straight into the metric buffer of the decoder, punctured
+         * positions stay erased. Do not mix with deconvolve() on the
+         * same instance, it overwrites the erasures. */
+        void setDepunctureTable(std::vector<uint32_t>&& table);
+        void deconvolvePunctured(const softbit_t *input, uint8_t *output);
+
     private:
+        ViterbiKernel kernel;
+        std::vector<uint32_t> depunctureTable;
+
         struct v    vp;
         COMPUTETYPE Branchtab   [NUMSTATES / 2 * RATE] __attribute__ ((aligned (16)));
         //  int parityb     (uint8_t);
@@ -56,6 +83,9 @@ class Viterbi
         void update_viterbi_blk_GENERIC( struct v *vp,
                                          COMPUTETYPE *syms,
                                          int16_t nbits);
+        void update_viterbi_blk( struct v *vp,
+                                 COMPUTETYPE *syms,
+                                 int16_t nbits);
 
         void chainback_viterbi( struct v *vp,
                                 uint8_t *data, /* Decoded output data */
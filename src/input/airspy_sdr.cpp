@@ -47,7 +47,7 @@ static const int EXTIO_BASE_TYPE_SIZE = sizeof(float);
 
 CAirspy::CAirspy(RadioControllerInterface &radioController) :
     radioController(radioController),
-    SampleBuffer(256 * 1024),
+    SampleBuffer(256 * 1024, true),
     SpectrumSampleBuffer(8192)
 {
     std::clog << "Airspy: " << "Open airspy" << std::endl;
@@ -125,8 +125,8 @@ bool CAirspy::restart(void)
     if (running)
         return true;
 
-    SampleBuffer.FlushRingBuffer();
-    SpectrumSampleBuffer.FlushRingBuffer();
+    SampleBuffer.flush();
+    SpectrumSampleBuffer.flush();
     result = airspy_set_sample_type(device, AIRSPY_SAMPLE_FLOAT32_IQ);
     if (result != AIRSPY_SUCCESS) {
         std::clog  << "Airspy: airspy_set_sample_type () failed: " << airspy_error_name((airspy_error)result) << "(" << result << ")" << std::endl;
@@ -193,19 +193,34 @@ int CAirspy::data_available(const DSPCOMPLEX* buf, size_t num_samples)
 
     const DSPCOMPLEX* sbuf = reinterpret_cast<const DSPCOMPLEX*>(buf);
 
-    std::vector<DSPCOMPLEX> temp(num_samples/2);
-
     float maxnorm = 0;
 
-    for (size_t i = 0; i < num_samples/2; i++) {
-        const auto z = 0.5f * (sbuf[2*i] + sbuf[2*i+1]);
-        temp[i] = z;
+    // Decimate straight into the sample buffer. What does not fit
+    // is dropped.
+    const size_t count = num_samples/2;
+    size_t done = 0;
+    while (done < count) {
+        const auto span = SampleBuffer.acquireWrite(count - done);
+        if (span.size == 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < span.size; i++) {
+            const size_t j = done + i;
+            const auto z = 0.5f * (sbuf[2*j] + sbuf[2*j+1]);
+            span.data[i] = z;
 
-        if (sw_agc and (num_frames % 10) == 0) {
-            if (norm(z) > maxnorm) {
-                maxnorm = norm(z);
+            if (sw_agc and (num_frames % 10) == 0) {
+                if (norm(z) > maxnorm) {
+                    maxnorm = norm(z);
+                }
             }
         }
+
+        SampleBuffer.commitWrite(span.size);
+        if (spectrumSamplesEnabled)
+            SpectrumSampleBuffer.write(span.data, span.size);
+        done += span.size;
     }
 
     if (sw_agc and (num_frames % 10) == 0) {
@@ -228,27 +243,26 @@ int CAirspy::data_available(const DSPCOMPLEX* buf, size_t num_samples)
 
     num_frames++;
 
-    SampleBuffer.putDataIntoBuffer(temp.data(), num_samples/2);
-    SpectrumSampleBuffer.putDataIntoBuffer(temp.data(), num_samples/2);
+    notifySamplesAvailable();
 
     return 0;
 }
 
 void CAirspy::reset(void)
 {
-    SampleBuffer.FlushRingBuffer();
-    SpectrumSampleBuffer.FlushRingBuffer();
+    SampleBuffer.flush();
+    SpectrumSampleBuffer.flush();
 }
 
 int32_t CAirspy::getSamples(DSPCOMPLEX* Buffer, int32_t Size)
 {
-    return SampleBuffer.getDataFromBuffer(Buffer, Size);
+    return SampleBuffer.read(Buffer, Size);
 }
 
 std::vector<DSPCOMPLEX> CAirspy::getSpectrumSamples(int size)
 {
     std::vector<DSPCOMPLEX> buf(size);
-    int sizeRead = SpectrumSampleBuffer.getDataFromBuffer(buf.data(), size);
+    int sizeRead = SpectrumSampleBuffer.read(buf.data(), size);
     if (sizeRead < size) {
         buf.resize(sizeRead);
     }
@@ -257,7 +271,7 @@ std::vector<DSPCOMPLEX> CAirspy::getSpectrumSamples(int size)
 
 int32_t CAirspy::getSamplesToRead(void)
 {
-    return SampleBuffer.GetRingBufferReadAvailable();
+    return SampleBuffer.readAvailable();
 }
 
 int CAirspy::getGainCount()
@@ -37,7 +37,7 @@
 #include "virtual_input.h"
 #include "dab-constants.h"
 #include "MathHelper.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
 
 #include <vector>
 
@@ -90,8 +90,8 @@ private:
 
     bool sw_agc = false;
     int currentLinearityGain = 10;
-    RingBuffer<DSPCOMPLEX> SampleBuffer;
-    RingBuffer<DSPCOMPLEX> SpectrumSampleBuffer;
+    SpscRing<DSPCOMPLEX> SampleBuffer;
+    SpscRing<DSPCOMPLEX> SpectrumSampleBuffer;
     struct airspy_device *device;
 
     static int callback(airspy_transfer_t*);
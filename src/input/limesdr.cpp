@@ -45,7 +45,7 @@ lms_info_str_t limedevices [10];
 
 CLimeSDR::CLimeSDR(RadioControllerInterface &radioController) :
     radioController(radioController),
-    SampleBuffer(256 * 1024),
+    SampleBuffer(256 * 1024, true),
     SpectrumSampleBuffer(8192)
 {
     std::clog << "LimeSDR: " << "Open LimeSDR" << std::endl;
@@ -205,12 +205,21 @@ void CLimeSDR::limesdr_thread_run()
         res = LMS_RecvStream (&stream, localBuffer,
                               FIFO_SIZE,  &meta, 1000);
         if (res > 0) {
-            std::vector<DSPCOMPLEX> temp(res);
-            for (int i = 0; i < res; i ++) {
-                temp[i] = DSPCOMPLEX(localBuffer[2*i] / 2048.0, localBuffer[2*i+1] / 2048.0);
+            // Convert straight into the sample buffer, what does not
+            // fit is dropped
+            int done = 0;
+            while (done < res) {
+                const auto span = SampleBuffer.acquireWrite(res - done);
+                if (span.size == 0)
+                    break;
+                converter.fromS16(&localBuffer[2 * done], span.data,
+                        span.size, 1.0f / 2048);
+                SampleBuffer.commitWrite(span.size);
+                if (spectrumSamplesEnabled)
+                    SpectrumSampleBuffer.write(span.data, span.size);
+                done += span.size;
             }
-            SampleBuffer.putDataIntoBuffer (temp.data(), res);
-            SpectrumSampleBuffer.putDataIntoBuffer (temp.data(), res);
+            notifySamplesAvailable();
             amountRead += res;
             res = LMS_GetStreamStatus (&stream, &streamStatus);
             underruns += streamStatus. underrun;
@@ -245,18 +254,18 @@ void CLimeSDR::stop(void)
 
 void CLimeSDR::reset(void)
 {
-    SampleBuffer.FlushRingBuffer();
+    SampleBuffer.flush();
 }
 
 int32_t CLimeSDR::getSamples(DSPCOMPLEX* Buffer, int32_t Size)
 {
-    return SampleBuffer.getDataFromBuffer(Buffer, Size);
+    return SampleBuffer.read(Buffer, Size);
 }
 
 std::vector<DSPCOMPLEX> CLimeSDR::getSpectrumSamples(int size)
 {
     std::vector<DSPCOMPLEX> buf(size);
-    int sizeRead = SpectrumSampleBuffer.getDataFromBuffer(buf.data(), size);
+    int sizeRead = SpectrumSampleBuffer.read(buf.data(), size);
     if (sizeRead < size) {
         buf.resize(sizeRead);
     }
@@ -265,7 +274,7 @@ std::vector<DSPCOMPLEX> CLimeSDR::getSpectrumSamples(int size)
 
 int32_t CLimeSDR::getSamplesToRead(void)
 {
-    return SampleBuffer.GetRingBufferReadAvailable();
+    return SampleBuffer.readAvailable();
 }
 
 int CLimeSDR::getGainCount()
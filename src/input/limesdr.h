@@ -37,7 +37,8 @@
 #include "virtual_input.h"
 #include "dab-constants.h"
 #include "MathHelper.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
+#include "sample_conversion.h"
 
 
 class CLimeSDR : public CVirtualInput {
@@ -82,8 +83,9 @@ private:
     int currentLinearityGain = 10;
 
     bool sw_agc = false;
-    RingBuffer<DSPCOMPLEX> SampleBuffer;
-    RingBuffer<DSPCOMPLEX> SpectrumSampleBuffer;
+    SpscRing<DSPCOMPLEX> SampleBuffer;
+    SpscRing<DSPCOMPLEX> SpectrumSampleBuffer;
+    SampleConverter converter;
 };
 
 #endif // __LIMESDR__
@@ -30,14 +30,22 @@
  *
  */
 
+#include <algorithm>
+#include <cerrno>
 #include <string>
+#include <cstring>
 #include <iostream>
+#include <limits>
 #include <fcntl.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <sys/time.h>
 #include <time.h>
 #include <unistd.h>
+#if !defined(_WIN32)
+#  include <sys/mman.h>
+#  include <sys/stat.h>
+#endif
 
 #include "raw_file.h"
 
@@ -58,6 +66,9 @@ static inline int64_t getMyTime(void)
 
 #define INPUT_FRAMEBUFFERSIZE 8 * 32768
 
+// How much of the file to prefetch after a seek
+#define SEEK_READAHEAD (4 * 1024 * 1024)
+
 CRAWFile::CRAWFile(RadioControllerInterface& radioController,
         bool throttle, bool rewind) :
     radioController(radioController),
@@ -66,7 +77,7 @@ CRAWFile::CRAWFile(RadioControllerInterface& radioController,
     fileName(""),
     fileFormat(CRAWFileFormat::Unknown),
     IQByteSize(1),
-    SampleBuffer(INPUT_FRAMEBUFFERSIZE),
+    SampleBuffer(INPUT_FRAMEBUFFERSIZE, true),
     SpectrumSampleBuffer(8*2048)
 {
 }
@@ -74,6 +85,7 @@ CRAWFile::CRAWFile(RadioControllerInterface& radioController,
 CRAWFile::~CRAWFile(void)
 {
     ExitCondition = true;
+    wakeReader();
     if (readerOK) {
         if (thread.joinable()) {
             thread.join();
@@ -83,6 +95,12 @@ CRAWFile::~CRAWFile(void)
             fclose(filePointer);
         }
     }
+
+#if !defined(_WIN32)
+    if (mappedData) {
+        munmap(const_cast<uint8_t*>(mappedData), mappedSize);
+    }
+#endif
 }
 
 void CRAWFile::setFrequency(int Frequency)
@@ -97,8 +115,10 @@ int CRAWFile::getFrequency() const
 
 bool CRAWFile::restart(void)
 {
-    if (readerOK)
+    if (readerOK) {
         readerPausing = false;
+        wakeReader();
+    }
     return readerOK;
 }
 
@@ -119,8 +139,13 @@ void CRAWFile::reset()
 
 void CRAWFile::rewind()
 {
-    if (filePointer) {
+    if (mappedData) {
+        mappedPos = 0;
+        endReached = false;
+    }
+    else if (filePointer) {
         fseek(filePointer, 0, SEEK_SET);
+        currPos = 0;
         endReached = false;
     }
 }
@@ -178,10 +203,7 @@ void CRAWFile::setFileName(const std::string& fileName,
         return;
     }
 
-    readerOK = true;
-    readerPausing = true;
-    currPos = 0;
-    thread = std::thread(&CRAWFile::run, this);
+    startReading();
 }
 
 void CRAWFile::setFileHandle(int handle, const std::string& fileFormat)
@@ -198,30 +220,122 @@ void CRAWFile::setFileHandle(int handle, const std::string& fileFormat)
         return;
     }
 
+    startReading();
+}
+
+void CRAWFile::startReading(void)
+{
     readerOK = true;
     readerPausing = true;
     currPos = 0;
+
+    if (not throttle and mapFile()) {
+        std::clog << "RAWFile: reading " << fileName <<
+            " from memory" << std::endl;
+        return;
+    }
+
     thread = std::thread(&CRAWFile::run, this);
 }
 
+bool CRAWFile::mapFile(void)
+{
+#if !defined(_WIN32)
+    const int fd = fileno(filePointer);
+    struct stat st;
+    if (fstat(fd, &st) != 0 or not S_ISREG(st.st_mode) or
+            st.st_size < IQByteSize or
+            (uint64_t)st.st_size > std::numeric_limits<size_t>::max()) {
+        return false;
+    }
+
+    void *p = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        std::clog << "RAWFile: Cannot map file: " << strerror(errno) << std::endl;
+        return false;
+    }
+    // The file is read from start to end, let the kernel read ahead
+    madvise(p, st.st_size, MADV_SEQUENTIAL);
+
+    mappedData = static_cast<const uint8_t*>(p);
+    mappedSize = st.st_size;
+
+    // A file handle might not be at the start of the file
+    const off_t start = ftello(filePointer);
+    mappedPos = start > 0 ? start - start % IQByteSize : 0;
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool CRAWFile::seek(int64_t sampleOffset)
+{
+    if (sampleOffset < 0)
+        return false;
+
+    const int64_t offset = sampleOffset * IQByteSize;
+    if (mappedData) {
+        if ((uint64_t)offset >= mappedSize)
+            return false;
+
+#if !defined(_WIN32)
+        // Fetch the pages at the new position before they are needed
+        const size_t page = sysconf(_SC_PAGESIZE);
+        const size_t start = offset - offset % page;
+        madvise(const_cast<uint8_t*>(mappedData) + start,
+                std::min<size_t>(SEEK_READAHEAD, mappedSize - start),
+                MADV_WILLNEED);
+#endif
+        mappedPos = offset;
+    }
+    else if (filePointer) {
+        if (fseeko(filePointer, offset, SEEK_SET) != 0)
+            return false;
+
+        // Drop what the reader thread has read from the old position
+        SampleBuffer.flush();
+        SpectrumSampleBuffer.flush();
+        currPos = offset;
+    }
+    else {
+        return false;
+    }
+
+    endReached = false;
+    return true;
+}
+
 std::string CRAWFile::getFileName() const
 {
     return fileName;
 }
 
+int64_t CRAWFile::getPosition(void) const
+{
+    if (mappedData)
+        return mappedPos / IQByteSize;
+
+    return currPos / IQByteSize;
+}
+
 //	size is in I/Q pairs, file contains 8 bits values
 int32_t CRAWFile::getSamples(DSPCOMPLEX* V, int32_t size)
 {
     if (filePointer == nullptr)
         return 0;
 
-    while ((int32_t)(SampleBuffer.GetRingBufferReadAvailable()) < IQByteSize * size)
-        if (readerPausing)
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        else
-            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (mappedData)
+        return getMappedSamples(V, size);
+
+    // The reader thread wakes us up when it has put new samples
+    while (waitForSamples(size, std::chrono::milliseconds(100)) < size)
+        ;
 
-    return convertSamples(SampleBuffer, V, size);
+    const int32_t amount = convertSamples(SampleBuffer, V, size);
+    // There is space in the buffer again
+    wakeReader();
+    return amount;
 }
 
 std::vector<DSPCOMPLEX> CRAWFile::getSpectrumSamples(int size)
@@ -238,7 +352,66 @@ std::vector<DSPCOMPLEX> CRAWFile::getSpectrumSamples(int size)
 
 int32_t CRAWFile::getSamplesToRead(void)
 {
-    return SampleBuffer.GetRingBufferReadAvailable() / 2;
+    // getSamples on a mapped file never has to wait: at the end it
+    // rewinds, or gives silence like the reader thread does, unless
+    // it blocks
+    if (mappedData) {
+        if (endReached and blockAtEnd)
+            return 0;
+        return std::numeric_limits<int32_t>::max();
+    }
+
+    return SampleBuffer.readAvailable() / IQByteSize;
+}
+
+int32_t CRAWFile::getMappedSamples(DSPCOMPLEX* V, int32_t size)
+{
+    int32_t amount = 0;
+
+    while (amount < size) {
+        size_t pos = mappedPos;
+        const size_t available = (mappedSize - pos) / IQByteSize;
+
+        if (available == 0) {
+            if (autoRewind) {
+                std::clog << "RAWFile:"  << "End of file, restarting" << std::endl;
+                radioController.onMessage(message_level_t::Information,
+                        QT_TRANSLATE_NOOP("CRadioController", "End of file, restarting"));
+                SpectrumSampleBuffer.flush();
+                radioController.onRestartService();
+                mappedPos = 0;
+                continue;
+            }
+
+            if (not endReached) {
+                radioController.onMessage(message_level_t::Information,
+                        QT_TRANSLATE_NOOP("CRadioController", "End of file"));
+                endReached = true;
+            }
+            std::fill(V + amount, V + size, DSPCOMPLEX(0, 0));
+            return size;
+        }
+
+        // Convert straight from the mapped pages
+        const int32_t n = std::min<size_t>(available, size - amount);
+        const uint8_t *data = mappedData + pos;
+        convertBlock(data, V + amount, n);
+        if (spectrumSamplesEnabled)
+            SpectrumSampleBuffer.write(data, (size_t)n * IQByteSize);
+        putIntoRecordBuffer(*data, n * IQByteSize);
+        amount += n;
+
+        // Unless seek() moved the position in the meantime
+        mappedPos.compare_exchange_strong(pos, pos + (size_t)n * IQByteSize);
+    }
+
+    return amount;
+}
+
+void CRAWFile::wakeReader(void)
+{
+    { std::lock_guard<std::mutex> lock(readerMutex); }
+    readerWakeup.notify_all();
 }
 
 void CRAWFile::run(void)
@@ -256,31 +429,46 @@ void CRAWFile::run(void)
     period = (32768 * 1000) / (IQByteSize * 2048); // full IQs read
 
     std::clog << "RAWFile" << "Period =" << period << std::endl;
-    std::vector<uint8_t> bi(bufferSize);
     nextStop = getMyTime();
     while (!ExitCondition) {
         if (readerPausing) {
-            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            std::unique_lock<std::mutex> lock(readerMutex);
+            readerWakeup.wait_for(lock, std::chrono::milliseconds(100),
+                    [&]{ return ExitCondition or not readerPausing; });
             nextStop = getMyTime();
             continue;
         }
 
-        while (SampleBuffer.WriteSpace() < bufferSize + 10) {
+        while (SampleBuffer.writeAvailable() < (size_t)bufferSize + 10) {
             if (ExitCondition)
                 break;
-            std::this_thread::sleep_for(std::chrono::microseconds(100));
+            std::unique_lock<std::mutex> lock(readerMutex);
+            readerWakeup.wait_for(lock, std::chrono::milliseconds(100),
+                    [&]{ return ExitCondition or
+                         SampleBuffer.writeAvailable() >= (size_t)bufferSize + 10; });
         }
 
         nextStop += period;
-        t = readBuffer(bi.data(), bufferSize);
+        // Read the file straight into the sample buffer
+        const auto span = SampleBuffer.acquireWrite(bufferSize);
+        t = readBuffer(span.data, span.size);
+        if (t <= 0 and blockAtEnd) {
+            // Nothing more to read until the receiver stops
+            std::unique_lock<std::mutex> lock(readerMutex);
+            readerWakeup.wait_for(lock, std::chrono::milliseconds(100),
+                    [&]{ return ExitCondition.load(); });
+            nextStop = getMyTime();
+            continue;
+        }
         if (t <= 0) {
-            for (int i = 0; i < bufferSize; i++)
-                bi[i] = 0;
-            t = bufferSize;
+            memset(span.data, 0, span.size);
+            t = span.size;
         }
-        SampleBuffer.putDataIntoBuffer(bi.data(), t);
-        SpectrumSampleBuffer.putDataIntoBuffer(bi.data(), t);
-        putIntoRecordBuffer(*bi.data(), t);
+        SampleBuffer.commitWrite(t);
+        if (spectrumSamplesEnabled)
+            SpectrumSampleBuffer.write(span.data, t);
+        putIntoRecordBuffer(*span.data, t);
+        notifySamplesAvailable();
         int64_t t_to_wait = nextStop - getMyTime();
         if (throttle and t_to_wait > 0)
             std::this_thread::sleep_for(std::chrono::microseconds(t_to_wait));
@@ -305,11 +493,12 @@ int32_t CRAWFile::readBuffer(uint8_t* data, int32_t length)
     if (n < length) {
         if (autoRewind) {
             fseek(filePointer, 0, SEEK_SET);
+            currPos = 0;
             std::clog << "RAWFile:"  << "End of file, restarting" << std::endl;
             radioController.onMessage(message_level_t::Information,
                     QT_TRANSLATE_NOOP("CRadioController", "End of file, restarting"));
-            SampleBuffer.FlushRingBuffer();
-            SpectrumSampleBuffer.FlushRingBuffer();
+            SampleBuffer.flush();
+            SpectrumSampleBuffer.flush();
             radioController.onRestartService();
         }
         else {
@@ -321,48 +510,47 @@ int32_t CRAWFile::readBuffer(uint8_t* data, int32_t length)
     return n & ~01;
 }
 
-int32_t CRAWFile::convertSamples(RingBuffer<uint8_t>& Buffer, DSPCOMPLEX *V, int32_t size)
+int32_t CRAWFile::convertSamples(SpscRing<uint8_t>& Buffer, DSPCOMPLEX *V, int32_t size)
 {
-    // Native endianness complex<float> requires no conversion
-    if (fileFormat == CRAWFileFormat::COMPLEXF) {
-        int32_t amount = Buffer.getDataFromBuffer(V, IQByteSize * size);
-        return amount / IQByteSize;
+    int32_t amount = 0;
+
+    // Convert straight out of the ring buffer, one span at a time
+    while (amount < size) {
+        const auto span = Buffer.acquireRead((size_t)IQByteSize * (size - amount));
+        const int32_t n = span.size / IQByteSize;
+        if (n == 0)
+            break;
+
+        convertBlock(span.data, V + amount, n);
+        Buffer.commitRead((size_t)IQByteSize * n);
+        amount += n;
     }
 
-    std::vector<uint8_t> temp((size_t)IQByteSize * (size_t)size);
-
-    int32_t amount = Buffer.getDataFromBuffer(temp.data(), IQByteSize * size);
+    return amount;
+}
 
+void CRAWFile::convertBlock(const uint8_t *temp, DSPCOMPLEX *V, int32_t n)
+{
+    // Native endianness complex<float> requires no conversion
+    if (fileFormat == CRAWFileFormat::COMPLEXF) {
+        memcpy(V, temp, n * sizeof(DSPCOMPLEX));
+    }
     // Unsigned 8-bit
-    if (fileFormat == CRAWFileFormat::U8) {
-        for (int i = 0; i < amount / 2; i++)
-            V[i] = DSPCOMPLEX(float(temp[2 * i] - 128) / 128.0,
-                              float(temp[2 * i + 1] - 128) / 128.0);
+    else if (fileFormat == CRAWFileFormat::U8) {
+        converter.fromU8(temp, V, n);
     }
     // Signed 8-bit
     else if (fileFormat == CRAWFileFormat::S8) {
-        for (int i = 0; i < amount / 2; i++)
-            V[i] = DSPCOMPLEX(float((int8_t)temp[2 * i]) / 128.0,
-                              float((int8_t)temp[2 * i + 1]) / 128.0);
+        converter.fromS8(temp, V, n);
     }
-    // Signed 16-bit little endian
+    // Signed 16-bit, kept as it always was: the s16le reader decodes
+    // big endian samples and the s16be reader little endian ones
     else if (fileFormat == CRAWFileFormat::S16LE) {
-        for (int i = 0, j = 0; i < amount / 4; i++, j+= IQByteSize) {
-            int16_t IQ_I = (int16_t)(temp[j + 0] << 8) | temp[j + 1];
-            int16_t IQ_Q = (int16_t)(temp[j + 2] << 8) | temp[j + 3];
-            V[i] = DSPCOMPLEX((float)(IQ_I), (float)(IQ_Q));
-        }
+        converter.fromS16BE(temp, V, n, 1.0f);
     }
-    // Signed 16-bit big endian
     else if (fileFormat == CRAWFileFormat::S16BE) {
-        for (int i = 0, j = 0; i < amount / 4; i++, j += IQByteSize) {
-            int16_t IQ_I = (int16_t)(temp[j + 1] << 8) | temp[j + 0];
-            int16_t IQ_Q = (int16_t)(temp[j + 3] << 8) | temp[j + 2];
-            V[i] = DSPCOMPLEX((float)(IQ_I), (float)(IQ_Q));
-        }
+        converter.fromS16LE(temp, V, n, 1.0f);
     }
-
-    return amount / IQByteSize;
 }
 
 void CRAWFile::setFileFormat(const std::string &fileFormat)
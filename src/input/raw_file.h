@@ -35,10 +35,13 @@
 
 #include <thread>
 #include <atomic>
+#include <mutex>
+#include <condition_variable>
 
 #include "virtual_input.h"
 #include "dab-constants.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
+#include "sample_conversion.h"
 #include "radio-controller.h"
 
 // Enum of available input device
@@ -74,8 +77,18 @@ public:
     void setFileHandle(int handle, const std::string& fileFormat);
     std::string getFileName(void) const;
 
+    // Continue reading at the given sample of the file
+    bool seek(int64_t sampleOffset);
+    // The sample of the file that is read next
+    int64_t getPosition(void) const;
+    bool isMapped(void) const { return mappedData != nullptr; }
+
     bool endWasReached() const { return endReached; }
 
+    // Without rewind, give no more samples at the end of the file instead
+    // of silence, so that the receiver waits until it is stopped
+    void setBlockAtEnd(bool block) { blockAtEnd = block; }
+
 private:
     RadioControllerInterface& radioController;
     bool throttle;
@@ -84,19 +97,37 @@ private:
     CRAWFileFormat fileFormat;
     uint8_t IQByteSize = 2;
 
+    void startReading(void);
+    bool mapFile(void);
+    int32_t getMappedSamples(DSPCOMPLEX* V, int32_t size);
     void run(void);
+    void wakeReader(void);
     int32_t readBuffer(uint8_t*, int32_t);
-    int32_t convertSamples(RingBuffer<uint8_t>& Buffer, DSPCOMPLEX* V, int32_t size);
+    int32_t convertSamples(SpscRing<uint8_t>& Buffer, DSPCOMPLEX* V, int32_t size);
+    void convertBlock(const uint8_t *data, DSPCOMPLEX* V, int32_t n);
     void setFileFormat(const std::string& fileFormat);
 
-    RingBuffer<uint8_t> SampleBuffer;
-    RingBuffer<uint8_t> SpectrumSampleBuffer;
+    SpscRing<uint8_t> SampleBuffer;
+    SpscRing<uint8_t> SpectrumSampleBuffer;
+    SampleConverter converter;
     FILE* filePointer = nullptr;
     bool readerOK = false;
-    bool readerPausing = false;
+    std::atomic<bool> readerPausing = ATOMIC_VAR_INIT(false);
     bool endReached = false;
+    bool blockAtEnd = false;
     std::atomic<bool> ExitCondition = ATOMIC_VAR_INIT(false);
-    int64_t currPos = 0;
+
+    // The reader thread waits on this while paused, or when the
+    // buffer is full
+    std::mutex readerMutex;
+    std::condition_variable readerWakeup;
+    std::atomic<int64_t> currPos = ATOMIC_VAR_INIT(0);
+
+    // Without throttling, the file is mapped into memory and getSamples
+    // converts straight from the mapped pages, there is no reader thread
+    const uint8_t *mappedData = nullptr;
+    size_t mappedSize = 0;
+    std::atomic<size_t> mappedPos = ATOMIC_VAR_INIT(0);
 
     std::thread thread;
 };
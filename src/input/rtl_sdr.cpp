@@ -55,7 +55,7 @@ int __attribute__((weak)) rtlsdr_set_bias_tee(rtlsdr_dev_t *dev, int on)
 
 CRTL_SDR::CRTL_SDR(RadioControllerInterface& radioController) :
     radioController(radioController),
-    sampleBuffer(1024 * 1024),
+    sampleBuffer(1024 * 1024, true),
     spectrumSampleBuffer(8192)
 {
     open_device();
@@ -154,8 +154,8 @@ bool CRTL_SDR::restart(void)
         return true;
     }
 
-    sampleBuffer.FlushRingBuffer();
-    spectrumSampleBuffer.FlushRingBuffer();
+    sampleBuffer.flush();
+    spectrumSampleBuffer.flush();
     ret = rtlsdr_reset_buffer(device);
     if (ret < 0)
         return false;
@@ -314,18 +314,21 @@ void CRTL_SDR::agc_timer_thread(void)
 
 int32_t CRTL_SDR::getSamples(DSPCOMPLEX *buffer, int32_t size)
 {
-    std::vector<uint8_t> tempBuffer(2 * size);
+    int32_t amount = 0;
 
-    int32_t amount = sampleBuffer.getDataFromBuffer(tempBuffer.data(), 2 * size);
+    // Normalise samples, straight out of the ring buffer
+    while (amount < size) {
+        const auto span = sampleBuffer.acquireRead(2 * (size - amount));
+        const int32_t n = span.size / 2;
+        if (n == 0)
+            break;
 
-    // Normalise samples
-    for (int i = 0; i < amount / 2; i++) {
-        buffer[i] = DSPCOMPLEX(
-                (float(tempBuffer[2 * i] - 128)) / 128.0,
-                (float(tempBuffer[2 * i + 1] - 128)) / 128.0);
+        converter.fromU8(span.data, buffer + amount, n);
+        sampleBuffer.commitRead(2 * n);
+        amount += n;
     }
 
-    return amount / 2;
+    return amount;
 }
 
 std::vector<DSPCOMPLEX> CRTL_SDR::getSpectrumSamples(int size)
@@ -333,29 +336,25 @@ std::vector<DSPCOMPLEX> CRTL_SDR::getSpectrumSamples(int size)
     std::vector<uint8_t> tempBuffer(2 * size);
 
     // Get samples
-    int32_t amount = spectrumSampleBuffer.getDataFromBuffer(
+    int32_t amount = spectrumSampleBuffer.read(
             tempBuffer.data(), 2 * size);
 
     std::vector<DSPCOMPLEX> buffer(amount / 2);
 
     // Convert samples into generic format
-    for (int i = 0; i < amount / 2; i++) {
-        buffer[i] = DSPCOMPLEX(
-                (float(tempBuffer[2 * i] - 128)) / 128.0,
-                (float(tempBuffer[2 * i + 1] - 128)) / 128.0);
-    }
+    converter.fromU8(tempBuffer.data(), buffer.data(), amount / 2);
 
     return buffer;
 }
 
 int32_t CRTL_SDR::getSamplesToRead(void)
 {
-    return sampleBuffer.GetRingBufferReadAvailable() / 2;
+    return sampleBuffer.readAvailable() / 2;
 }
 
 void CRTL_SDR::reset(void)
 {
-    sampleBuffer.FlushRingBuffer();
+    sampleBuffer.flush();
 }
 
 void CRTL_SDR::rtlsdr_read_callback(uint8_t* buf, uint32_t len, void* ctx)
@@ -368,12 +367,14 @@ void CRTL_SDR::rtlsdr_read_callback(uint8_t* buf, uint32_t len, void* ctx)
             return;
         }
 
-        int32_t tmp = rtlsdr->sampleBuffer.putDataIntoBuffer(buf, len);
+        int32_t tmp = rtlsdr->sampleBuffer.write(buf, len);
         if ((len - tmp) > 0)
             rtlsdr->sampleCounter += len - tmp;
 
-        rtlsdr->spectrumSampleBuffer.putDataIntoBuffer(buf, len);
+        if (rtlsdr->spectrumSamplesEnabled)
+            rtlsdr->spectrumSampleBuffer.write(buf, len);
         rtlsdr->putIntoRecordBuffer(*buf, len);
+        rtlsdr->notifySamplesAvailable();
 
         // Check if device is overloaded
         rtlsdr->minAmplitude = 255;
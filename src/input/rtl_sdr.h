@@ -42,7 +42,8 @@
 #include "virtual_input.h"
 #include "dab-constants.h"
 #include "MathHelper.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
+#include "sample_conversion.h"
 #include "radio-controller.h"
 
 // This class is a simple wrapper around the
@@ -94,8 +95,9 @@ private:
 
     void agc_timer_thread(void);
 
-    RingBuffer<uint8_t> sampleBuffer;
-    RingBuffer<uint8_t> spectrumSampleBuffer;
+    SpscRing<uint8_t> sampleBuffer;
+    SpscRing<uint8_t> spectrumSampleBuffer;
+    SampleConverter converter;
     struct rtlsdr_dev *device = nullptr;
     int32_t sampleCounter = 0;
 
@@ -72,8 +72,8 @@ static inline int64_t getMyTime(void)
 
 CRTL_TCP_Client::CRTL_TCP_Client(RadioControllerInterface& radioController) :
     radioController(radioController),
-    sampleBuffer(32 * 32768),
-    sampleNetworkBuffer(256 * 32768),
+    sampleBuffer(32 * 32768, true),
+    sampleNetworkBuffer(256 * 32768, true),
     spectrumSampleBuffer(8192)
 {
     memset(&dongleInfo, 0, sizeof(dongle_info_t));
@@ -156,29 +156,34 @@ void CRTL_TCP_Client::stop(void)
 }
 
 static int32_t read_convert_from_buffer(
-        RingBuffer<uint8_t>& buffer,
+        SpscRing<uint8_t>& buffer, const SampleConverter& converter,
         DSPCOMPLEX *v, int32_t size)
 {
-    int32_t amount, i;
-    std::vector<uint8_t> tempBuffer(2 * size);
+    int32_t amount = 0;
 
-    // Get data from the ring buffer
-    amount = buffer.getDataFromBuffer(tempBuffer.data(), 2 * size);
-    for (i = 0; i < amount / 2; i ++)
-        v[i] = DSPCOMPLEX(((float)tempBuffer[2 * i] - 128.0f) / 128.0f,
-                          ((float)tempBuffer[2 * i + 1] - 128.0f) / 128.0f);
-    return amount / 2;
+    // Convert straight out of the ring buffer, one span at a time
+    while (amount < size) {
+        const auto span = buffer.acquireRead(2 * (size - amount));
+        const int32_t n = span.size / 2;
+        if (n == 0)
+            break;
+
+        converter.fromU8(span.data, v + amount, n);
+        buffer.commitRead(2 * n);
+        amount += n;
+    }
+    return amount;
 }
 
 int32_t CRTL_TCP_Client::getSamples(DSPCOMPLEX *v, int32_t size)
 {
-    return read_convert_from_buffer(sampleBuffer, v, size);
+    return read_convert_from_buffer(sampleBuffer, converter, v, size);
 }
 
 std::vector<DSPCOMPLEX> CRTL_TCP_Client::getSpectrumSamples(int size)
 {
     std::vector<DSPCOMPLEX> buffer(size);
-    int sizeRead = read_convert_from_buffer(spectrumSampleBuffer, buffer.data(), size);
+    int sizeRead = read_convert_from_buffer(spectrumSampleBuffer, converter, buffer.data(), size);
     if (sizeRead < size) {
         buffer.resize(sizeRead);
     }
@@ -187,14 +192,14 @@ std::vector<DSPCOMPLEX> CRTL_TCP_Client::getSpectrumSamples(int size)
 
 int32_t CRTL_TCP_Client::getSamplesToRead(void)
 {
-    return sampleBuffer.GetRingBufferReadAvailable() / 2;
+    return sampleBuffer.readAvailable() / 2;
 }
 
 void CRTL_TCP_Client::reset(void)
 {
-    sampleBuffer.FlushRingBuffer();
-    sampleNetworkBuffer.FlushRingBuffer();
-    spectrumSampleBuffer.FlushRingBuffer();
+    sampleBuffer.flush();
+    sampleNetworkBuffer.flush();
+    spectrumSampleBuffer.flush();
     firstFilledNetworkBuffer = false;
 }
 
@@ -295,11 +300,11 @@ void CRTL_TCP_Client::receiveData(void)
         }
     }
 
-    sampleNetworkBuffer.putDataIntoBuffer(buffer.data(), buffer.size());
+    sampleNetworkBuffer.write(buffer.data(), buffer.size());
 
     // First fill the complete buffer to avoid sound outtages if the stream data rate is not stable e.g. over WIFI
     if(!firstFilledNetworkBuffer) {
-        float bufferFill = (float) sampleNetworkBuffer.GetRingBufferReadAvailable() / sampleNetworkBuffer.GetBufferSize() * 100;
+        float bufferFill = (float) sampleNetworkBuffer.readAvailable() / sampleNetworkBuffer.capacity() * 100;
 
         // Wait for 50% filled buffer
         if(bufferFill >= 50)
@@ -484,8 +489,6 @@ void CRTL_TCP_Client::receiveAndReconnect()
 #define NETWORK_BUFFER_READ_SAMPLES 32768
 void CRTL_TCP_Client::networkBufferCopy()
 {
-    std::vector<uint8_t> tempBuffer(NETWORK_BUFFER_READ_SAMPLES * 2);
-
     while (rtlsdrRunning) {
         if(!firstFilledNetworkBuffer) {
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
@@ -496,7 +499,7 @@ void CRTL_TCP_Client::networkBufferCopy()
         int32_t samples = NETWORK_BUFFER_READ_SAMPLES;
 
         // Figure out the max samples to read from network buffer
-        int32_t samplesInBuffer = sampleNetworkBuffer.GetRingBufferReadAvailable() / 2;
+        int32_t samplesInBuffer = sampleNetworkBuffer.readAvailable() / 2;
         if(samplesInBuffer < samples)
             samples = samplesInBuffer;
 
@@ -506,16 +509,24 @@ void CRTL_TCP_Client::networkBufferCopy()
             continue;
         }
 
-        // Read data
-        int32_t amount = sampleNetworkBuffer.getDataFromBuffer(tempBuffer.data(), 2 * samples);
-
-        // Write data to standard buffers
-        sampleBuffer.putDataIntoBuffer(tempBuffer.data(), amount);
-        spectrumSampleBuffer.putDataIntoBuffer(tempBuffer.data(), amount);
+        // Copy the data straight from the network buffer to the
+        // standard buffers
+        int32_t amount = 0;
+        while (amount < 2 * samples) {
+            const auto span = sampleNetworkBuffer.acquireRead(2 * samples - amount);
+            if (span.size == 0)
+                break;
+            sampleBuffer.write(span.data, span.size);
+            if (spectrumSamplesEnabled)
+                spectrumSampleBuffer.write(span.data, span.size);
+            sampleNetworkBuffer.commitRead(span.size);
+            amount += span.size;
+        }
+        notifySamplesAvailable();
 
         if(getMyTime() - oldTime_us > 500e3) { // 500 ms
 
-            // float bufferFill = (float) sampleNetworkBuffer.GetRingBufferReadAvailable() / sampleNetworkBuffer.GetBufferSize() * 100;
+            // float bufferFill = (float) sampleNetworkBuffer.readAvailable() / sampleNetworkBuffer.capacity() * 100;
             //std::clog << "RTL_TCP_CLIENT: Network buffer fill level " << bufferFill << "%" << std::endl;
 
             oldTime_us = getMyTime();
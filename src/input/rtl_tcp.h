@@ -41,7 +41,8 @@
 #include "virtual_input.h"
 #include "dab-constants.h"
 #include "MathHelper.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
+#include "sample_conversion.h"
 #include "radio-controller.h"
 
 struct dongle_info_t { /* structure size must be multiple of 2 bytes */
@@ -99,9 +100,10 @@ private:
     bool isAGC = true;
     bool isHwAGC = false;
     int frequency = kHz(220000);
-    RingBuffer<uint8_t> sampleBuffer;
-    RingBuffer<uint8_t> sampleNetworkBuffer;
-    RingBuffer<uint8_t> spectrumSampleBuffer;
+    SpscRing<uint8_t> sampleBuffer;
+    SpscRing<uint8_t> sampleNetworkBuffer;
+    SpscRing<uint8_t> spectrumSampleBuffer;
+    SampleConverter converter;
     bool connected = false;
     bool rtlsdrRunning = false;
     std::string serverAddress = "127.0.0.1";
@@ -44,7 +44,7 @@ using namespace std;
 
 CSoapySdr::CSoapySdr(RadioControllerInterface& radioController) :
     radioController(radioController),
-    m_sampleBuffer(1024 * 1024),
+    m_sampleBuffer(1024 * 1024, true),
     m_spectrumSampleBuffer(8192)
 {
     //enumerate devices
@@ -95,8 +95,8 @@ bool CSoapySdr::restart()
         return true;
     }
 
-    m_sampleBuffer.FlushRingBuffer();
-    m_spectrumSampleBuffer.FlushRingBuffer();
+    m_sampleBuffer.flush();
+    m_spectrumSampleBuffer.flush();
 
     try {
         m_device = SoapySDR::Device::make(m_driver_args);
@@ -198,19 +198,19 @@ void CSoapySdr::stop()
 
 void CSoapySdr::reset()
 {
-    m_sampleBuffer.FlushRingBuffer();
+    m_sampleBuffer.flush();
 }
 
 int32_t CSoapySdr::getSamples(DSPCOMPLEX *Buffer, int32_t Size)
 {
-    int32_t amount = m_sampleBuffer.getDataFromBuffer(Buffer, Size);
+    int32_t amount = m_sampleBuffer.read(Buffer, Size);
     return amount;
 }
 
 std::vector<DSPCOMPLEX> CSoapySdr::getSpectrumSamples(int size)
 {
     std::vector<DSPCOMPLEX> sampleBuffer(size);
-    int32_t amount = m_spectrumSampleBuffer.getDataFromBuffer(sampleBuffer.data(), size);
+    int32_t amount = m_spectrumSampleBuffer.read(sampleBuffer.data(), size);
     if (amount < size) {
         sampleBuffer.resize(amount);
     }
@@ -219,7 +219,7 @@ std::vector<DSPCOMPLEX> CSoapySdr::getSpectrumSamples(int size)
 
 int32_t CSoapySdr::getSamplesToRead()
 {
-    return m_sampleBuffer.GetRingBufferReadAvailable();
+    return m_sampleBuffer.readAvailable();
 }
 
 float CSoapySdr::getGain() const
@@ -381,6 +381,8 @@ void CSoapySdr::workerthread()
 void CSoapySdr::process(SoapySDR::Stream *stream)
 {
     size_t frames = 0;
+    // Only used when the sample buffer is full
+    std::vector<DSPCOMPLEX> buf;
     while (m_running) {
         frames++;
 
@@ -388,10 +390,17 @@ void CSoapySdr::process(SoapySDR::Stream *stream)
         const size_t mtu = m_device->getStreamMTU(stream);
 
         const size_t samps_to_read = mtu; // Always read MTU samples
-        std::vector<DSPCOMPLEX> buf(samps_to_read);
+
+        // Read straight into the sample buffer if there is space
+        const auto span = m_sampleBuffer.acquireWrite(samps_to_read);
+        const bool inPlace = span.size == samps_to_read;
+        if (not inPlace) {
+            buf.resize(samps_to_read);
+        }
+        DSPCOMPLEX *samples = inPlace ? span.data : buf.data();
 
         void *buffs[1];
-        buffs[0] = buf.data();
+        buffs[0] = samples;
 
         int flags = 0;
         long long timeNs = 0;
@@ -415,11 +424,10 @@ void CSoapySdr::process(SoapySDR::Stream *stream)
             m_running = false;
         }
         else {
-            buf.resize(ret);
-
             if (m_sw_agc and (frames % 200) == 0) {
                 float maxnorm = 0;
-                for (const DSPCOMPLEX& z : buf) {
+                for (int i = 0; i < ret; i++) {
+                    const DSPCOMPLEX& z = samples[i];
                     if (norm(z) > maxnorm) {
                         maxnorm = norm(z);
                     }
@@ -435,8 +443,15 @@ void CSoapySdr::process(SoapySDR::Stream *stream)
                 }
             }
 
-            m_sampleBuffer.putDataIntoBuffer(buf.data(), ret);
-            m_spectrumSampleBuffer.putDataIntoBuffer(buf.data(), ret);
+            if (inPlace) {
+                m_sampleBuffer.commitWrite(ret);
+            }
+            else {
+                m_sampleBuffer.write(samples, ret);
+            }
+            if (spectrumSamplesEnabled)
+                m_spectrumSampleBuffer.write(samples, ret);
+            notifySamplesAvailable();
         }
     }
 }
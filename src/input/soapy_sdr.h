@@ -29,7 +29,7 @@
 #include <atomic>
 #include <thread>
 #include "virtual_input.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
 #include <SoapySDR/Version.hpp>
 #include <SoapySDR/Modules.hpp>
 #include <SoapySDR/Registry.hpp>
@@ -78,8 +78,8 @@ private:
     std::atomic<bool> m_running = ATOMIC_VAR_INIT(false);
     bool m_sw_agc = false;
 
-    RingBuffer<DSPCOMPLEX> m_sampleBuffer;
-    RingBuffer<DSPCOMPLEX> m_spectrumSampleBuffer;
+    SpscRing<DSPCOMPLEX> m_sampleBuffer;
+    SpscRing<DSPCOMPLEX> m_spectrumSampleBuffer;
 
     std::vector<double> m_gains;
 
@@ -30,13 +30,16 @@
 #ifndef __VIRTUAL_INPUT
 #define __VIRTUAL_INPUT
 
+#include <atomic>
 #include <memory>
 #include <fstream>
 #include <iostream>
+#include <mutex>
+#include <condition_variable>
 
 #include "dab-constants.h"
 #include "radio-controller.h"
-#include "ringbuffer.h"
+#include "spsc_ring.h"
 
 enum class CDeviceID {
     UNKNOWN, NULLDEVICE, AIRSPY, RAWFILE, RTL_SDR, RTL_TCP, SOAPYSDR, ANDROID_RTL_SDR, LIMESDR};
@@ -46,6 +49,18 @@ public:
     virtual ~CVirtualInput() {}
     virtual CDeviceID getID(void) = 0;
 
+    virtual int32_t waitForSamples(int32_t n,
+            std::chrono::milliseconds timeout) override {
+        std::unique_lock<std::mutex> lock(samplesMutex);
+        samplesAvailable.wait_for(lock, timeout,
+                [&]{ return getSamplesToRead() >= n; });
+        return getSamplesToRead();
+    }
+
+    virtual void setSpectrumSamplesEnabled(bool enabled) override {
+        spectrumSamplesEnabled = enabled;
+    }
+
     void writeRecordBufferToFile(std::string &fileanme) {
         if(!recordBuffer)
             return;
@@ -53,46 +68,56 @@ public:
         std::ofstream rawStream(fileanme, std::ios::binary);
 
         while (1) {
-            uint8_t data_tmp[1024];
-            const auto available = recordBuffer->GetRingBufferReadAvailable();
+            const auto span = recordBuffer->acquireRead(recordBuffer->capacity());
 
-            if (available <= 0) {
+            if (span.size == 0) {
                 break;
             }
 
-            const size_t data_tmpSize = std::min(sizeof(data_tmp), (size_t)available);
-            recordBuffer->getDataFromBuffer(data_tmp, data_tmpSize);
-            rawStream.write((char*)data_tmp, data_tmpSize);
+            rawStream.write((const char*)span.data, span.size);
+            recordBuffer->commitRead(span.size);
         }
 
         rawStream.close();
     }
 
     void initRecordBuffer(uint32_t size) {
-        // The ring buffer size has to be power of 2
-        uint32_t bitCount = ceil(log2(size));
-        uint32_t bufferSize = pow(2, bitCount);
-
+        // The ring buffer rounds the size up to a power of 2
         try {
-            recordBuffer.reset(new RingBuffer<uint8_t>(bufferSize));
+            recordBuffer.reset(new SpscRing<uint8_t>(size));
         }
 
         catch (const std::bad_alloc& e) {
-                std::clog << "CVirtualInput: recordBuffer allocation failed (size " << bufferSize * sizeof(uint8_t) << " bytes) : " << e.what() << std::endl;
+                std::clog << "CVirtualInput: recordBuffer allocation failed (size " << size * sizeof(uint8_t) << " bytes) : " << e.what() << std::endl;
         }
     }
 
 protected:
-    void putIntoRecordBuffer(uint8_t &data, uint32_t size) {
+    /* The inputs call this after they put samples into their buffer,
+     * to wake up the consumer blocked in waitForSamples(). */
+    void notifySamplesAvailable(void) {
+        // Taking the mutex makes sure the consumer is either waiting, or
+        // has not yet checked the buffer and will see the new samples.
+        { std::lock_guard<std::mutex> lock(samplesMutex); }
+        samplesAvailable.notify_all();
+    }
+
+    /* The inputs only fill their spectrum sample buffer while someone
+     * is subscribed to the spectrum. */
+    std::atomic<bool> spectrumSamplesEnabled = ATOMIC_VAR_INIT(true);
+
+    void putIntoRecordBuffer(const uint8_t &data, uint32_t size) {
         if(!recordBuffer)
             return;
 
-        recordBuffer->putDataIntoBuffer(&data, static_cast<int>(size));
-        //std::clog << "CVirtualInput: GetRingBufferReadAvailable() " << recordBuffer->GetRingBufferReadAvailable() << std::endl;
+        recordBuffer->write(&data, size);
     }
 
 private:
-    std::unique_ptr<RingBuffer<uint8_t>> recordBuffer;
+    std::unique_ptr<SpscRing<uint8_t>> recordBuffer;
+
+    std::mutex samplesMutex;
+    std::condition_variable samplesAvailable;
 };
 
 #endif
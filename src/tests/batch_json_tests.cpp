@@ -0,0 +1,121 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+
+/**
+ * @file batch_json_tests.cpp
+ * @brief The JSON line that the batch mode of welle-cli prints per file
+ *
+ * The batch decoder stops the receiver, which clears the ensemble, before
+ * it reports. The report must come from the snapshot taken before. The
+ * receiver is replaced by a FIBProcessor, which is where it keeps the
+ * ensemble.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ensemble_test_helpers.h"
+#include "welle-cli/jsonconvert.h"
+#include "welle-cli/batchreport.h"
+#include "libs/json.hpp"
+#include <memory>
+#include <string>
+#include <vector>
+
+// Stops like RadioReceiver::stop, which clears the ensemble
+class StoppableReceiver {
+    public:
+        explicit StoppableReceiver(FIBProcessor& fib) : fib(fib) { }
+
+        std::shared_ptr<const EnsembleSnapshot> getEnsembleSnapshot() const
+        {
+            return fib.getEnsembleSnapshot();
+        }
+
+        void stop() { fib.clearEnsemble(); }
+
+    private:
+        FIBProcessor& fib;
+};
+
+// What BatchDecoder::decodeFile reports once the file is read
+static nlohmann::json reportAfterStop(FIBProcessor& fib,
+        const BatchProgrammeHandlers& handlers = BatchProgrammeHandlers())
+{
+    BatchFileJson result;
+    result.file = "test.iq";
+
+    StoppableReceiver rx(fib);
+    stop_and_report(rx, result.mux, handlers);
+    return nlohmann::json::parse(build_batch_file_json(result));
+}
+
+TEST_CASE("The batch report lists the services of the file", "[batch]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+    fib.preloadEnsemble(oneServiceEnsemble());
+
+    const auto j = reportAfterStop(fib);
+    REQUIRE(fib.getEnsembleSnapshot()->services.empty());
+
+    REQUIRE(j["mux"]["ensemble"]["id"] == "0x4fff");
+    const auto& services = j["mux"]["services"];
+    REQUIRE(services.size() == 1);
+    REQUIRE(services[0]["sid"] == "0x4daa");
+    REQUIRE(services[0]["components"].size() == 1);
+    REQUIRE(services[0]["components"][0]["subchannel"]["subchid"] == 3);
+}
+
+TEST_CASE("The batch report counts the errors of the decoded services", "[batch]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+    fib.preloadEnsemble(oneServiceEnsemble());
+
+    REQUIRE(reportAfterStop(fib)["mux"]["services"][0]["mode"] == "invalid");
+
+    fib.preloadEnsemble(oneServiceEnsemble());
+    BatchProgrammeHandlers handlers;
+    auto handler = std::make_unique<BatchProgrammeHandler>();
+    handler->onNewAudio(std::vector<int16_t>(), 48000, "DAB+");
+    handler->onFrameErrors(2);
+    handler->onAacErrors(1);
+    handlers.emplace(0x4daa, std::move(handler));
+
+    const auto service = reportAfterStop(fib, handlers)["mux"]["services"][0];
+    REQUIRE(service["mode"] == "DAB+");
+    REQUIRE(service["samplerate"] == 48000);
+    REQUIRE(service["errorcounters"]["frameerrors"] == 2);
+    REQUIRE(service["errorcounters"]["aacerrors"] == 1);
+}
+
+TEST_CASE("The batch report of a file without ensemble has no services", "[batch]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+
+    const auto j = reportAfterStop(fib);
+    REQUIRE(j["mux"]["services"].empty());
+}
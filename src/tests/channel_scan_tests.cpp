@@ -0,0 +1,212 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+
+/**
+ * @file channel_scan_tests.cpp
+ * @brief Classification of channels by the SignalDetector, and the dwell
+ * of the scan on a channel with a DAB signal
+ *
+ * The signals are synthetic transmission mode I frames: a null symbol
+ * followed by 76 OFDM symbols of random QPSK on the 1536 carriers, with
+ * white noise on top.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/channel-scan.h"
+#include "../backend/fib-processor.h"
+#include <chrono>
+#include <random>
+#include <thread>
+#include <vector>
+
+using Verdict = SignalDetector::Verdict;
+
+static std::vector<DSPCOMPLEX> ofdm_signal(const DABParams& params,
+        int frames, bool withNull, float noiseLevel, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> noise(0.0f, noiseLevel);
+    std::uniform_int_distribution<int> bit(0, 1);
+    fft::Backward ifft(params.T_u);
+    DSPCOMPLEX *bins = ifft.getVector();
+
+    std::vector<DSPCOMPLEX> v;
+    v.reserve(frames * params.T_F);
+    for (int f = 0; f < frames; f++) {
+        const size_t frameStart = v.size();
+        if (withNull) {
+            v.resize(v.size() + params.T_null);
+        }
+        while ((int32_t)(v.size() - frameStart) < params.T_F) {
+            std::fill(bins, bins + params.T_u, DSPCOMPLEX(0, 0));
+            for (int k = 1; k <= params.K / 2; k++) {
+                bins[k] = DSPCOMPLEX(bit(gen) ? 1 : -1, bit(gen) ? 1 : -1);
+                bins[params.T_u - k] = DSPCOMPLEX(bit(gen) ? 1 : -1, bit(gen) ? 1 : -1);
+            }
+            ifft.do_IFFT();
+
+            // Cyclic prefix, then the symbol
+            v.insert(v.end(), bins + params.T_u - params.guardLength, bins + params.T_u);
+            v.insert(v.end(), bins, bins + params.T_u);
+        }
+        v.resize(frameStart + params.T_F);
+    }
+
+    // The same SNR whatever the scaling of the IFFT
+    double power = 0;
+    for (const auto& z : v) {
+        power += std::norm(z);
+    }
+    const float scale = 1 / std::sqrt(power / v.size());
+    for (auto& z : v) {
+        z = z * scale + DSPCOMPLEX(noise(gen), noise(gen));
+    }
+    return v;
+}
+
+static std::vector<DSPCOMPLEX> noise_signal(size_t length, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> noise(0.0f, 1.0f);
+    std::vector<DSPCOMPLEX> v(length);
+    for (auto& z : v) {
+        z = DSPCOMPLEX(noise(gen), noise(gen));
+    }
+    return v;
+}
+
+// Give the samples from offset on, T_u at a time, until a verdict
+static Verdict classify(SignalDetector& detector, const DABParams& params,
+        const std::vector<DSPCOMPLEX>& v, size_t offset = 0)
+{
+    detector.reset();
+    for (size_t i = offset; i + params.T_u <= v.size(); i += params.T_u) {
+        const auto verdict = detector.process(&v[i]);
+        if (verdict != Verdict::Undecided) {
+            return verdict;
+        }
+    }
+    return Verdict::Undecided;
+}
+
+TEST_CASE("An empty channel is abandoned after the energy test", "[channel_scan]")
+{
+    DABParams params(1);
+    SignalDetector detector(params);
+
+    const auto v = noise_signal(3 * params.T_F, 1);
+    REQUIRE(classify(detector, params, v) == Verdict::Empty);
+    REQUIRE(detector.getSamplesUsed() ==
+            SignalDetector::energyBlocks * params.T_u);
+    REQUIRE(detector.getBandRatio() < 1.0f);
+
+    // Nothing at all, as from a stopped input
+    const std::vector<DSPCOMPLEX> zeros(3 * params.T_F);
+    REQUIRE(classify(detector, params, zeros) == Verdict::Empty);
+}
+
+TEST_CASE("A DAB signal is recognised by its null symbols", "[channel_scan]")
+{
+    DABParams params(1);
+    SignalDetector detector(params);
+
+    // 10 dB and 3 dB SNR, the frames starting anywhere in the samples
+    for (const float noiseLevel : { 0.22f, 0.5f }) {
+        const auto v = ofdm_signal(params, 4, true, noiseLevel, 2);
+        for (const size_t offset : { 0, 1000, 100000, 196000 }) {
+            CAPTURE(noiseLevel);
+            CAPTURE(offset);
+            REQUIRE(classify(detector, params, v, offset) == Verdict::Dab);
+            REQUIRE(detector.getSamplesUsed() ==
+                    SignalDetector::frameCount * params.T_F);
+            REQUIRE(detector.getBandRatio() > 3.0f);
+            REQUIRE(detector.getNullDepth() < SignalDetector::nullThreshold);
+        }
+    }
+}
+
+TEST_CASE("A signal without null symbols is not DAB", "[channel_scan]")
+{
+    DABParams params(1);
+    SignalDetector detector(params);
+
+    const auto v = ofdm_signal(params, 3, false, 0.22f, 3);
+    REQUIRE(classify(detector, params, v) == Verdict::NotDab);
+    REQUIRE(detector.getBandRatio() > 3.0f);
+    REQUIRE(detector.getNullDepth() > SignalDetector::nullThreshold);
+
+    // A single deep fade does not repeat in the next frame
+    auto faded = v;
+    std::fill(faded.begin() + 5000, faded.begin() + 5000 + params.T_null,
+            DSPCOMPLEX(0, 0));
+    REQUIRE(classify(detector, params, faded) == Verdict::NotDab);
+}
+
+TEST_CASE("The scan dwells until the ensemble is complete", "[channel_scan]")
+{
+    using std::chrono::milliseconds;
+
+    EnsembleSnapshot ensemble;
+    ensemble.version = 1;
+
+    ScanDwell dwell(milliseconds(50), milliseconds(2000));
+    dwell.start();
+    REQUIRE_FALSE(dwell.isDone(ensemble));
+
+    // A service without label is not enough
+    ensemble.version++;
+    ensemble.ensembleLabel.fig1_label = "Ensemble";
+    ensemble.services.push_back(Service(0x4001));
+    std::this_thread::sleep_for(milliseconds(60));
+    REQUIRE_FALSE(dwell.isDone(ensemble));
+    REQUIRE_FALSE(dwell.isComplete());
+
+    ensemble.version++;
+    ensemble.services.back().serviceLabel.fig1_label = "Radio";
+    REQUIRE_FALSE(dwell.isDone(ensemble));
+    REQUIRE(dwell.isComplete());
+
+    std::this_thread::sleep_for(milliseconds(60));
+    REQUIRE(dwell.isDone(ensemble));
+    REQUIRE(dwell.elapsed() < milliseconds(2000));
+}
+
+TEST_CASE("The scan gives up on an ensemble that never completes", "[channel_scan]")
+{
+    using std::chrono::milliseconds;
+
+    EnsembleSnapshot ensemble;
+    ScanDwell dwell(milliseconds(10), milliseconds(50));
+    dwell.start();
+    REQUIRE_FALSE(dwell.isDone(ensemble));
+
+    std::this_thread::sleep_for(milliseconds(60));
+    REQUIRE(dwell.isDone(ensemble));
+    REQUIRE_FALSE(dwell.isComplete());
+}
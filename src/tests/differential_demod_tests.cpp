@@ -0,0 +1,166 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * @file differential_demod_tests.cpp
+ * @brief Validation and throughput of the differential demodulator
+ *
+ * Every kernel must give the same soft bits, bit for bit, as the per
+ * carrier loop the OfdmDecoder used before, in all transmission modes,
+ * and whether or not it is specialised for mode I.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/differential-demod.h"
+#include "../backend/freq-interleaver.h"
+#include "../various/MathHelper.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static std::vector<DSPCOMPLEX> random_spectrum(const DABParams& params, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> distr(-100.0f, 100.0f);
+    std::vector<DSPCOMPLEX> v(params.T_u);
+    for (auto& s : v) {
+        s = DSPCOMPLEX(distr(gen), distr(gen));
+    }
+    return v;
+}
+
+// The loop of OfdmDecoder::decodeDataSymbol
+static std::vector<softbit_t> reference_bits(const DABParams& params,
+        const std::vector<DSPCOMPLEX>& spectrum,
+        const std::vector<DSPCOMPLEX>& reference)
+{
+    FrequencyInterleaver interleaver(params);
+    std::vector<softbit_t> ibits(2 * params.K);
+    for (int16_t i = 0; i < params.K; i ++) {
+        int16_t index = interleaver.mapIn(i);
+        if (index < 0)
+            index += params.T_u;
+        const DSPCOMPLEX r1 = spectrum[index] * conj (reference[index]);
+        const DSPFLOAT ab1 = 127.0f / l1_norm(r1);
+        ibits[i]            = -real (r1) * ab1;
+        ibits[params.K + i] = -imag (r1) * ab1;
+    }
+    return ibits;
+}
+
+TEST_CASE("All kernels match the per carrier loop", "[demod]") {
+    for (int mode = 1; mode <= 4; mode++) {
+        DABParams params(mode);
+        const auto spectrum = random_spectrum(params, mode);
+        const auto reference = random_spectrum(params, mode + 10);
+        const auto expected = reference_bits(params, spectrum, reference);
+
+        for (const auto kernel : DifferentialDemodulator::availableKernels()) {
+            for (const bool specialise : {true, false}) {
+                INFO("mode " << mode << " " << DifferentialDemodulator::kernelName(kernel) <<
+                        " specialise " << specialise);
+                const DifferentialDemodulator demodulator(params, kernel, specialise);
+                REQUIRE(demodulator.getKernel() == kernel);
+                REQUIRE(demodulator.isSpecialised() == (specialise and mode == 1));
+
+                std::vector<softbit_t> bits(2 * params.K);
+                demodulator.demodulate(spectrum.data(), reference.data(), bits.data());
+                REQUIRE(bits == expected);
+            }
+        }
+    }
+}
+
+TEST_CASE("The mode I dimensions are those of DABParams", "[demod]") {
+    DABParams params(1);
+    REQUIRE(params.L == DABModeI::L);
+    REQUIRE(params.K == DABModeI::K);
+    REQUIRE(params.T_s == DABModeI::T_s);
+    REQUIRE(params.T_u == DABModeI::T_u);
+}
+
+TEST_CASE("The carrier indexes are those of the interleaver", "[demod]") {
+    DABParams params(1);
+    FrequencyInterleaver interleaver(params);
+    const DifferentialDemodulator demodulator(params);
+    for (int16_t i = 0; i < params.K; i++) {
+        int16_t index = interleaver.mapIn(i);
+        if (index < 0)
+            index += params.T_u;
+        REQUIRE(demodulator.carrierIndex(i) == index);
+    }
+}
+
+TEST_CASE("Carriers without energy give zero soft bits", "[demod]") {
+    DABParams params(1);
+    auto spectrum = random_spectrum(params, 3);
+    auto reference = random_spectrum(params, 4);
+    const DifferentialDemodulator probe(params);
+    for (int32_t i = 0; i < params.K; i += 7) {
+        spectrum[probe.carrierIndex(i)] = 0;
+        if (i % 2) {
+            reference[probe.carrierIndex(i)] = 0;
+        }
+    }
+
+    for (const auto kernel : DifferentialDemodulator::availableKernels()) {
+        INFO(DifferentialDemodulator::kernelName(kernel));
+        const DifferentialDemodulator demodulator(params, kernel);
+        std::vector<softbit_t> bits(2 * params.K, 1);
+        demodulator.demodulate(spectrum.data(), reference.data(), bits.data());
+        for (int32_t i = 0; i < params.K; i += 7) {
+            REQUIRE(bits[i] == 0);
+            REQUIRE(bits[params.K + i] == 0);
+        }
+    }
+}
+
+TEST_CASE("Differential demodulator throughput", "[demod][benchmark]") {
+    DABParams params(1);
+    const int frames = 1000;
+    const auto spectrum = random_spectrum(params, 1);
+    const auto reference = random_spectrum(params, 2);
+    std::vector<softbit_t> bits(2 * params.K);
+
+    for (const auto kernel : DifferentialDemodulator::availableKernels()) {
+        for (const bool specialise : {false, true}) {
+            const DifferentialDemodulator demodulator(params, kernel, specialise);
+            const auto start = std::chrono::steady_clock::now();
+            for (int i = 0; i < frames * (params.L - 1); i++) {
+                demodulator.demodulate(spectrum.data(), reference.data(), bits.data());
+            }
+            const std::chrono::duration<double> elapsed =
+                std::chrono::steady_clock::now() - start;
+            std::cout << "Differential demodulation, " <<
+                DifferentialDemodulator::kernelName(kernel) <<
+                (specialise ? ", mode I: " : ", any mode: ") <<
+                frames / elapsed.count() << " TM1 frames/s" << std::endl;
+        }
+    }
+}
@@ -0,0 +1,170 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+
+/**
+ * @file ensemble_test_helpers.h
+ * @brief What the tests of the FIBProcessor and of its users share: a
+ * controller that ignores the receiver, FIBs built bit by bit, and a
+ * cached ensemble with one service
+ */
+
+#pragma once
+
+#include "../backend/fib-processor.h"
+#include "../backend/ensemble-cache.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Ignores the receiver, but counts the restarts and, with fib set, the
+// services that are in the snapshot when they are announced
+class SilentController : public RadioControllerInterface {
+    public:
+        virtual void onSNR(float snr) override { (void)snr; }
+        virtual void onFrequencyCorrectorChange(int fine, int coarse) override { (void)fine; (void)coarse; }
+        virtual void onSyncChange(char isSync) override { (void)isSync; }
+        virtual void onSignalPresence(bool isSignal) override { (void)isSignal; }
+        virtual void onServiceDetected(uint32_t sId) override {
+            // What the callback announces is already in the snapshot
+            if (fib) {
+                servicesDetectedInSnapshot += fib->getService(sId).serviceId == sId;
+            }
+        }
+        virtual void onNewEnsemble(uint16_t /*eId*/) override { }
+        virtual void onSetEnsembleLabel(DabLabel& /*label*/) override { }
+        virtual void onDateTimeUpdate(const dab_date_time_t& dateTime) override { (void)dateTime; }
+        virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override { (void)crcCheckOk; (void)fib; }
+        virtual void onNewImpulseResponse(std::vector<float>&& data) override { (void)data; }
+        virtual void onNewNullSymbol(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
+        virtual void onConstellationPoints(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
+        virtual void onMessage(message_level_t level, const std::string& text, const std::string& text2 = std::string()) override { (void)level; (void)text; (void)text2; }
+        virtual void onTIIMeasurement(tii_measurement_t&& m) override { (void)m; }
+        virtual void onRestartService(void) override { restarts++; }
+
+        FIBProcessor *fib = nullptr;
+        int servicesDetectedInSnapshot = 0;
+        int restarts = 0;
+};
+
+// Assembles the 256 bits of a FIB, one bit per byte as the FicHandler
+// gives them, padded with end markers
+class FibBuilder {
+    public:
+        void put(uint32_t value, int bits) {
+            for (int i = bits - 1; i >= 0; i--) {
+                fib.push_back((value >> i) & 1);
+            }
+        }
+
+        // FIG 0/0 with the ensemble id
+        FibBuilder& ensemble(uint16_t eId) {
+            put(0, 3); put(5, 5);
+            put(0, 3); put(0, 5);
+            put(eId, 16);
+            put(0, 16);
+            return *this;
+        }
+
+        // FIG 0/1 with one short form subchannel
+        FibBuilder& subchannel(int subChId, int startAddr, int tableIndex) {
+            put(0, 3); put(4, 5);
+            put(0, 3); put(1, 5);
+            put(subChId, 6); put(startAddr, 10);
+            put(0, 1); put(0, 1); put(tableIndex, 6);
+            return *this;
+        }
+
+        // FIG 0/2 with one programme service and its DAB+ audio component
+        FibBuilder& service(uint16_t sId, int subChId) {
+            put(0, 3); put(6, 5);
+            put(0, 3); put(2, 5);
+            put(sId, 16);
+            put(0, 4); put(1, 4);
+            put(0, 2); put(63, 6); put(subChId, 6); put(1, 1); put(0, 1);
+            return *this;
+        }
+
+        // FIG 1/0 with the ensemble label
+        FibBuilder& ensembleLabel(uint16_t eId, const std::string& label) {
+            put(1, 3); put(21, 5);
+            put(0, 4); put(0, 1); put(0, 3);
+            put(eId, 16);
+            for (size_t i = 0; i < 16; i++) {
+                put(i < label.size() ? label[i] : ' ', 8);
+            }
+            put(0xff00, 16);
+            return *this;
+        }
+
+        // FIG 1/1 with the label of a programme service
+        FibBuilder& serviceLabel(uint16_t sId, const std::string& label) {
+            put(1, 3); put(21, 5);
+            put(0, 4); put(0, 1); put(1, 3);
+            put(sId, 16);
+            for (size_t i = 0; i < 16; i++) {
+                put(i < label.size() ? label[i] : ' ', 8);
+            }
+            put(0xff00, 16);
+            return *this;
+        }
+
+        std::vector<uint8_t> bits() const {
+            std::vector<uint8_t> b = fib;
+            b.resize(256, 1);
+            return b;
+        }
+
+    private:
+        std::vector<uint8_t> fib;
+};
+
+// One DAB+ service on subchannel 3
+inline CachedEnsemble oneServiceEnsemble()
+{
+    CachedEnsemble e;
+    e.ensembleId = 0x4fff;
+    e.ensembleLabel.fig1_label = "Mux";
+
+    Service s(0x4daa);
+    s.serviceLabel.fig1_label = "Radio";
+    e.services.push_back(s);
+
+    ServiceComponent sc;
+    sc.TMid = 0;
+    sc.SId = 0x4daa;
+    sc.ASCTy = 63;
+    sc.PS_flag = 1;
+    sc.subchannelId = 3;
+    e.components.push_back(sc);
+
+    Subchannel sub;
+    sub.subChId = 3;
+    sub.startAddr = 120;
+    sub.length = 48;
+    e.subChannels.push_back(sub);
+    return e;
+}
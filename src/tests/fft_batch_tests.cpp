@@ -0,0 +1,172 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * @file fft_batch_tests.cpp
+ * @brief Validation and throughput of the batched FFT of the data symbols
+ *
+ * The batch must give the same spectra, bit for bit, as the single
+ * transforms the OfdmDecoder did before, whatever the number of threads,
+ * and leave the cyclic prefixes and the unselected symbols alone.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/frame-pool.h"
+#include "../various/fft.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static void fill_random(SampleBuffer& buf, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<float> distr(-1.0f, 1.0f);
+    for (auto& s : buf) {
+        s = DSPCOMPLEX(distr(gen), distr(gen));
+    }
+}
+
+// What OfdmDecoder::decodeDataSymbol did for every symbol
+static SampleBuffer reference_spectra(const DABParams& params,
+        const SampleBuffer& symbols, const std::vector<bool>& selected)
+{
+    const int32_t T_g = params.T_s - params.T_u;
+    fft::Forward fft(params.T_u);
+    SampleBuffer out(symbols);
+    for (int16_t i = 0; i < params.L - 1; i++) {
+        if (not selected[i]) {
+            continue;
+        }
+        memcpy(fft.getVector(), &symbols[i * params.T_s + T_g],
+                params.T_u * sizeof(DSPCOMPLEX));
+        fft.do_FFT();
+        memcpy(&out[i * params.T_s + T_g], fft.getVector(),
+                params.T_u * sizeof(DSPCOMPLEX));
+    }
+    return out;
+}
+
+static bool same(const SampleBuffer& a, const SampleBuffer& b)
+{
+    return a.size() == b.size() and
+        memcmp(a.data(), b.data(), a.size() * sizeof(DSPCOMPLEX)) == 0;
+}
+
+TEST_CASE("The batch matches the single transforms", "[fft]") {
+    for (int mode = 1; mode <= 4; mode++) {
+        DABParams params(mode);
+        const int32_t count = params.L - 1;
+        SampleBuffer symbols(count * params.T_s);
+        fill_random(symbols, mode);
+
+        const std::vector<bool> all(count, true);
+        const auto expected = reference_spectra(params, symbols, all);
+
+        for (size_t threads : {1, 3, 4}) {
+            fft::BatchForward batch(params.T_u, count, params.T_s,
+                    params.T_s - params.T_u, threads);
+            SampleBuffer data(symbols);
+            batch.do_FFT(data.data());
+            INFO("mode " << mode << " threads " << threads);
+            REQUIRE(same(data, expected));
+        }
+    }
+}
+
+TEST_CASE("Only the selected symbols are transformed", "[fft]") {
+    DABParams params(1);
+    const int32_t count = params.L - 1;
+    SampleBuffer symbols(count * params.T_s);
+    fill_random(symbols, 7);
+
+    std::vector<bool> selected(count, false);
+    for (int32_t i = 0; i < count; i++) {
+        selected[i] = i < 3 or (i >= 20 and i < 26) or i == count - 1;
+    }
+    const auto expected = reference_spectra(params, symbols, selected);
+
+    for (size_t threads : {1, 2, 4}) {
+        fft::BatchForward batch(params.T_u, count, params.T_s,
+                params.T_s - params.T_u, threads);
+        SampleBuffer data(symbols);
+        batch.do_FFT(data.data(), selected);
+        INFO("threads " << threads);
+        REQUIRE(same(data, expected));
+    }
+}
+
+TEST_CASE("The batch can be run many times", "[fft]") {
+    DABParams params(2);
+    const int32_t count = params.L - 1;
+    fft::BatchForward batch(params.T_u, count, params.T_s,
+            params.T_s - params.T_u, 4);
+    const std::vector<bool> all(count, true);
+
+    for (unsigned frame = 0; frame < 50; frame++) {
+        SampleBuffer symbols(count * params.T_s);
+        fill_random(symbols, frame);
+        const auto expected = reference_spectra(params, symbols, all);
+        batch.do_FFT(symbols.data());
+        REQUIRE(same(symbols, expected));
+    }
+}
+
+TEST_CASE("Unaligned buffers are refused", "[fft]") {
+    DABParams params(1);
+    const int32_t count = params.L - 1;
+    fft::BatchForward batch(params.T_u, count, params.T_s,
+            params.T_s - params.T_u);
+    SampleBuffer symbols(count * params.T_s + 1);
+    REQUIRE_THROWS(batch.do_FFT(symbols.data() + 1));
+}
+
+TEST_CASE("Batched FFT throughput", "[fft][benchmark]") {
+    DABParams params(1);
+    const int32_t count = params.L - 1;
+    const int frames = 100;
+    SampleBuffer source(count * params.T_s);
+    fill_random(source, 1);
+    SampleBuffer symbols(source.size());
+
+    for (size_t threads : {1, 2, 4}) {
+        fft::BatchForward batch(params.T_u, count, params.T_s,
+                params.T_s - params.T_u, threads);
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < frames; i++) {
+            // Like a new frame from the pool
+            memcpy(symbols.data(), source.data(), source.size() * sizeof(DSPCOMPLEX));
+            batch.do_FFT(symbols.data());
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        std::cout << "Batched FFT, " << threads << " threads: " <<
+            frames / elapsed.count() << " TM1 frames/s" << std::endl;
+    }
+    REQUIRE(std::isfinite(symbols[0].real()));
+}
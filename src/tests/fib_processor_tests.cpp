@@ -0,0 +1,429 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+/**
+ * @file fib_processor_tests.cpp
+ * @brief Tests for the ensemble snapshots, the FIG cache and the
+ * ensemble cache of the FIBProcessor
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "ensemble_test_helpers.h"
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <dirent.h>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <unistd.h>
+
+TEST_CASE("The FIGs build a new snapshot", "[fibprocessor]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+
+    const auto initial = fib.getEnsembleSnapshot();
+    REQUIRE(initial->services.empty());
+    REQUIRE(initial->subChannels.size() == 64);
+
+    auto bits = FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits();
+    fib.processFIB(bits.data(), 0);
+
+    const auto first = fib.getEnsembleSnapshot();
+    REQUIRE(first->version > initial->version);
+    REQUIRE(first->ensembleId == 0x4fff);
+    REQUIRE(first->subChannels[3].valid());
+    REQUIRE(first->subChannels[3].startAddr == 120);
+
+    // The same FIGs again do not change the ensemble
+    fib.processFIB(bits.data(), 0);
+    REQUIRE(fib.getEnsembleSnapshot() == first);
+
+    // A service is only taken when signalled twice
+    bits = FibBuilder().service(0x4daa, 3).bits();
+    fib.processFIB(bits.data(), 0);
+    REQUIRE(fib.getEnsembleSnapshot()->services.empty());
+    fib.processFIB(bits.data(), 0);
+    REQUIRE(controller.servicesDetectedInSnapshot == 1);
+
+    bits = FibBuilder().ensembleLabel(0x4fff, "Test ensemble").bits();
+    fib.processFIB(bits.data(), 0);
+
+    const auto second = fib.getEnsembleSnapshot();
+    REQUIRE(second->version > first->version);
+    REQUIRE(second->ensembleLabel.fig1_label == "Test ensemble   ");
+    REQUIRE(second->services.size() == 1);
+    REQUIRE(second->components.size() == 1);
+    REQUIRE(second->components[0].subchannelId == 3);
+    REQUIRE(fib.getSubchannel(second->components[0]).startAddr == 120);
+
+    // The snapshot held by a reader does not change
+    REQUIRE(first->services.empty());
+    REQUIRE(first->ensembleLabel.fig1_label.empty());
+
+    fib.clearEnsemble();
+    const auto cleared = fib.getEnsembleSnapshot();
+    REQUIRE(cleared->version > second->version);
+    REQUIRE(cleared->services.empty());
+    REQUIRE(second->services.size() == 1);
+}
+
+TEST_CASE("Readers do not wait for the FIC thread", "[fibprocessor]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+
+    std::vector<std::vector<uint8_t> > fibs;
+    fibs.push_back(FibBuilder().ensemble(0x4fff).subchannel(1, 0, 10).bits());
+    for (uint16_t sId = 0x4001; sId < 0x4011; sId++) {
+        fibs.push_back(FibBuilder().service(sId, 1).bits());
+    }
+
+    std::atomic<bool> running(true);
+    std::thread fic([&]() {
+        while (running) {
+            for (auto& f : fibs) {
+                fib.processFIB(f.data(), 0);
+            }
+        }
+    });
+
+    size_t reads = 0;
+    uint64_t lastVersion = 0;
+    bool consistent = true;
+    const auto start = std::chrono::steady_clock::now();
+    while (std::chrono::steady_clock::now() - start < std::chrono::milliseconds(200)) {
+        const auto ensemble = fib.getEnsembleSnapshot();
+        consistent &= ensemble->version >= lastVersion;
+        lastVersion = ensemble->version;
+        // Every component of a snapshot belongs to one of its services
+        for (const auto& sc : ensemble->components) {
+            bool found = false;
+            for (const auto& s : ensemble->services) {
+                found |= s.serviceId == sc.SId;
+            }
+            consistent &= found;
+        }
+        reads++;
+    }
+
+    running = false;
+    fic.join();
+
+    REQUIRE(consistent);
+    REQUIRE(fib.getServiceList().size() == 16);
+    std::cout << "FIBProcessor: " << reads / 0.2 / 1e6 <<
+        " M ensemble reads/s next to the FIC thread" << std::endl;
+}
+
+TEST_CASE("Repeated FIGs are not decoded again", "[fibprocessor]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+
+    auto ensemble = FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits();
+    auto service = FibBuilder().service(0x4daa, 3).bits();
+    auto label = FibBuilder().serviceLabel(0x4daa, "Radio").bits();
+
+    // The label comes before its service, and must be decoded again once
+    // the service exists
+    fib.processFIB(ensemble.data(), 0);
+    fib.processFIB(label.data(), 0);
+    fib.processFIB(service.data(), 0);
+    REQUIRE(fib.getServiceList().empty());
+    fib.processFIB(service.data(), 0);
+    REQUIRE(fib.getServiceList().size() == 1);
+    REQUIRE(fib.getComponents(fib.getService(0x4daa)).size() == 1);
+    fib.processFIB(label.data(), 0);
+    REQUIRE(fib.getService(0x4daa).serviceLabel.fig1_label == "Radio           ");
+
+    // Once the ensemble is stable, only FIG 0/0 is decoded
+    for (int i = 0; i < 2; i++) {
+        fib.processFIB(ensemble.data(), 0);
+        fib.processFIB(service.data(), 0);
+        fib.processFIB(label.data(), 0);
+    }
+    const auto before = fib.getFigCacheStats();
+    const uint64_t version = fib.getEnsembleSnapshot()->version;
+    for (int i = 0; i < 100; i++) {
+        fib.processFIB(ensemble.data(), 0);
+        fib.processFIB(service.data(), 0);
+        fib.processFIB(label.data(), 0);
+    }
+    const auto after = fib.getFigCacheStats();
+    REQUIRE(after.hits - before.hits == 300);
+    REQUIRE(after.misses == before.misses);
+    REQUIRE(fib.getEnsembleSnapshot()->version == version);
+
+    // Another label is a new FIG
+    auto renamed = FibBuilder().serviceLabel(0x4daa, "Radio 2").bits();
+    fib.processFIB(renamed.data(), 0);
+    REQUIRE(fib.getFigCacheStats().misses == after.misses + 1);
+    REQUIRE(fib.getService(0x4daa).serviceLabel.fig1_label == "Radio 2         ");
+
+    // A new ensemble decodes everything again
+    fib.clearEnsemble();
+    fib.processFIB(service.data(), 0);
+    fib.processFIB(service.data(), 0);
+    REQUIRE(fib.getServiceList().size() == 1);
+}
+
+TEST_CASE("The snapshot finds services and components by their ids", "[fibprocessor]") {
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+
+    auto ensemble = FibBuilder().ensemble(0x4fff).subchannel(5, 0, 10).bits();
+    fib.processFIB(ensemble.data(), 0);
+    for (uint16_t sId = 0x4001; sId <= 0x4030; sId++) {
+        auto service = FibBuilder().service(sId, 5).bits();
+        fib.processFIB(service.data(), 0);
+        fib.processFIB(service.data(), 0);
+    }
+
+    const auto snapshot = fib.getEnsembleSnapshot();
+    REQUIRE(snapshot->services.size() == 0x30);
+    REQUIRE(snapshot->findService(0x4000) == nullptr);
+
+    const Service *srv = snapshot->findService(0x4022);
+    REQUIRE(srv != nullptr);
+    REQUIRE(srv->serviceId == 0x4022);
+
+    const auto comps = snapshot->findComponents(0x4022);
+    REQUIRE(comps.size() == 1);
+    REQUIRE(comps[0]->SId == 0x4022);
+    REQUIRE(snapshot->findComponent(0x4022, 0) == comps[0]);
+    REQUIRE(snapshot->findComponent(0x4022, 1) == nullptr);
+    REQUIRE(snapshot->findPacketComponent(0) == nullptr);
+
+    REQUIRE(snapshot->findSubchannel(5) != nullptr);
+    REQUIRE(snapshot->findSubchannel(5)->subChId == 5);
+    REQUIRE(snapshot->findSubchannel(6) == nullptr);
+    REQUIRE(snapshot->findSubchannel(64) == nullptr);
+
+    const int lookups = 100000;
+    size_t found = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; i++) {
+        found += fib.getService(0x4001 + i % 0x30).serviceId != 0;
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    REQUIRE(found == (size_t)lookups);
+    std::cout << "FIBProcessor: " << lookups / elapsed.count() / 1e6 <<
+        " M getService/s among " << snapshot->services.size() <<
+        " services" << std::endl;
+}
+
+// The ensemble that a receiver saves after it received the given FIBs
+static CachedEnsemble receivedEnsemble(const std::vector<std::vector<uint8_t> >& fibs)
+{
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+    for (auto bits : fibs) {
+        fib.processFIB(bits.data(), 0);
+    }
+    return fib.getCachedEnsemble();
+}
+
+// A directory of its own for the files a test writes, removed with
+// whatever is in it when the test ends, passed or not
+class TemporaryDirectory {
+    public:
+        TemporaryDirectory() {
+            const char *tmp = std::getenv("TMPDIR");
+            std::string pattern = std::string(tmp ? tmp : "/tmp") + "/welle-test-XXXXXX";
+            if (mkdtemp(&pattern[0]) == nullptr) {
+                throw std::runtime_error("Cannot create a temporary directory");
+            }
+            path = pattern;
+        }
+
+        ~TemporaryDirectory() {
+            DIR *dir = opendir(path.c_str());
+            if (dir) {
+                while (const struct dirent *entry = readdir(dir)) {
+                    const std::string name = entry->d_name;
+                    if (name != "." and name != "..") {
+                        std::remove((path + "/" + name).c_str());
+                    }
+                }
+                closedir(dir);
+            }
+            rmdir(path.c_str());
+        }
+
+        TemporaryDirectory(const TemporaryDirectory&) = delete;
+        TemporaryDirectory& operator=(const TemporaryDirectory&) = delete;
+
+        std::string path;
+};
+
+TEST_CASE("The ensemble cache reads back what it wrote", "[fibprocessor]") {
+    auto ensemble = receivedEnsemble({
+            FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits(),
+            FibBuilder().service(0x4daa, 3).bits(),
+            FibBuilder().service(0x4daa, 3).bits(),
+            FibBuilder().ensembleLabel(0x4fff, "Mux").bits(),
+            FibBuilder().serviceLabel(0x4daa, "Radio").bits() });
+    ensemble.ensembleLabel.segments[1] = { 0xc3, 0xa9 };
+    ServiceAnnouncementSupport support;
+    support.service_id = 0x4daa;
+    support.support_flags.flags = 0x0003;
+    support.cluster_ids = { 1, 7 };
+    ensemble.announcementSupport.push_back(support);
+
+    REQUIRE(ensemble.services.size() == 1);
+    REQUIRE(ensemble.components.size() == 1);
+    REQUIRE(ensemble.subChannels.size() == 1);
+
+    const std::string data = EnsembleCache::serialise(ensemble);
+    CachedEnsemble loaded;
+    REQUIRE(EnsembleCache::deserialise(data, loaded));
+    REQUIRE(loaded.ensembleId == 0x4fff);
+    REQUIRE(loaded.ensembleLabel == ensemble.ensembleLabel);
+    REQUIRE(loaded.services == ensemble.services);
+    REQUIRE(loaded.services[0].serviceLabel.utf8_label().find("Radio") == 0);
+    REQUIRE(loaded.components == ensemble.components);
+    REQUIRE(loaded.subChannels == ensemble.subChannels);
+    REQUIRE(loaded.announcementSupport.size() == 1);
+    REQUIRE(loaded.announcementSupport[0].cluster_ids == support.cluster_ids);
+
+    // Anything damaged is a miss
+    REQUIRE_FALSE(EnsembleCache::deserialise(data.substr(0, data.size() - 1), loaded));
+    REQUIRE_FALSE(EnsembleCache::deserialise(data + '\0', loaded));
+    REQUIRE_FALSE(EnsembleCache::deserialise("WELLEENS", loaded));
+    std::string otherVersion = data;
+    otherVersion[8]++;
+    REQUIRE_FALSE(EnsembleCache::deserialise(otherVersion, loaded));
+
+    TemporaryDirectory directory;
+    EnsembleCache cache(directory.path);
+    REQUIRE(cache.save("TEST 5A", ensemble));
+    CachedEnsemble fromFile;
+    REQUIRE(cache.load("TEST 5A", fromFile));
+    REQUIRE(fromFile.services == ensemble.services);
+    REQUIRE_FALSE(cache.load("TEST 5B", fromFile));
+}
+
+TEST_CASE("A preloaded ensemble plays before the FIC and is confirmed", "[fibprocessor]") {
+    const auto cached = receivedEnsemble({
+            FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits(),
+            FibBuilder().service(0x4daa, 3).bits(),
+            FibBuilder().service(0x4daa, 3).bits() });
+
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+    fib.preloadEnsemble(cached);
+
+    // Playable without a single FIB
+    const auto preloaded = fib.getEnsembleSnapshot();
+    REQUIRE(fib.isPreloadPending());
+    REQUIRE(controller.servicesDetectedInSnapshot == 1);
+    REQUIRE(preloaded->ensembleId == 0x4fff);
+    const auto comps = preloaded->findComponents(0x4daa);
+    REQUIRE(comps.size() == 1);
+    REQUIRE(preloaded->findSubchannel(comps[0]->subchannelId)->startAddr == 120);
+
+    auto ensemble = FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits();
+    auto service = FibBuilder().service(0x4daa, 3).bits();
+    fib.processFIB(ensemble.data(), 0);
+    fib.processFIB(service.data(), 0);
+    for (size_t i = 0; i < FIBProcessor::cacheConfirmFIBs; i++) {
+        fib.processFIB(ensemble.data(), 0);
+    }
+
+    REQUIRE_FALSE(fib.isPreloadPending());
+    REQUIRE(fib.getCacheContradictions() == 0);
+    REQUIRE(controller.restarts == 0);
+    REQUIRE(fib.getEnsembleSnapshot()->services == preloaded->services);
+    REQUIRE(fib.getEnsembleSnapshot()->components == preloaded->components);
+}
+
+TEST_CASE("The FIC corrects a stale preloaded ensemble", "[fibprocessor]") {
+    const auto cached = receivedEnsemble({
+            FibBuilder().ensemble(0x4fff).subchannel(3, 100, 10).subchannel(4, 200, 10).bits(),
+            FibBuilder().service(0x4daa, 3).bits(),
+            FibBuilder().service(0x4daa, 3).bits(),
+            FibBuilder().service(0x5000, 4).bits(),
+            FibBuilder().service(0x5000, 4).bits() });
+    REQUIRE(cached.services.size() == 2);
+
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+    fib.preloadEnsemble(cached);
+
+    // The subchannel moved, and the service left the ensemble
+    auto ensemble = FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits();
+    fib.processFIB(ensemble.data(), 0);
+    REQUIRE(fib.getCacheContradictions() == 1);
+    REQUIRE(controller.restarts == 1);
+    REQUIRE(fib.getEnsembleSnapshot()->findSubchannel(3)->startAddr == 120);
+
+    auto service = FibBuilder().service(0x4daa, 3).bits();
+    fib.processFIB(service.data(), 0);
+    for (size_t i = 0; i < FIBProcessor::cacheConfirmFIBs; i++) {
+        fib.processFIB(ensemble.data(), 0);
+    }
+
+    const auto snapshot = fib.getEnsembleSnapshot();
+    REQUIRE(fib.getCacheContradictions() == 2);
+    REQUIRE(controller.restarts == 2);
+    REQUIRE(snapshot->services.size() == 1);
+    REQUIRE(snapshot->findService(0x5000) == nullptr);
+    REQUIRE(snapshot->findSubchannel(4) == nullptr);
+}
+
+TEST_CASE("Another ensemble on the channel discards the preloaded one", "[fibprocessor]") {
+    const auto cached = receivedEnsemble({
+            FibBuilder().ensemble(0x4fff).subchannel(3, 120, 10).bits(),
+            FibBuilder().service(0x4daa, 3).bits(),
+            FibBuilder().service(0x4daa, 3).bits() });
+
+    SilentController controller;
+    FIBProcessor fib(controller);
+    controller.fib = &fib;
+    fib.preloadEnsemble(cached);
+
+    auto ensemble = FibBuilder().ensemble(0x1234).bits();
+    fib.processFIB(ensemble.data(), 0);
+
+    const auto snapshot = fib.getEnsembleSnapshot();
+    REQUIRE(controller.restarts == 1);
+    REQUIRE(snapshot->ensembleId == 0x1234);
+    REQUIRE(snapshot->services.empty());
+    REQUIRE(snapshot->findSubchannel(3) == nullptr);
+}
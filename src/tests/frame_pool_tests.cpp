@@ -0,0 +1,177 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * @file frame_pool_tests.cpp
+ * @brief Tests for the OFDM frame buffer pool
+ *
+ * The steady state test replays what happens to a frame between the
+ * OFDMProcessor, the OfdmDecoder queue and the TIIDecoder, and counts
+ * the heap allocations with a replaced global operator new.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/frame-pool.h"
+#include <atomic>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <vector>
+
+static std::atomic<size_t> num_allocations(0);
+
+void* operator new(size_t size)
+{
+    num_allocations++;
+    void *p = malloc(size ? size : 1);
+    if (p == nullptr) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+// Not inlined, otherwise GCC warns about free() on memory from new
+__attribute__((noinline)) void operator delete(void *p) noexcept
+{
+    free(p);
+}
+
+__attribute__((noinline)) void operator delete(void *p, size_t) noexcept
+{
+    free(p);
+}
+
+TEST_CASE("Frames have the size of the transmission mode", "[framepool]") {
+    DABParams params(1);
+    FramePool pool(params, 2);
+
+    FrameRef frame = pool.acquire();
+    REQUIRE(frame);
+    REQUIRE(frame->prs.size() == (size_t)params.T_u);
+    REQUIRE(frame->dataSymbols.size() == (size_t)((params.L - 1) * params.T_s));
+    for (int16_t sym = 1; sym < params.L; sym++) {
+        REQUIRE(frame->dataSymbol(sym) ==
+                frame->dataSymbols.data() + (sym - 1) * params.T_s);
+    }
+    REQUIRE(frame->nullSymbol.size() == (size_t)params.T_null);
+}
+
+TEST_CASE("Sample buffers are cache aligned", "[framepool]") {
+    DABParams params(1);
+    FramePool pool(params, 1);
+
+    FrameRef frame = pool.acquire();
+    REQUIRE(reinterpret_cast<uintptr_t>(frame->prs.data()) % CACHE_LINE_SIZE == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(frame->dataSymbols.data()) % CACHE_LINE_SIZE == 0);
+    REQUIRE(reinterpret_cast<uintptr_t>(frame->nullSymbol.data()) % CACHE_LINE_SIZE == 0);
+}
+
+TEST_CASE("A frame goes back to the pool with its last reference", "[framepool]") {
+    DABParams params(1);
+    FramePool pool(params, 2);
+
+    FrameRef frame = pool.acquire();
+    REQUIRE(pool.available() == 1);
+
+    FrameRef decoder_ref = frame;
+    FrameRef tii_ref = std::move(frame);
+    REQUIRE_FALSE(frame);
+    REQUIRE(pool.available() == 1);
+
+    decoder_ref.reset();
+    REQUIRE(pool.available() == 1);
+
+    tii_ref.reset();
+    REQUIRE(pool.available() == 2);
+}
+
+TEST_CASE("The pool grows when all frames are in use", "[framepool]") {
+    DABParams params(1);
+    FramePool pool(params, 1);
+
+    FrameRef first = pool.acquire();
+    FrameRef second = pool.acquire();
+    REQUIRE(second);
+    REQUIRE(pool.size() == 2);
+
+    first.reset();
+    second.reset();
+    REQUIRE(pool.available() == 2);
+}
+
+TEST_CASE("The steady state does no heap allocation", "[framepool][allocations]") {
+    DABParams params(1);
+    const size_t queueDepth = 4;
+    FramePool pool(params, queueDepth + 3);
+
+    std::vector<FrameRef> decoder_queue;
+    decoder_queue.reserve(queueDepth);
+    FrameRef tii_frame;
+
+    // One frame of the OFDMProcessor, with the decoder falling behind
+    // every third frame and the TII decoder busy every other frame.
+    auto process_frame = [&](int n) {
+        FrameRef frame = pool.acquire();
+        frame->prs[0] = DSPCOMPLEX(n, 0);
+        for (int16_t sym = 1; sym < params.L; sym++) {
+            frame->dataSymbol(sym)[0] = DSPCOMPLEX(n, 0);
+        }
+
+        if (decoder_queue.size() >= queueDepth) {
+            decoder_queue.erase(decoder_queue.begin());
+        }
+        decoder_queue.push_back(frame);
+
+        frame->nullSymbol[0] = DSPCOMPLEX(0, n);
+        if (not tii_frame) {
+            tii_frame = frame;
+        }
+        frame.reset();
+
+        if (n % 3 != 0 and not decoder_queue.empty()) {
+            decoder_queue.erase(decoder_queue.begin());
+        }
+        if (n % 2 == 0) {
+            tii_frame.reset();
+        }
+    };
+
+    for (int n = 0; n < 20; n++) {
+        process_frame(n);
+    }
+
+    const size_t allocations_before = num_allocations;
+    const int num_frames = 1000;
+    for (int n = 0; n < num_frames; n++) {
+        process_frame(n);
+    }
+    const size_t allocations = num_allocations - allocations_before;
+
+    INFO("Allocations per frame: " << (double)allocations / num_frames);
+    REQUIRE(allocations == 0);
+    REQUIRE(pool.size() == queueDepth + 3);
+}
@@ -0,0 +1,144 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+/**
+ * @file frequency_shifter_tests.cpp
+ * @brief Validation of the block front-end against the per sample code
+ *
+ * The block NCO and level tracker of the OFDMProcessor must give the
+ * same results as the oscillator table and the per sample moving
+ * average, up to float rounding.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/frequency-shifter.h"
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static std::vector<DSPCOMPLEX> random_samples(size_t n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> distr(0.0f, 40.0f);
+    std::vector<DSPCOMPLEX> v(n);
+    for (auto& s : v) {
+        s = DSPCOMPLEX(distr(gen), distr(gen));
+    }
+    return v;
+}
+
+static float max_error(const std::vector<DSPCOMPLEX>& a,
+        const std::vector<DSPCOMPLEX>& b)
+{
+    float err = 0;
+    for (size_t i = 0; i < a.size(); i++) {
+        err = std::max(err, std::abs(a[i] - b[i]) / std::max(1.0f, std::abs(b[i])));
+    }
+    return err;
+}
+
+TEST_CASE("Block NCO matches the oscillator table", "[frontend]") {
+    // The block sizes read by the OFDMProcessor, and odd sizes
+    const int32_t sizes[] = {1, 7, 8, 50, 256, 257, 2048, 2552, 2656, 10000};
+    // Typical corrections, the largest coarse correction, and extremes
+    const int32_t phases[] = {0, 1, -1, 937, -15625, 35000, -36937, 1023999};
+
+    for (const int32_t phase : phases) {
+        FrequencyShifter block;
+        FrequencyShifter table;
+
+        // Several calls in a row, to check the phase continuity
+        unsigned seed = 1;
+        for (const int32_t n : sizes) {
+            const auto input = random_samples(n, seed++);
+            auto expected = input;
+            auto actual = input;
+
+            table.shiftWithTable(expected.data(), n, phase);
+            block.shift(actual.data(), n, phase);
+
+            INFO("phase " << phase << " n " << n);
+            REQUIRE(block.getLocalPhase() == table.getLocalPhase());
+            REQUIRE(max_error(actual, expected) < 2e-5f);
+        }
+    }
+}
+
+TEST_CASE("Block level tracker matches the per sample average", "[frontend]") {
+    const LevelTracker tracker(0.00001);
+    const int32_t sizes[] = {1, 15, 16, 2048, 2552, 4096, 4097, 20000};
+
+    float block_level = 0;
+    float sample_level = 0;
+    unsigned seed = 100;
+    for (int iteration = 0; iteration < 20; iteration++) {
+        for (const int32_t n : sizes) {
+            const auto input = random_samples(n, seed++);
+            block_level = tracker.update(block_level, input.data(), n);
+            sample_level = tracker.updateSampleBySample(
+                    sample_level, input.data(), n);
+
+            INFO("n " << n << " block " << block_level << " sample " << sample_level);
+            REQUIRE(std::abs(block_level - sample_level) <= 1e-4f * sample_level);
+        }
+    }
+}
+
+TEST_CASE("Front-end throughput", "[frontend][benchmark]") {
+    const int32_t n = 2552;
+    const int iterations = 4000;
+    auto samples = random_samples(n, 42);
+
+    FrequencyShifter shifter;
+    const LevelTracker tracker(0.00001);
+    float level = 0;
+
+    auto run = [&](bool block) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            if (block) {
+                shifter.shift(samples.data(), n, 937);
+                level = tracker.update(level, samples.data(), n);
+            }
+            else {
+                shifter.shiftWithTable(samples.data(), n, 937);
+                level = tracker.updateSampleBySample(level, samples.data(), n);
+            }
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return (double)n * iterations / elapsed.count() / 1e6;
+    };
+
+    const double table_msps = run(false);
+    const double block_msps = run(true);
+    std::cout << "Front-end table: " << table_msps << " Msps, block: " <<
+        block_msps << " Msps" << std::endl;
+    REQUIRE(std::isfinite(level));
+}
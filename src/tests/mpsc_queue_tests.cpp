@@ -0,0 +1,241 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+/**
+ * @file mpsc_queue_tests.cpp
+ * @brief Tests for the multi producer event queue and the asynchronous
+ * delivery of the RadioControllerInterface callbacks
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../various/mpsc_queue.h"
+#include "../backend/async-radio-controller.h"
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("The capacity of the queue is rounded up to a power of two", "[mpscqueue]") {
+    MpscQueue<int> queue(100);
+    REQUIRE(queue.capacity() == 128);
+    REQUIRE(queue.size() == 0);
+}
+
+TEST_CASE("A full queue refuses the element and leaves it alone", "[mpscqueue]") {
+    MpscQueue<std::vector<int>> queue(4);
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(queue.tryPush(std::vector<int>(10, i)));
+    }
+    REQUIRE(queue.size() == 4);
+
+    std::vector<int> refused(10, 4);
+    REQUIRE_FALSE(queue.tryPush(std::move(refused)));
+    REQUIRE(refused.size() == 10);
+
+    std::vector<int> out;
+    for (int i = 0; i < 4; i++) {
+        REQUIRE(queue.tryPop(out));
+        REQUIRE(out == std::vector<int>(10, i));
+    }
+    REQUIRE_FALSE(queue.tryPop(out));
+
+    // The cells are given back for the next round
+    REQUIRE(queue.tryPush(std::move(refused)));
+    REQUIRE(queue.tryPop(out));
+    REQUIRE(out == std::vector<int>(10, 4));
+}
+
+TEST_CASE("Every producer keeps its order", "[mpscqueue]") {
+    const int producers = 4;
+    const int perProducer = 200000;
+    MpscQueue<uint64_t> queue(256);
+
+    std::vector<std::thread> threads;
+    for (int p = 0; p < producers; p++) {
+        threads.emplace_back([&queue, p]() {
+            for (uint64_t i = 0; i < perProducer; i++) {
+                while (not queue.tryPush(((uint64_t)p << 32) | i)) {
+                    std::this_thread::yield();
+                }
+            }
+        });
+    }
+
+    std::vector<uint64_t> next(producers, 0);
+    size_t outOfOrder = 0;
+    const auto start = std::chrono::steady_clock::now();
+    for (int received = 0; received < producers * perProducer;) {
+        uint64_t v;
+        if (queue.tryPop(v)) {
+            const size_t p = v >> 32;
+            if (p >= (size_t)producers or (v & 0xffffffff) != next[p]) {
+                outOfOrder++;
+            }
+            else {
+                next[p]++;
+            }
+            received++;
+        }
+        else {
+            std::this_thread::yield();
+        }
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+
+    for (auto& t : threads) {
+        t.join();
+    }
+    REQUIRE(outOfOrder == 0);
+    REQUIRE(queue.size() == 0);
+
+    std::cout << "MpscQueue, " << producers << " producers: " <<
+        producers * perProducer / elapsed.count() / 1e6 <<
+        " M elements/s" << std::endl;
+}
+
+class RecordingController : public RadioControllerInterface {
+    public:
+        virtual void onSNR(float snr) override { record("snr " + std::to_string((int)snr)); }
+        virtual void onFrequencyCorrectorChange(int fine, int coarse) override { (void)fine; (void)coarse; }
+        virtual void onSyncChange(char isSync) override { (void)isSync; }
+        virtual void onSignalPresence(bool isSignal) override { (void)isSignal; }
+        virtual void onServiceDetected(uint32_t sId) override { record("service " + std::to_string(sId)); }
+        virtual void onNewEnsemble(uint16_t /*eId*/) override { }
+        virtual void onSetEnsembleLabel(DabLabel& /*label*/) override { }
+        virtual void onDateTimeUpdate(const dab_date_time_t& dateTime) override { (void)dateTime; }
+        virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override {
+            std::string bits;
+            for (size_t i = 0; i < 256; i++) {
+                bits += fib[i] ? '1' : '0';
+            }
+            record(std::string("fib ") + (crcCheckOk ? "ok " : "ko ") + bits);
+        }
+        virtual uint32_t getDiagnosticSubscriptions(void) const override { return DIAGNOSTIC_SPECTRUM; }
+        virtual void onNewImpulseResponse(std::vector<float>&& data) override { record("cir " + std::to_string(data.size())); }
+        virtual void onNewNullSymbol(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
+        virtual void onConstellationPoints(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
+        virtual void onMessage(message_level_t level, const std::string& text, const std::string& text2 = std::string()) override { (void)level; record(text + text2); }
+        virtual void onTIIMeasurement(tii_measurement_t&& m) override { (void)m; }
+        virtual void onAlarmFlagUpdate(bool alarm_enabled) override { record(alarm_enabled ? "alarm" : "no alarm"); }
+
+        std::vector<std::string> events(void) {
+            std::lock_guard<std::mutex> lock(mutex);
+            return recorded;
+        }
+
+        void record(const std::string& event) {
+            std::lock_guard<std::mutex> lock(mutex);
+            recorded.push_back(event);
+            if (slow) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        }
+
+        bool slow = false;
+
+    private:
+        std::mutex mutex;
+        std::vector<std::string> recorded;
+};
+
+TEST_CASE("The events reach the controller in order", "[mpscqueue]") {
+    RecordingController controller;
+    uint8_t fib[256];
+    std::string fibBits;
+    for (size_t i = 0; i < 256; i++) {
+        fib[i] = (i * 7 + i / 5) % 3 == 0;
+        fibBits += fib[i] ? '1' : '0';
+    }
+
+    {
+        AsyncRadioController async(controller, 16);
+        REQUIRE(async.getDiagnosticSubscriptions() == DIAGNOSTIC_SPECTRUM);
+
+        async.onSNR(12);
+        async.onFIBDecodeSuccess(true, fib);
+        async.onServiceDetected(0x4daa);
+        async.onNewImpulseResponse(std::vector<float>(2048));
+        async.onMessage(message_level_t::Information, "hello ", "world");
+        async.onAlarmFlagUpdate(true);
+        // Destroying the AsyncRadioController delivers what is queued
+    }
+
+    const std::vector<std::string> expected = {
+        "snr 12", "fib ok " + fibBits, "service 19882", "cir 2048",
+        "hello world", "alarm" };
+    REQUIRE(controller.events() == expected);
+}
+
+TEST_CASE("A slow controller makes the queue drop events", "[mpscqueue]") {
+    RecordingController controller;
+    controller.slow = true;
+
+    AsyncRadioController async(controller, 8);
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 100; i++) {
+        async.onSNR(i);
+    }
+    const std::chrono::duration<double> elapsed =
+        std::chrono::steady_clock::now() - start;
+    // Sending never waits for the 1 ms the controller takes per event
+    REQUIRE(elapsed.count() < 0.05);
+
+    const auto stats = async.getStats();
+    REQUIRE(stats.depth == 8);
+    REQUIRE(stats.highWaterMark <= 8);
+    REQUIRE(stats.eventsDropped > 0);
+    REQUIRE(stats.eventsDropped + stats.pending + stats.eventsDelivered <= 100);
+}
+
+TEST_CASE("A slow controller still gets every control event", "[mpscqueue]") {
+    RecordingController controller;
+    controller.slow = true;
+
+    {
+        AsyncRadioController async(controller, 8);
+        for (int i = 0; i < 50; i++) {
+            async.onSNR(i);
+            async.onServiceDetected(i);
+        }
+    }
+
+    std::vector<std::string> services;
+    for (const auto& e : controller.events()) {
+        if (e.compare(0, 8, "service ") == 0) {
+            services.push_back(e);
+        }
+    }
+    REQUIRE(services.size() == 50);
+    for (int i = 0; i < 50; i++) {
+        REQUIRE(services[i] == "service " + std::to_string(i));
+    }
+}
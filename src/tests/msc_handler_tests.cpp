@@ -0,0 +1,141 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+
+/**
+ * @file msc_handler_tests.cpp
+ * @brief Tuning the MscHandler to the programmes of an ensemble the FIC
+ * corrects
+ *
+ * The audio decoders are replaced by a stub that only counts them, the
+ * MscHandler does not look into them.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/msc-handler.h"
+#include "../backend/dab-audio.h"
+#include "../backend/dab-processor.h"
+#include "../backend/protection.h"
+#include "ensemble_test_helpers.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+static int audioDecoders = 0;
+
+DabAudio::DabAudio(AudioServiceComponentType dabModus,
+        int16_t fragmentSize,
+        int16_t bitRate,
+        ProtectionSettings protection,
+        ProgrammeHandlerInterface& phi,
+        const std::string& dumpFileName,
+        bool singleThreaded) :
+    myProgrammeHandler(phi),
+    singleThreaded(singleThreaded),
+    dabModus(dabModus),
+    fragmentSize(fragmentSize),
+    bitRate(bitRate),
+    mscBuffer(64),
+    dumpFileName(dumpFileName)
+{
+    (void)protection;
+    audioDecoders++;
+}
+
+DabAudio::~DabAudio()
+{
+    audioDecoders--;
+}
+
+int32_t DabAudio::process(const softbit_t *v, int16_t cnt)
+{
+    (void)v;
+    return cnt;
+}
+
+void DabAudio::drain()
+{
+}
+
+class SilentProgrammeHandler : public ProgrammeHandlerInterface {
+    public:
+        virtual void onFrameErrors(int frameErrors) override { (void)frameErrors; }
+        virtual void onNewAudio(std::vector<int16_t>&& audioData, int sampleRate, const std::string& mode) override { (void)audioData; (void)sampleRate; (void)mode; }
+        virtual void onRsErrors(bool uncorrectedErrors, int numCorrectedErrors) override { (void)uncorrectedErrors; (void)numCorrectedErrors; }
+        virtual void onAacErrors(int aacErrors) override { (void)aacErrors; }
+        virtual void onNewDynamicLabel(const std::string& label) override { (void)label; }
+        virtual void onMOT(const mot_file_t& mot_file) override { (void)mot_file; }
+        virtual void onPADLengthError(size_t announced_xpad_len, size_t xpad_len) override { (void)announced_xpad_len; (void)xpad_len; }
+};
+
+TEST_CASE("A programme stops on the subchannel it was tuned to", "[mschandler]") {
+    // And an unused subchannel 4
+    auto cached = oneServiceEnsemble();
+    Subchannel unused = cached.subChannels.at(0);
+    unused.subChId = 4;
+    unused.startAddr = 200;
+    cached.subChannels.push_back(unused);
+
+    SilentController controller;
+    FIBProcessor fib(controller);
+    fib.preloadEnsemble(cached);
+
+    DABParams params(1);
+    MscHandler msc(params, false, true);
+    SilentProgrammeHandler handler;
+
+    // As RadioReceiver::playProgramme, from the preloaded ensemble
+    const auto preloaded = fib.getEnsembleSnapshot();
+    const auto tuned = *preloaded->findSubchannel(
+            preloaded->findComponents(0x4daa).at(0)->subchannelId);
+    REQUIRE(tuned.subChId == 3);
+    REQUIRE(msc.addSubchannel(handler, AudioServiceComponentType::DABPlus, "", tuned));
+    REQUIRE(audioDecoders == 1);
+
+    // The FIC moves the component to subchannel 4
+    auto moved = FibBuilder().service(0x4daa, 4).bits();
+    fib.processFIB(moved.data(), 0);
+    REQUIRE(controller.restarts == 1);
+    const auto corrected = fib.getEnsembleSnapshot();
+    REQUIRE(corrected->findComponents(0x4daa).at(0)->subchannelId == 4);
+
+    // The corrected ensemble does not find what is decoded
+    REQUIRE_FALSE(msc.removeSubchannel(*corrected->findSubchannel(4)));
+    REQUIRE(audioDecoders == 1);
+
+    REQUIRE(msc.removeSubchannel(handler));
+    REQUIRE(audioDecoders == 0);
+    REQUIRE_FALSE(msc.removeSubchannel(handler));
+
+    // And tuned again from the corrected ensemble
+    REQUIRE(msc.addSubchannel(handler, AudioServiceComponentType::DABPlus, "",
+                *corrected->findSubchannel(4)));
+    REQUIRE(audioDecoders == 1);
+    msc.stopProcessing();
+    REQUIRE(audioDecoders == 0);
+}
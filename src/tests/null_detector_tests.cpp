@@ -0,0 +1,226 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+/**
+ * @file null_detector_tests.cpp
+ * @brief Validation of the block null detection against the per sample loops
+ *
+ * The reference is the detection the OFDMProcessor did with one
+ * getSample() call per sample. The block detector must find the edges
+ * of the null symbol at the same samples, whatever the block size.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../backend/null-detector.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static const double alpha = 0.00001;
+
+// Frames of 196608 samples starting with a null symbol of 2656 samples
+static std::vector<DSPCOMPLEX> dab_like_signal(int frames, unsigned seed)
+{
+    const int32_t T_F = 196608;
+    const int32_t T_null = 2656;
+    std::mt19937 gen(seed);
+    std::normal_distribution<float> distr(0.0f, 40.0f);
+    std::normal_distribution<float> noise(0.0f, 2.0f);
+
+    std::vector<DSPCOMPLEX> v(frames * T_F);
+    for (size_t i = 0; i < v.size(); i++) {
+        if (i % T_F < T_null) {
+            v[i] = DSPCOMPLEX(noise(gen), noise(gen));
+        }
+        else {
+            v[i] = DSPCOMPLEX(distr(gen), distr(gen));
+        }
+    }
+    return v;
+}
+
+static float l1(DSPCOMPLEX z)
+{
+    return std::abs(z.real()) + std::abs(z.imag());
+}
+
+// The loops of OFDMProcessor::run, returns the index of the first sample
+// after the edge, or -1 when giving up after maxSamples samples.
+struct Reference {
+    float env[32768];
+    int32_t index = 0;
+    float strength = 0;
+    float level = 0;
+
+    void reset(const DSPCOMPLEX *v) {
+        index = 0;
+        strength = 0;
+        for (int i = 0; i < 50; i++) {
+            env[index] = l1(v[i]);
+            strength += env[index];
+            index++;
+        }
+    }
+
+    int32_t find(bool start, const std::vector<DSPCOMPLEX>& v,
+            int32_t pos, int32_t maxSamples) {
+        int32_t counter = 0;
+        while (start ? strength / 50 > 0.50 * level :
+                       strength / 50 < 0.75 * level) {
+            env[index] = l1(v[pos]);
+            strength += env[index] - env[(index - 50) & 32767];
+            index = (index + 1) & 32767;
+            level = alpha * l1(v[pos]) + (1 - alpha) * level;
+            pos++;
+            counter++;
+            if (counter > maxSamples) {
+                return -1;
+            }
+        }
+        return pos;
+    }
+};
+
+// The same with the detector, in blocks of the given size
+static int32_t find_in_blocks(NullDetector& detector, bool start,
+        const std::vector<DSPCOMPLEX>& v, int32_t pos, int32_t maxSamples,
+        int32_t blockSize, float& level)
+{
+    int32_t counter = 0;
+    while (true) {
+        const int32_t n = std::min(blockSize, maxSamples + 1 - counter);
+        bool found;
+        const int32_t consumed = start ?
+            detector.findNullStart(&v[pos], n, level, found) :
+            detector.findNullEnd(&v[pos], n, level, found);
+        pos += consumed;
+        counter += consumed;
+        if (found) {
+            return pos;
+        }
+        if (counter > maxSamples) {
+            return -1;
+        }
+    }
+}
+
+TEST_CASE("Block detection finds the same edges", "[nulldetector]") {
+    const auto signal = dab_like_signal(4, 7);
+    const int32_t blockSizes[] = {1, 7, 50, 1000, NullDetector::blockSize};
+
+    // Start in the middle of a frame, with a settled level
+    const int32_t initial = 100000;
+    float initialLevel = 0;
+    for (int32_t i = 0; i < initial; i++) {
+        initialLevel = alpha * l1(signal[i]) + (1 - alpha) * initialLevel;
+    }
+
+    Reference ref;
+    ref.level = initialLevel;
+    ref.reset(&signal[initial]);
+    std::vector<int32_t> expected;
+    int32_t pos = initial + 50;
+    for (int edge = 0; edge < 6; edge++) {
+        const bool start = edge % 2 == 0;
+        pos = ref.find(start, signal, pos, start ? 196608 : 2656 + 50);
+        REQUIRE(pos > 0);
+        expected.push_back(pos);
+    }
+
+    for (const int32_t blockSize : blockSizes) {
+        NullDetector detector(alpha);
+        float level = initialLevel;
+        detector.reset(&signal[initial]);
+        int32_t pos = initial + 50;
+        for (int edge = 0; edge < 6; edge++) {
+            const bool start = edge % 2 == 0;
+            pos = find_in_blocks(detector, start, signal, pos,
+                    start ? 196608 : 2656 + 50, blockSize, level);
+            INFO("block size " << blockSize << " edge " << edge);
+            REQUIRE(pos == expected[edge]);
+        }
+        REQUIRE(std::abs(level - ref.level) <= 1e-5f * ref.level);
+    }
+}
+
+TEST_CASE("Block detection gives up after the same number of samples", "[nulldetector]") {
+    // A signal without any null
+    std::mt19937 gen(3);
+    std::normal_distribution<float> distr(0.0f, 40.0f);
+    std::vector<DSPCOMPLEX> signal(20000);
+    for (auto& s : signal) {
+        s = DSPCOMPLEX(distr(gen), distr(gen));
+    }
+    float level = 0;
+    for (const auto& s : signal) {
+        level = alpha * l1(s) + (1 - alpha) * level;
+    }
+
+    NullDetector detector(alpha);
+    detector.reset(signal.data());
+    REQUIRE(find_in_blocks(detector, true, signal, 50, 5000, 1000, level) == -1);
+}
+
+TEST_CASE("Null detection throughput", "[nulldetector][benchmark]") {
+    const auto signal = dab_like_signal(1, 11);
+    const int32_t n = signal.size() - 2048;
+    const int iterations = 20;
+
+    auto run = [&](bool block) {
+        int32_t found = 0;
+        const auto start = std::chrono::steady_clock::now();
+        for (int it = 0; it < iterations; it++) {
+            // A level the signal never reaches, to scan everything
+            float level = 1e9f;
+            if (block) {
+                NullDetector detector(alpha);
+                detector.reset(signal.data());
+                found += find_in_blocks(detector, false, signal, 50,
+                        n - 51, NullDetector::blockSize, level) >= 0;
+            }
+            else {
+                Reference ref;
+                ref.level = level;
+                ref.reset(signal.data());
+                found += ref.find(false, signal, 50, n - 51) >= 0;
+            }
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        REQUIRE(found == 0);
+        return (double)n * iterations / elapsed.count() / 1e6;
+    };
+
+    const double sample_msps = run(false);
+    const double block_msps = run(true);
+    std::cout << "Null detection per sample: " << sample_msps <<
+        " Msps, block: " << block_msps << " Msps" << std::endl;
+}
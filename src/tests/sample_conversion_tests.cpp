@@ -0,0 +1,210 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+/**
+ * @file sample_conversion_tests.cpp
+ * @brief Validation and throughput of the sample format conversions
+ *
+ * Every kernel must give the same result, bit for bit, as the per
+ * sample loops the inputs used before, for all lengths including the
+ * tails the SIMD kernels leave to the generic code.
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../various/sample_conversion.h"
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <vector>
+
+static std::vector<uint8_t> random_bytes(size_t n, unsigned seed)
+{
+    std::mt19937 gen(seed);
+    std::uniform_int_distribution<int> distr(0, 255);
+    std::vector<uint8_t> v(n);
+    for (auto& b : v) {
+        b = distr(gen);
+    }
+    // Make sure the extremes are in
+    if (n >= 4) {
+        v[0] = 0; v[1] = 255; v[2] = 128; v[3] = 127;
+    }
+    return v;
+}
+
+static bool same(const std::vector<DSPCOMPLEX>& a, const std::vector<DSPCOMPLEX>& b)
+{
+    return a.size() == b.size() and
+        memcmp(a.data(), b.data(), a.size() * sizeof(DSPCOMPLEX)) == 0;
+}
+
+// The loops of CRTL_SDR::getSamples and CRAWFile::convertSamples
+static std::vector<DSPCOMPLEX> reference_u8(const std::vector<uint8_t>& in, size_t n)
+{
+    std::vector<DSPCOMPLEX> v(n);
+    for (size_t i = 0; i < n; i++)
+        v[i] = DSPCOMPLEX(float(in[2 * i] - 128) / 128.0,
+                          float(in[2 * i + 1] - 128) / 128.0);
+    return v;
+}
+
+static std::vector<DSPCOMPLEX> reference_s8(const std::vector<uint8_t>& in, size_t n)
+{
+    std::vector<DSPCOMPLEX> v(n);
+    for (size_t i = 0; i < n; i++)
+        v[i] = DSPCOMPLEX(float((int8_t)in[2 * i]) / 128.0,
+                          float((int8_t)in[2 * i + 1]) / 128.0);
+    return v;
+}
+
+static std::vector<DSPCOMPLEX> reference_s16be(const std::vector<uint8_t>& in, size_t n)
+{
+    std::vector<DSPCOMPLEX> v(n);
+    for (size_t i = 0, j = 0; i < n; i++, j += 4) {
+        int16_t IQ_I = (int16_t)(in[j + 0] << 8) | in[j + 1];
+        int16_t IQ_Q = (int16_t)(in[j + 2] << 8) | in[j + 3];
+        v[i] = DSPCOMPLEX((float)(IQ_I), (float)(IQ_Q));
+    }
+    return v;
+}
+
+static std::vector<DSPCOMPLEX> reference_s16le(const std::vector<uint8_t>& in, size_t n)
+{
+    std::vector<DSPCOMPLEX> v(n);
+    for (size_t i = 0, j = 0; i < n; i++, j += 4) {
+        int16_t IQ_I = (int16_t)(in[j + 1] << 8) | in[j + 0];
+        int16_t IQ_Q = (int16_t)(in[j + 3] << 8) | in[j + 2];
+        v[i] = DSPCOMPLEX((float)(IQ_I), (float)(IQ_Q));
+    }
+    return v;
+}
+
+// The loop of CLimeSDR
+static std::vector<DSPCOMPLEX> reference_s16(const std::vector<int16_t>& in, size_t n)
+{
+    std::vector<DSPCOMPLEX> v(n);
+    for (size_t i = 0; i < n; i++)
+        v[i] = DSPCOMPLEX(in[2 * i] / 2048.0, in[2 * i + 1] / 2048.0);
+    return v;
+}
+
+static const size_t lengths[] = {0, 1, 3, 4, 7, 8, 15, 16, 17, 31, 33, 1000, 16384};
+
+TEST_CASE("8-bit conversions match the scalar code", "[conversion]") {
+    for (const auto kernel : SampleConverter::availableKernels()) {
+        const SampleConverter converter(kernel);
+        REQUIRE(converter.getKernel() == kernel);
+
+        for (const size_t n : lengths) {
+            INFO(SampleConverter::kernelName(kernel) << " n " << n);
+            const auto in = random_bytes(2 * n, n);
+            std::vector<DSPCOMPLEX> out(n);
+
+            converter.fromU8(in.data(), out.data(), n);
+            REQUIRE(same(out, reference_u8(in, n)));
+
+            converter.fromS8(in.data(), out.data(), n);
+            REQUIRE(same(out, reference_s8(in, n)));
+        }
+    }
+}
+
+TEST_CASE("16-bit conversions match the scalar code", "[conversion]") {
+    for (const auto kernel : SampleConverter::availableKernels()) {
+        const SampleConverter converter(kernel);
+
+        for (const size_t n : lengths) {
+            INFO(SampleConverter::kernelName(kernel) << " n " << n);
+            const auto in = random_bytes(4 * n, n + 100);
+            std::vector<DSPCOMPLEX> out(n);
+
+            converter.fromS16LE(in.data(), out.data(), n, 1.0f);
+            REQUIRE(same(out, reference_s16le(in, n)));
+
+            converter.fromS16BE(in.data(), out.data(), n, 1.0f);
+            REQUIRE(same(out, reference_s16be(in, n)));
+
+            std::vector<int16_t> cs16(2 * n);
+            if (n > 0) {
+                memcpy(cs16.data(), in.data(), in.size());
+            }
+            converter.fromS16(cs16.data(), out.data(), n, 1.0f / 2048);
+            REQUIRE(same(out, reference_s16(cs16, n)));
+        }
+    }
+}
+
+TEST_CASE("Unaligned buffers", "[conversion]") {
+    const size_t n = 1001;
+    const auto in = random_bytes(4 * n + 1, 7);
+    for (const auto kernel : SampleConverter::availableKernels()) {
+        INFO(SampleConverter::kernelName(kernel));
+        const SampleConverter converter(kernel);
+
+        std::vector<DSPCOMPLEX> expected(n);
+        SampleConverter(ConversionKernel::Generic).fromU8(in.data() + 1, expected.data(), n);
+
+        std::vector<float> out(2 * n + 1);
+        converter.fromU8(in.data() + 1, reinterpret_cast<DSPCOMPLEX*>(out.data() + 1), n);
+        REQUIRE(memcmp(out.data() + 1, expected.data(), n * sizeof(DSPCOMPLEX)) == 0);
+    }
+}
+
+TEST_CASE("Conversion throughput", "[conversion][benchmark]") {
+    const size_t n = 32768;
+    const int iterations = 2000;
+    const auto in = random_bytes(4 * n, 42);
+    std::vector<DSPCOMPLEX> out(n);
+
+    auto run = [&](const SampleConverter& converter, int format) {
+        const auto start = std::chrono::steady_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            switch (format) {
+                case 0: converter.fromU8(in.data(), out.data(), n); break;
+                case 1: converter.fromS8(in.data(), out.data(), n); break;
+                case 2: converter.fromS16LE(in.data(), out.data(), n, 1.0f); break;
+                case 3: converter.fromS16BE(in.data(), out.data(), n, 1.0f); break;
+            }
+        }
+        const std::chrono::duration<double> elapsed =
+            std::chrono::steady_clock::now() - start;
+        return (double)n * iterations / elapsed.count() / 1e6;
+    };
+
+    const char *formats[] = {"u8", "s8", "s16le", "s16be"};
+    for (const auto kernel : SampleConverter::availableKernels()) {
+        const SampleConverter converter(kernel);
+        std::cout << "Conversion " << SampleConverter::kernelName(kernel) << ":";
+        for (int format = 0; format < 4; format++) {
+            std::cout << " " << formats[format] << " " << run(converter, format) << " Msps";
+        }
+        std::cout << std::endl;
+    }
+    REQUIRE(std::isfinite(out[0].real()));
+}
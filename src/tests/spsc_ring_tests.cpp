@@ -0,0 +1,171 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+/**
+ * @file spsc_ring_tests.cpp
+ * @brief Tests for the single producer, single consumer ring buffer
+ */
+
+#define CATCH_CONFIG_MAIN
+#include "catch.hpp"
+
+#include "../various/spsc_ring.h"
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+TEST_CASE("The capacity is rounded up to a power of two", "[spscring]") {
+    SpscRing<uint8_t> ring(1000);
+    REQUIRE(ring.capacity() == 1024);
+    REQUIRE(ring.writeAvailable() == 1024);
+    REQUIRE(ring.readAvailable() == 0);
+}
+
+TEST_CASE("Copying in and out keeps the order", "[spscring]") {
+    SpscRing<int32_t> ring(16);
+    std::vector<int32_t> in(10);
+    std::vector<int32_t> out(10);
+
+    int32_t next = 0;
+    int32_t expected = 0;
+    for (int round = 0; round < 10; round++) {
+        for (auto& v : in) {
+            v = next++;
+        }
+        REQUIRE(ring.write(in.data(), in.size()) == in.size());
+        REQUIRE(ring.read(out.data(), out.size()) == out.size());
+        for (const auto v : out) {
+            REQUIRE(v == expected++);
+        }
+    }
+}
+
+TEST_CASE("A full ring drops what does not fit", "[spscring]") {
+    SpscRing<uint8_t> ring(8);
+    const std::vector<uint8_t> in(12, 1);
+    REQUIRE(ring.write(in.data(), in.size()) == 8);
+    REQUIRE(ring.writeAvailable() == 0);
+    REQUIRE(ring.acquireWrite(4).size == 0);
+}
+
+TEST_CASE("Spans stop at the end of a plain ring", "[spscring]") {
+    SpscRing<uint8_t> ring(8);
+    const std::vector<uint8_t> in(6, 1);
+    ring.write(in.data(), 6);
+    REQUIRE(ring.skip(6) == 6);
+
+    auto span = ring.acquireWrite(5);
+    REQUIRE(span.size == 2);
+    ring.commitWrite(span.size);
+    span = ring.acquireWrite(3);
+    REQUIRE(span.size == 3);
+    ring.commitWrite(span.size);
+
+    REQUIRE(ring.acquireRead(5).size == 2);
+}
+
+TEST_CASE("Spans of a mirrored ring are contiguous", "[spscring]") {
+    const size_t capacity = 2 * MirrorMapping::pageSize();
+    SpscRing<uint8_t> ring(capacity, true);
+    if (not ring.isMirrored()) {
+        WARN("No mirror mapping on this system");
+        return;
+    }
+
+    std::vector<uint8_t> in(capacity - 100);
+    ring.write(in.data(), in.size());
+    ring.skip(in.size());
+
+    // This span crosses the end of the buffer
+    auto span = ring.acquireWrite(1000);
+    REQUIRE(span.size == 1000);
+    for (size_t i = 0; i < span.size; i++) {
+        span.data[i] = i % 251;
+    }
+    ring.commitWrite(span.size);
+
+    const auto read = ring.acquireRead(1000);
+    REQUIRE(read.size == 1000);
+    for (size_t i = 0; i < read.size; i++) {
+        REQUIRE(read.data[i] == i % 251);
+    }
+    ring.commitRead(read.size);
+    REQUIRE(ring.readAvailable() == 0);
+}
+
+TEST_CASE("A flush drops the readable data", "[spscring]") {
+    SpscRing<uint8_t> ring(16);
+    const std::vector<uint8_t> in(10, 1);
+    ring.write(in.data(), in.size());
+    ring.flush();
+    REQUIRE(ring.readAvailable() == 0);
+
+    // What comes after the flush is kept
+    const std::vector<uint8_t> after(3, 2);
+    ring.write(after.data(), after.size());
+    REQUIRE(ring.readAvailable() == 3);
+
+    const auto span = ring.acquireRead(16);
+    REQUIRE(span.size == 3);
+    REQUIRE(span.data[0] == 2);
+    ring.commitRead(span.size);
+    REQUIRE(ring.writeAvailable() == 16);
+}
+
+TEST_CASE("A producer and a consumer thread", "[spscring]") {
+    for (const bool mirrored : {false, true}) {
+        SpscRing<uint32_t> ring(4096, mirrored);
+        const uint32_t count = 2000000;
+
+        std::thread producer([&]() {
+            uint32_t next = 0;
+            while (next < count) {
+                auto span = ring.acquireWrite(777);
+                size_t i = 0;
+                for (; i < span.size and next < count; i++) {
+                    span.data[i] = next++;
+                }
+                ring.commitWrite(i);
+            }
+        });
+
+        uint32_t expected = 0;
+        bool ok = true;
+        while (expected < count) {
+            const auto span = ring.acquireRead(1000);
+            for (size_t i = 0; i < span.size; i++) {
+                if (span.data[i] != expected++) {
+                    ok = false;
+                }
+            }
+            ring.commitRead(span.size);
+        }
+        producer.join();
+
+        INFO("mirrored " << mirrored);
+        REQUIRE(ok);
+    }
+}
@@ -0,0 +1,54 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "cpu_features.h"
+
+namespace cpu_features {
+
+#if defined(WELLE_HAVE_X86_SIMD)
+bool has_sse2()
+{
+    static const bool sse2 = __builtin_cpu_supports("sse2");
+    return sse2;
+}
+
+bool has_avx2()
+{
+    static const bool avx2 = __builtin_cpu_supports("avx2");
+    return avx2;
+}
+#else
+bool has_sse2() { return false; }
+bool has_avx2() { return false; }
+#endif
+
+#if defined(WELLE_HAVE_NEON)
+// If the compiler was allowed to emit NEON, the CPU supports it.
+bool has_neon() { return true; }
+#else
+bool has_neon() { return false; }
+#endif
+
+} // namespace cpu_features
@@ -0,0 +1,51 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+/* Compile-time availability of the SIMD code paths. The x86 kernels are
+ * built with function-level target attributes, so they do not need any
+ * global compiler flags and are selected at runtime. NEON is only
+ * available when the compiler targets it. */
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#  define WELLE_HAVE_X86_SIMD 1
+#endif
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#  define WELLE_HAVE_NEON 1
+#endif
+
+namespace cpu_features {
+
+/* Runtime CPU feature detection. The result is computed once
+ * and cached, the functions are cheap to call. */
+bool has_sse2(void);
+bool has_avx2(void);
+bool has_neon(void);
+
+} // namespace cpu_features
+
+#endif
@@ -26,15 +26,24 @@
  *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 #include    "fft.h"
+#include    <algorithm>
+#include    <cstdint>
 #include    <cstring>
+#include    <mutex>
+#include    <stdexcept>
 
 namespace fft {
 
 #ifndef KISSFFT
+// Only fftwf_execute is thread-safe, the planner is not. Receivers
+// can be created in parallel, e.g. by the batch mode of welle-cli.
+static std::mutex planner_mutex;
+
 Forward::Forward(int32_t fft_size)
 {
     vector = (DSPCOMPLEX *)FFTW_MALLOC(sizeof (DSPCOMPLEX) * fft_size);
     memset((void*)vector, 0, sizeof(DSPCOMPLEX) * fft_size);
+    std::lock_guard<std::mutex> lock(planner_mutex);
     plan  = FFTW_PLAN_DFT_1D(fft_size,
             reinterpret_cast<fftwf_complex*>(vector),
             reinterpret_cast<fftwf_complex*>(vector),
@@ -43,6 +52,7 @@ Forward::Forward(int32_t fft_size)
 
 Forward::~Forward()
 {
+    std::lock_guard<std::mutex> lock(planner_mutex);
     FFTW_DESTROY_PLAN(plan);
     FFTW_FREE(vector);
 }
@@ -64,6 +74,7 @@ Backward::Backward(int32_t fft_size) :
     for (int i = 0; i < fft_size; i ++) {
         vector [i] = 0;
     }
+    std::lock_guard<std::mutex> lock(planner_mutex);
     plan  = FFTW_PLAN_DFT_1D(fft_size,
             reinterpret_cast<fftwf_complex*>(vector),
             reinterpret_cast<fftwf_complex*>(vector),
@@ -72,6 +83,7 @@ Backward::Backward(int32_t fft_size) :
 
 Backward::~Backward ()
 {
+    std::lock_guard<std::mutex> lock(planner_mutex);
     FFTW_DESTROY_PLAN(plan);
     FFTW_FREE(vector);
 }
@@ -93,6 +105,108 @@ void Backward::do_IFFT()
     }
 }
 
+struct BatchForward::Share {
+    int32_t first = 0;
+    int32_t count = 0;
+
+    // Transforms all blocks of the share
+    FFTW_PLAN many = nullptr;
+
+    // One plan per block for a partial selection. The blocks do not all
+    // have the same alignment, each plan matches its block.
+    std::vector<FFTW_PLAN> single;
+};
+
+static const size_t batch_alignment = 64;
+
+BatchForward::BatchForward(int32_t fft_size, int32_t count,
+        int32_t distance, int32_t offset, size_t num_threads) :
+    fft_size(fft_size),
+    count(count),
+    distance(distance),
+    offset(offset)
+{
+    const int32_t num_shares = std::max<int32_t>(1,
+            std::min<int32_t>(count, num_threads));
+
+    /* The plans are made on a buffer that has the alignment of the
+     * buffers they will be executed on, FFTW_ESTIMATE leaves it alone. */
+    const size_t size = offset + (count - 1) * distance + fft_size;
+    std::vector<DSPCOMPLEX> planning(size + batch_alignment / sizeof(DSPCOMPLEX));
+    DSPCOMPLEX *base = planning.data();
+    while (reinterpret_cast<uintptr_t>(base) % batch_alignment != 0) {
+        base++;
+    }
+
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    for (int32_t i = 0; i < num_shares; i++) {
+        auto share = std::unique_ptr<Share>(new Share());
+        share->first = count * i / num_shares;
+        share->count = count * (i + 1) / num_shares - share->first;
+
+        fftwf_complex *p = reinterpret_cast<fftwf_complex*>(
+                base + offset + share->first * distance);
+        share->many = fftwf_plan_many_dft(1, &this->fft_size, share->count,
+                p, nullptr, 1, distance,
+                p, nullptr, 1, distance,
+                FFTW_FORWARD, FFTW_ESTIMATE);
+
+        for (int32_t block = 0; block < share->count; block++) {
+            fftwf_complex *b = p + block * distance;
+            share->single.push_back(FFTW_PLAN_DFT_1D(fft_size,
+                        b, b, FFTW_FORWARD, FFTW_ESTIMATE));
+        }
+        shares.push_back(std::move(share));
+    }
+
+    for (size_t i = 1; i < shares.size(); i++) {
+        threads.emplace_back(&BatchForward::workerthread, this, i);
+    }
+}
+
+BatchForward::~BatchForward()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    std::lock_guard<std::mutex> lock(planner_mutex);
+    for (auto& share : shares) {
+        FFTW_DESTROY_PLAN(share->many);
+        for (auto& plan : share->single) {
+            FFTW_DESTROY_PLAN(plan);
+        }
+    }
+}
+
+void BatchForward::transform(Share& share, DSPCOMPLEX *data,
+        const std::vector<bool> *selected)
+{
+    bool all = true;
+    for (int32_t i = share.first; selected and i < share.first + share.count; i++) {
+        all = all and (*selected)[i];
+    }
+
+    fftwf_complex *p = reinterpret_cast<fftwf_complex*>(
+            data + offset + share.first * distance);
+    if (all) {
+        fftwf_execute_dft(share.many, p, p);
+        return;
+    }
+
+    for (int32_t block = 0; block < share.count; block++) {
+        if ((*selected)[share.first + block]) {
+            fftwf_complex *b = p + block * distance;
+            fftwf_execute_dft(share.single[block], b, b);
+        }
+    }
+}
+
 #else // Kiss FFT
 
 Forward::Forward(int32_t fft_size) :
@@ -163,6 +277,131 @@ void Backward::do_IFFT()
     memcpy(fin, fout, fft_size * sizeof(kiss_fft_cpx));
 }
 
+struct BatchForward::Share {
+    int32_t first = 0;
+    int32_t count = 0;
+
+    kiss_fft_cfg cfg = nullptr;
+    // KISS FFT does not transform in place without allocating
+    std::vector<DSPCOMPLEX> scratch;
+};
+
+static const size_t batch_alignment = 64;
+
+BatchForward::BatchForward(int32_t fft_size, int32_t count,
+        int32_t distance, int32_t offset, size_t num_threads) :
+    fft_size(fft_size),
+    count(count),
+    distance(distance),
+    offset(offset)
+{
+    const int32_t num_shares = std::max<int32_t>(1,
+            std::min<int32_t>(count, num_threads));
+
+    for (int32_t i = 0; i < num_shares; i++) {
+        auto share = std::unique_ptr<Share>(new Share());
+        share->first = count * i / num_shares;
+        share->count = count * (i + 1) / num_shares - share->first;
+        share->cfg = kiss_fft_alloc(fft_size, 0, NULL, NULL);
+        share->scratch.resize(fft_size);
+        shares.push_back(std::move(share));
+    }
+
+    for (size_t i = 1; i < shares.size(); i++) {
+        threads.emplace_back(&BatchForward::workerthread, this, i);
+    }
+}
+
+BatchForward::~BatchForward()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    start_cv.notify_all();
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    for (auto& share : shares) {
+        free(share->cfg);
+    }
+}
+
+void BatchForward::transform(Share& share, DSPCOMPLEX *data,
+        const std::vector<bool> *selected)
+{
+    for (int32_t i = share.first; i < share.first + share.count; i++) {
+        if (selected and not (*selected)[i]) {
+            continue;
+        }
+
+        DSPCOMPLEX *block = data + offset + i * distance;
+        kiss_fft(share.cfg, (kiss_fft_cpx*)block,
+                (kiss_fft_cpx*)share.scratch.data());
+        memcpy(block, share.scratch.data(), fft_size * sizeof(DSPCOMPLEX));
+    }
+}
+
 #endif
 
+void BatchForward::do_FFT(DSPCOMPLEX *data)
+{
+    run(data, nullptr);
+}
+
+void BatchForward::do_FFT(DSPCOMPLEX *data, const std::vector<bool>& selected)
+{
+    if (selected.size() < (size_t)count) {
+        throw std::invalid_argument("BatchForward: selection too short");
+    }
+    run(data, &selected);
+}
+
+void BatchForward::run(DSPCOMPLEX *data, const std::vector<bool> *selected)
+{
+    if (reinterpret_cast<uintptr_t>(data) % batch_alignment != 0) {
+        throw std::invalid_argument("BatchForward: buffer not aligned");
+    }
+
+    if (not threads.empty()) {
+        std::lock_guard<std::mutex> lock(mutex);
+        job_data = data;
+        job_selected = selected;
+        busy_threads = threads.size();
+        generation++;
+    }
+    start_cv.notify_all();
+
+    transform(*shares[0], data, selected);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    done_cv.wait(lock, [this]() { return busy_threads == 0; });
+}
+
+void BatchForward::workerthread(size_t share_ix)
+{
+    uint64_t done_generation = 0;
+
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        start_cv.wait(lock, [&]() {
+                return stopping or generation != done_generation; });
+        if (stopping) {
+            return;
+        }
+        done_generation = generation;
+
+        DSPCOMPLEX *data = job_data;
+        const std::vector<bool> *selected = job_selected;
+        lock.unlock();
+        transform(*shares[share_ix], data, selected);
+        lock.lock();
+
+        if (--busy_threads == 0) {
+            done_cv.notify_one();
+        }
+    }
+}
+
 } // namespace fft
@@ -31,6 +31,12 @@
 #define _COMMON_FFT
 
 // Wrappers around fftwf and KISS FFT for both forward and backward FFTs
+#include <condition_variable>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 #include "dab-constants.h"
 
 namespace fft {
@@ -114,6 +120,58 @@ class Backward
 };
 #endif
 
+/* Forward FFT of count blocks of fft_size samples, in place in one buffer.
+ * Block i starts at sample offset + i * distance. The buffer must be
+ * aligned on 64 bytes, like the SampleBuffers of the frame pool.
+ *
+ * With FFTW, every thread executes a many-transform plan over its share
+ * of the blocks. With KISS FFT, the blocks are transformed one after the
+ * other. The calling thread takes the first share, and num_threads - 1
+ * threads are started for the others. */
+class BatchForward
+{
+    public:
+        BatchForward(int32_t fft_size, int32_t count,
+                int32_t distance, int32_t offset, size_t num_threads = 1);
+        ~BatchForward(void);
+        BatchForward(const BatchForward&) = delete;
+        BatchForward& operator=(const BatchForward&) = delete;
+
+        // Transform all blocks
+        void do_FFT(DSPCOMPLEX *data);
+
+        // Transform the blocks i for which selected[i] is true
+        void do_FFT(DSPCOMPLEX *data, const std::vector<bool>& selected);
+
+    private:
+        // The blocks of one thread, and what it needs to transform them
+        struct Share;
+
+        void run(DSPCOMPLEX *data, const std::vector<bool> *selected);
+        void transform(Share& share, DSPCOMPLEX *data,
+                const std::vector<bool> *selected);
+        void workerthread(size_t share_ix);
+
+        const int32_t fft_size;
+        const int32_t count;
+        const int32_t distance;
+        const int32_t offset;
+
+        std::vector<std::unique_ptr<Share> > shares;
+
+        std::vector<std::thread> threads;
+        std::mutex mutex;
+        std::condition_variable start_cv;
+        std::condition_variable done_cv;
+        uint64_t generation = 0;
+        size_t busy_threads = 0;
+        bool stopping = false;
+
+        // The job of the current generation
+        DSPCOMPLEX *job_data = nullptr;
+        const std::vector<bool> *job_selected = nullptr;
+};
+
 } // namespace fft
 
 #endif
@@ -0,0 +1,145 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#ifndef MPSC_QUEUE_H
+#define MPSC_QUEUE_H
+
+/*
+ *  Bounded lock-free queue for any number of producer threads and one
+ *  consumer thread.
+ *
+ *  Every cell carries a sequence number that tells whose turn it is: a
+ *  producer claims the cell at the head with a compare-and-swap when its
+ *  sequence equals the head, moves its element in, and publishes it by
+ *  advancing the sequence. The consumer takes the element out once it
+ *  sees the published sequence, and gives the cell back to the producers
+ *  of the next round. Producers never wait: when the queue is full,
+ *  tryPush() fails and the caller keeps its element.
+ *
+ *  The capacity is rounded up to a power of two. The elements are moved
+ *  in and out, a vector or a string changes hands without being copied.
+ */
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+template <class T>
+class MpscQueue {
+    public:
+        MpscQueue(size_t minCapacity) {
+            size_t capacity = 1;
+            while (capacity < minCapacity) {
+                capacity *= 2;
+            }
+            mask = capacity - 1;
+
+            cells = std::vector<Cell>(capacity);
+            for (size_t i = 0; i < capacity; i++) {
+                cells[i].sequence.store(i, std::memory_order_relaxed);
+            }
+        }
+
+        MpscQueue(const MpscQueue&) = delete;
+        MpscQueue& operator=(const MpscQueue&) = delete;
+
+        size_t capacity(void) const { return mask + 1; }
+
+        /* Any thread. Returns false, leaving value alone, if the
+         * queue is full. */
+        bool tryPush(T&& value) {
+            size_t pos = head.load(std::memory_order_relaxed);
+            for (;;) {
+                Cell& cell = cells[pos & mask];
+                const size_t seq = cell.sequence.load(std::memory_order_acquire);
+                const intptr_t diff = (intptr_t)seq - (intptr_t)pos;
+                if (diff == 0) {
+                    if (head.compare_exchange_weak(pos, pos + 1,
+                                std::memory_order_relaxed)) {
+                        cell.value = std::move(value);
+                        cell.sequence.store(pos + 1, std::memory_order_release);
+                        return true;
+                    }
+                    // pos was updated by the failed exchange
+                }
+                else if (diff < 0) {
+                    // The consumer has not taken this cell of the
+                    // previous round yet
+                    return false;
+                }
+                else {
+                    pos = head.load(std::memory_order_relaxed);
+                }
+            }
+        }
+
+        /* Consumer side. Returns false if no element is published. An
+         * element still being moved in by a producer stops the consumer,
+         * even if later elements are complete. */
+        bool tryPop(T& value) {
+            Cell& cell = cells[tail & mask];
+            const size_t seq = cell.sequence.load(std::memory_order_acquire);
+            if (seq != tail + 1) {
+                return false;
+            }
+            value = std::move(cell.value);
+            cell.sequence.store(tail + capacity(), std::memory_order_release);
+            tail++;
+            tailPublished.store(tail, std::memory_order_relaxed);
+            return true;
+        }
+
+        /* Any thread: the number of elements claimed and not yet
+         * taken out, approximate while the producers are busy. */
+        size_t size(void) const {
+            const size_t h = head.load(std::memory_order_relaxed);
+            const size_t t = tailPublished.load(std::memory_order_relaxed);
+            return h > t ? h - t : 0;
+        }
+
+    private:
+        struct Cell {
+            std::atomic<size_t> sequence;
+            T value;
+        };
+
+        size_t mask = 0;
+        std::vector<Cell> cells;
+
+        // The producers and the consumer work on different cache lines.
+        // Padded rather than aligned, operator new of C++14 does not
+        // honour an alignment above the one of max_align_t.
+        char padHead[64];
+        std::atomic<size_t> head = ATOMIC_VAR_INIT(0);
+        char padTail[64];
+        size_t tail = 0;
+        std::atomic<size_t> tailPublished = ATOMIC_VAR_INIT(0);
+        char padEnd[64];
+};
+
+#endif
@@ -53,11 +53,13 @@ const char* mark_to_cstr(const ProfilingMark& m) {
         MARK_TO_CSTR_CASE(DecodeTII)
 
         MARK_TO_CSTR_CASE(ProcessPRS)
+        MARK_TO_CSTR_CASE(SymbolsFFT)
         MARK_TO_CSTR_CASE(ProcessSymbol)
         MARK_TO_CSTR_CASE(Deinterleaver)
         MARK_TO_CSTR_CASE(FICHandler)
         MARK_TO_CSTR_CASE(MSCHandler)
         MARK_TO_CSTR_CASE(SymbolProcessed)
+        MARK_TO_CSTR_CASE(SymbolSkipped)
 
         MARK_TO_CSTR_CASE(DAGetMSCData)
         MARK_TO_CSTR_CASE(DADeinterleave)
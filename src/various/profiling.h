@@ -47,11 +47,13 @@ enum class ProfilingMark {
     DecodeTII,
 
     ProcessPRS,
+    SymbolsFFT,
     ProcessSymbol,
     Deinterleaver,
     FICHandler,
     MSCHandler,
     SymbolProcessed,
+    SymbolSkipped,
 
     DAGetMSCData,
     DADeinterleave,
@@ -0,0 +1,398 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#include <cstring>
+#include "sample_conversion.h"
+#include "cpu_features.h"
+
+#if defined(WELLE_HAVE_X86_SIMD)
+#  include <immintrin.h>
+#endif
+#if defined(WELLE_HAVE_NEON)
+#  include <arm_neon.h>
+#endif
+
+static_assert(sizeof(DSPCOMPLEX) == 2 * sizeof(float),
+        "The kernels write interleaved float samples");
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+static const bool hostIsBigEndian = true;
+#else
+static const bool hostIsBigEndian = false;
+#endif
+
+//  The kernels convert n values, i.e. n / 2 complex samples. The SIMD
+//  kernels leave the tail to the generic ones.
+
+static void u8_generic(const uint8_t *in, float *out, size_t n, float scale)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)((int32_t)in[i] - 128) * scale;
+    }
+}
+
+static void s8_generic(const uint8_t *in, float *out, size_t n, float scale)
+{
+    for (size_t i = 0; i < n; i++) {
+        out[i] = (float)(int8_t)in[i] * scale;
+    }
+}
+
+static void s16_generic(const uint8_t *in, float *out, size_t n, float scale)
+{
+    for (size_t i = 0; i < n; i++) {
+        int16_t v;
+        memcpy(&v, in + 2 * i, sizeof(v));
+        out[i] = (float)v * scale;
+    }
+}
+
+static void s16_swapped_generic(const uint8_t *in, float *out, size_t n, float scale)
+{
+    for (size_t i = 0; i < n; i++) {
+        uint8_t b[2] = { in[2 * i + 1], in[2 * i] };
+        int16_t v;
+        memcpy(&v, b, sizeof(v));
+        out[i] = (float)v * scale;
+    }
+}
+
+#if defined(WELLE_HAVE_X86_SIMD)
+//  Four 32-bit integers to scaled floats
+__attribute__((target("sse2")))
+static inline void store_SSE2(float *out, __m128i v, __m128 scale)
+{
+    _mm_storeu_ps(out, _mm_mul_ps(_mm_cvtepi32_ps(v), scale));
+}
+
+__attribute__((target("sse2")))
+static void u8_SSE2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i offset = _mm_set1_epi32(128);
+    const __m128 s = _mm_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i lo = _mm_unpacklo_epi8(x, zero);
+        const __m128i hi = _mm_unpackhi_epi8(x, zero);
+        store_SSE2(out + i,      _mm_sub_epi32(_mm_unpacklo_epi16(lo, zero), offset), s);
+        store_SSE2(out + i + 4,  _mm_sub_epi32(_mm_unpackhi_epi16(lo, zero), offset), s);
+        store_SSE2(out + i + 8,  _mm_sub_epi32(_mm_unpacklo_epi16(hi, zero), offset), s);
+        store_SSE2(out + i + 12, _mm_sub_epi32(_mm_unpackhi_epi16(hi, zero), offset), s);
+    }
+    u8_generic(in + i, out + i, n - i, scale);
+}
+
+__attribute__((target("sse2")))
+static void s8_SSE2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m128 s = _mm_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        // Sign extension by shifting the byte down from the top
+        const __m128i lo = _mm_srai_epi16(_mm_unpacklo_epi8(x, x), 8);
+        const __m128i hi = _mm_srai_epi16(_mm_unpackhi_epi8(x, x), 8);
+        store_SSE2(out + i,      _mm_srai_epi32(_mm_unpacklo_epi16(lo, lo), 16), s);
+        store_SSE2(out + i + 4,  _mm_srai_epi32(_mm_unpackhi_epi16(lo, lo), 16), s);
+        store_SSE2(out + i + 8,  _mm_srai_epi32(_mm_unpacklo_epi16(hi, hi), 16), s);
+        store_SSE2(out + i + 12, _mm_srai_epi32(_mm_unpackhi_epi16(hi, hi), 16), s);
+    }
+    s8_generic(in + i, out + i, n - i, scale);
+}
+
+__attribute__((target("sse2")))
+static inline void s16_block_SSE2(__m128i x, float *out, __m128 s)
+{
+    store_SSE2(out,     _mm_srai_epi32(_mm_unpacklo_epi16(x, x), 16), s);
+    store_SSE2(out + 4, _mm_srai_epi32(_mm_unpackhi_epi16(x, x), 16), s);
+}
+
+__attribute__((target("sse2")))
+static void s16_SSE2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m128 s = _mm_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        s16_block_SSE2(x, out + i, s);
+    }
+    s16_generic(in + 2 * i, out + i, n - i, scale);
+}
+
+__attribute__((target("sse2")))
+static void s16_swapped_SSE2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m128 s = _mm_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        const __m128i x = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        s16_block_SSE2(_mm_or_si128(_mm_slli_epi16(x, 8), _mm_srli_epi16(x, 8)),
+                out + i, s);
+    }
+    s16_swapped_generic(in + 2 * i, out + i, n - i, scale);
+}
+
+//  Eight 32-bit integers to scaled floats
+__attribute__((target("avx2")))
+static inline void store_AVX2(float *out, __m256i v, __m256 scale)
+{
+    _mm256_storeu_ps(out, _mm256_mul_ps(_mm256_cvtepi32_ps(v), scale));
+}
+
+__attribute__((target("avx2")))
+static void u8_AVX2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m256i offset = _mm256_set1_epi32(128);
+    const __m256 s = _mm256_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16));
+        store_AVX2(out + i,      _mm256_sub_epi32(_mm256_cvtepu8_epi32(x0), offset), s);
+        store_AVX2(out + i + 8,  _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(x0, 8)), offset), s);
+        store_AVX2(out + i + 16, _mm256_sub_epi32(_mm256_cvtepu8_epi32(x1), offset), s);
+        store_AVX2(out + i + 24, _mm256_sub_epi32(_mm256_cvtepu8_epi32(_mm_srli_si128(x1, 8)), offset), s);
+    }
+    u8_generic(in + i, out + i, n - i, scale);
+}
+
+__attribute__((target("avx2")))
+static void s8_AVX2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m256 s = _mm256_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 32 <= n; i += 32) {
+        const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+        const __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 16));
+        store_AVX2(out + i,      _mm256_cvtepi8_epi32(x0), s);
+        store_AVX2(out + i + 8,  _mm256_cvtepi8_epi32(_mm_srli_si128(x0, 8)), s);
+        store_AVX2(out + i + 16, _mm256_cvtepi8_epi32(x1), s);
+        store_AVX2(out + i + 24, _mm256_cvtepi8_epi32(_mm_srli_si128(x1, 8)), s);
+    }
+    s8_generic(in + i, out + i, n - i, scale);
+}
+
+__attribute__((target("avx2")))
+static void s16_AVX2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m256 s = _mm256_set1_ps(scale);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        const __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16));
+        store_AVX2(out + i,     _mm256_cvtepi16_epi32(x0), s);
+        store_AVX2(out + i + 8, _mm256_cvtepi16_epi32(x1), s);
+    }
+    s16_generic(in + 2 * i, out + i, n - i, scale);
+}
+
+__attribute__((target("avx2")))
+static void s16_swapped_AVX2(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const __m256 s = _mm256_set1_ps(scale);
+    const __m128i swap = _mm_setr_epi8(1, 0, 3, 2, 5, 4, 7, 6,
+            9, 8, 11, 10, 13, 12, 15, 14);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const __m128i x0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i));
+        const __m128i x1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + 2 * i + 16));
+        store_AVX2(out + i,     _mm256_cvtepi16_epi32(_mm_shuffle_epi8(x0, swap)), s);
+        store_AVX2(out + i + 8, _mm256_cvtepi16_epi32(_mm_shuffle_epi8(x1, swap)), s);
+    }
+    s16_swapped_generic(in + 2 * i, out + i, n - i, scale);
+}
+#endif
+
+#if defined(WELLE_HAVE_NEON)
+//  Eight 16-bit integers to scaled floats
+static inline void store_NEON(float *out, int16x8_t v, float scale)
+{
+    vst1q_f32(out,     vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_low_s16(v))), scale));
+    vst1q_f32(out + 4, vmulq_n_f32(vcvtq_f32_s32(vmovl_s16(vget_high_s16(v))), scale));
+}
+
+static void u8_NEON(const uint8_t *in, float *out, size_t n, float scale)
+{
+    const int16x8_t offset = vdupq_n_s16(128);
+
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const uint8x16_t x = vld1q_u8(in + i);
+        store_NEON(out + i, vsubq_s16(
+                    vreinterpretq_s16_u16(vmovl_u8(vget_low_u8(x))), offset), scale);
+        store_NEON(out + i + 8, vsubq_s16(
+                    vreinterpretq_s16_u16(vmovl_u8(vget_high_u8(x))), offset), scale);
+    }
+    u8_generic(in + i, out + i, n - i, scale);
+}
+
+static void s8_NEON(const uint8_t *in, float *out, size_t n, float scale)
+{
+    size_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+        const int8x16_t x = vld1q_s8(reinterpret_cast<const int8_t*>(in + i));
+        store_NEON(out + i, vmovl_s8(vget_low_s8(x)), scale);
+        store_NEON(out + i + 8, vmovl_s8(vget_high_s8(x)), scale);
+    }
+    s8_generic(in + i, out + i, n - i, scale);
+}
+
+static void s16_NEON(const uint8_t *in, float *out, size_t n, float scale)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        store_NEON(out + i, vreinterpretq_s16_u8(vld1q_u8(in + 2 * i)), scale);
+    }
+    s16_generic(in + 2 * i, out + i, n - i, scale);
+}
+
+static void s16_swapped_NEON(const uint8_t *in, float *out, size_t n, float scale)
+{
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        store_NEON(out + i, vreinterpretq_s16_u8(vrev16q_u8(vld1q_u8(in + 2 * i))), scale);
+    }
+    s16_swapped_generic(in + 2 * i, out + i, n - i, scale);
+}
+#endif
+
+SampleConverter::SampleConverter() :
+    SampleConverter(bestKernel())
+{
+}
+
+SampleConverter::SampleConverter(ConversionKernel kernel) :
+    kernel(kernel),
+    u8(u8_generic),
+    s8(s8_generic),
+    s16(s16_generic),
+    s16Swapped(s16_swapped_generic)
+{
+    switch (kernel) {
+#if defined(WELLE_HAVE_X86_SIMD)
+        case ConversionKernel::SSE2:
+            u8 = u8_SSE2;
+            s8 = s8_SSE2;
+            s16 = s16_SSE2;
+            s16Swapped = s16_swapped_SSE2;
+            break;
+        case ConversionKernel::AVX2:
+            u8 = u8_AVX2;
+            s8 = s8_AVX2;
+            s16 = s16_AVX2;
+            s16Swapped = s16_swapped_AVX2;
+            break;
+#endif
+#if defined(WELLE_HAVE_NEON)
+        case ConversionKernel::NEON:
+            u8 = u8_NEON;
+            s8 = s8_NEON;
+            s16 = s16_NEON;
+            s16Swapped = s16_swapped_NEON;
+            break;
+#endif
+        default:
+            this->kernel = ConversionKernel::Generic;
+            break;
+    }
+}
+
+void SampleConverter::fromU8(const uint8_t *in, DSPCOMPLEX *out,
+        size_t n, float scale) const
+{
+    u8(in, reinterpret_cast<float*>(out), 2 * n, scale);
+}
+
+void SampleConverter::fromS8(const uint8_t *in, DSPCOMPLEX *out,
+        size_t n, float scale) const
+{
+    s8(in, reinterpret_cast<float*>(out), 2 * n, scale);
+}
+
+void SampleConverter::fromS16(const int16_t *in, DSPCOMPLEX *out,
+        size_t n, float scale) const
+{
+    s16(reinterpret_cast<const uint8_t*>(in),
+            reinterpret_cast<float*>(out), 2 * n, scale);
+}
+
+void SampleConverter::fromS16LE(const uint8_t *in, DSPCOMPLEX *out,
+        size_t n, float scale) const
+{
+    (hostIsBigEndian ? s16Swapped : s16)(in,
+            reinterpret_cast<float*>(out), 2 * n, scale);
+}
+
+void SampleConverter::fromS16BE(const uint8_t *in, DSPCOMPLEX *out,
+        size_t n, float scale) const
+{
+    (hostIsBigEndian ? s16 : s16Swapped)(in,
+            reinterpret_cast<float*>(out), 2 * n, scale);
+}
+
+ConversionKernel SampleConverter::bestKernel()
+{
+    if (cpu_features::has_avx2())
+        return ConversionKernel::AVX2;
+    if (cpu_features::has_sse2())
+        return ConversionKernel::SSE2;
+    if (cpu_features::has_neon())
+        return ConversionKernel::NEON;
+    return ConversionKernel::Generic;
+}
+
+std::vector<ConversionKernel> SampleConverter::availableKernels()
+{
+    std::vector<ConversionKernel> kernels = { ConversionKernel::Generic };
+    if (cpu_features::has_sse2())
+        kernels.push_back(ConversionKernel::SSE2);
+    if (cpu_features::has_avx2())
+        kernels.push_back(ConversionKernel::AVX2);
+    if (cpu_features::has_neon())
+        kernels.push_back(ConversionKernel::NEON);
+    return kernels;
+}
+
+const char *SampleConverter::kernelName(ConversionKernel kernel)
+{
+    switch (kernel) {
+        case ConversionKernel::Generic: return "generic";
+        case ConversionKernel::SSE2: return "SSE2";
+        case ConversionKernel::AVX2: return "AVX2";
+        case ConversionKernel::NEON: return "NEON";
+    }
+    return "unknown";
+}
@@ -0,0 +1,90 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#ifndef SAMPLE_CONVERSION_H
+#define SAMPLE_CONVERSION_H
+
+/*
+ *  Conversion of the integer sample formats of the inputs to DSPCOMPLEX.
+ *
+ *  All formats are interleaved I/Q pairs, n is the number of complex
+ *  samples. Every sample is converted to float and multiplied by scale,
+ *  8-bit unsigned samples are centred on 128 first. With a power of two
+ *  scale, as used by the inputs, the result is exact and all kernels give
+ *  the same output bit for bit.
+ */
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "dab-constants.h"
+
+enum class ConversionKernel { Generic, SSE2, AVX2, NEON };
+
+class SampleConverter
+{
+    public:
+        /* Uses the fastest kernel the CPU supports */
+        SampleConverter(void);
+        SampleConverter(ConversionKernel kernel);
+
+        // Unsigned 8-bit, e.g. RTL-SDR: (x - 128) * scale
+        void fromU8(const uint8_t *in, DSPCOMPLEX *out, size_t n,
+                float scale = 1.0f / 128) const;
+
+        // Signed 8-bit
+        void fromS8(const uint8_t *in, DSPCOMPLEX *out, size_t n,
+                float scale = 1.0f / 128) const;
+
+        // Signed 16-bit of the host byte order, i.e. complex int16
+        void fromS16(const int16_t *in, DSPCOMPLEX *out, size_t n,
+                float scale) const;
+
+        // Signed 16-bit of a given byte order, e.g. from a file
+        void fromS16LE(const uint8_t *in, DSPCOMPLEX *out, size_t n,
+                float scale) const;
+        void fromS16BE(const uint8_t *in, DSPCOMPLEX *out, size_t n,
+                float scale) const;
+
+        ConversionKernel getKernel(void) const { return kernel; }
+
+        /* Runtime CPU feature detection */
+        static ConversionKernel bestKernel(void);
+        static std::vector<ConversionKernel> availableKernels(void);
+        static const char *kernelName(ConversionKernel kernel);
+
+    private:
+        using convert_fn = void (*)(const uint8_t *in, float *out,
+                size_t n, float scale);
+
+        ConversionKernel kernel;
+        convert_fn u8;
+        convert_fn s8;
+        convert_fn s16;
+        convert_fn s16Swapped;
+};
+
+#endif
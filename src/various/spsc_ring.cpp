@@ -0,0 +1,94 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#include "spsc_ring.h"
+
+#if defined(__linux__)
+#  include <sys/mman.h>
+#  include <sys/syscall.h>
+#  include <unistd.h>
+#endif
+
+#if defined(__linux__) && defined(SYS_memfd_create)
+#  define WELLE_HAVE_MIRROR_MAPPING 1
+#endif
+
+MirrorMapping::~MirrorMapping()
+{
+#if defined(WELLE_HAVE_MIRROR_MAPPING)
+    if (address) {
+        munmap(address, 2 * mappedSize);
+    }
+#endif
+}
+
+size_t MirrorMapping::pageSize(void)
+{
+#if defined(WELLE_HAVE_MIRROR_MAPPING)
+    return sysconf(_SC_PAGESIZE);
+#else
+    return 4096;
+#endif
+}
+
+void *MirrorMapping::map(size_t size)
+{
+#if defined(WELLE_HAVE_MIRROR_MAPPING)
+    // An anonymous file holds the memory, mapped once at the start of a
+    // reserved range of twice the size, and once right after it.
+    const int fd = syscall(SYS_memfd_create, "welle-ring", 0);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    void *result = nullptr;
+    if (ftruncate(fd, size) == 0) {
+        void *range = mmap(nullptr, 2 * size, PROT_NONE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (range != MAP_FAILED) {
+            char *base = static_cast<char*>(range);
+            void *first = mmap(base, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED, fd, 0);
+            void *second = mmap(base + size, size, PROT_READ | PROT_WRITE,
+                    MAP_SHARED | MAP_FIXED, fd, 0);
+            if (first == base and second == base + size) {
+                address = range;
+                mappedSize = size;
+                result = range;
+            }
+            else {
+                munmap(range, 2 * size);
+            }
+        }
+    }
+
+    close(fd);
+    return result;
+#else
+    (void)size;
+    return nullptr;
+#endif
+}
@@ -0,0 +1,230 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#ifndef SPSC_RING_H
+#define SPSC_RING_H
+
+/*
+ *  Lock-free ring buffer for one producer thread and one consumer thread.
+ *
+ *  Besides copying data in and out, both sides can work in place: the
+ *  producer acquires a span of free elements, fills it and commits it,
+ *  and the consumer acquires a span of readable elements, uses it and
+ *  commits it, which gives the space back to the producer.
+ *
+ *  The capacity is rounded up to a power of two. When the ring is
+ *  mirrored, its memory is mapped twice back to back, so that a span
+ *  never wraps around: acquireRead(n) and acquireWrite(n) return n
+ *  elements whenever they are available. Without the mirror, which is
+ *  also the fallback when the system cannot map it, spans stop at the
+ *  end of the buffer and the rest comes with the next acquire.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+/* The memory of a mirrored ring, see spsc_ring.cpp */
+class MirrorMapping {
+    public:
+        MirrorMapping() = default;
+        MirrorMapping(const MirrorMapping&) = delete;
+        MirrorMapping& operator=(const MirrorMapping&) = delete;
+        ~MirrorMapping();
+
+        /* Map size bytes twice, back to back. size must be a multiple
+         * of the page size. Returns nullptr if the system cannot do it. */
+        void *map(size_t size);
+
+        static size_t pageSize(void);
+
+    private:
+        void *address = nullptr;
+        size_t mappedSize = 0;
+};
+
+template <class T>
+struct RingSpan {
+    T *data;
+    size_t size;
+};
+
+template <class T>
+class SpscRing {
+    static_assert(std::is_trivially_copyable<T>::value,
+            "The ring copies its elements with memcpy");
+
+    public:
+        SpscRing(size_t minCapacity, bool mirrored = false) {
+            size_t capacity = 1;
+            while (capacity < minCapacity) {
+                capacity *= 2;
+            }
+            mask = capacity - 1;
+
+            const size_t bytes = capacity * sizeof(T);
+            if (mirrored and bytes % MirrorMapping::pageSize() == 0) {
+                buffer = static_cast<T*>(mirror.map(bytes));
+            }
+            if (buffer == nullptr) {
+                plain.resize(capacity);
+                buffer = plain.data();
+            }
+        }
+
+        SpscRing(const SpscRing&) = delete;
+        SpscRing& operator=(const SpscRing&) = delete;
+
+        size_t capacity(void) const { return mask + 1; }
+        bool isMirrored(void) const { return plain.empty(); }
+
+        /* Any thread: drop everything written so far. The consumer
+         * drops it with its next acquireRead() or skip(), since it is
+         * the only one that moves the read index. */
+        void flush(void) {
+            flushIndex.store(head.load(std::memory_order_acquire),
+                    std::memory_order_release);
+        }
+
+        /* Producer side */
+        size_t writeAvailable(void) const {
+            return capacity() -
+                (head.load(std::memory_order_relaxed) -
+                 tail.load(std::memory_order_acquire));
+        }
+
+        RingSpan<T> acquireWrite(size_t n) {
+            n = std::min(n, writeAvailable());
+            const size_t index = head.load(std::memory_order_relaxed) & mask;
+            if (not isMirrored()) {
+                n = std::min(n, capacity() - index);
+            }
+            return RingSpan<T>{buffer + index, n};
+        }
+
+        /* Publish the first n elements of the last acquired span */
+        void commitWrite(size_t n) {
+            head.store(head.load(std::memory_order_relaxed) + n,
+                    std::memory_order_release);
+        }
+
+        /* Copy at most n elements in, returns the number copied. The
+         * rest is dropped if the ring is full. */
+        size_t write(const T *data, size_t n) {
+            size_t written = 0;
+            while (written < n) {
+                const auto span = acquireWrite(n - written);
+                if (span.size == 0) {
+                    break;
+                }
+                memcpy(span.data, data + written, span.size * sizeof(T));
+                commitWrite(span.size);
+                written += span.size;
+            }
+            return written;
+        }
+
+        /* Consumer side, readAvailable() can also be used by other
+         * threads to see how full the ring is. */
+        size_t readAvailable(void) const {
+            const uint64_t h = head.load(std::memory_order_acquire);
+            return h - readIndex();
+        }
+
+        RingSpan<const T> acquireRead(size_t n) {
+            applyFlush();
+            n = std::min(n, readAvailable());
+            const size_t index = tail.load(std::memory_order_relaxed) & mask;
+            if (not isMirrored()) {
+                n = std::min(n, capacity() - index);
+            }
+            return RingSpan<const T>{buffer + index, n};
+        }
+
+        /* Give the first n elements of the last acquired span back
+         * to the producer */
+        void commitRead(size_t n) {
+            tail.store(tail.load(std::memory_order_relaxed) + n,
+                    std::memory_order_release);
+        }
+
+        /* Copy at most n elements out, returns the number copied */
+        size_t read(T *data, size_t n) {
+            size_t numRead = 0;
+            while (numRead < n) {
+                const auto span = acquireRead(n - numRead);
+                if (span.size == 0) {
+                    break;
+                }
+                memcpy(data + numRead, span.data, span.size * sizeof(T));
+                commitRead(span.size);
+                numRead += span.size;
+            }
+            return numRead;
+        }
+
+        size_t skip(size_t n) {
+            applyFlush();
+            n = std::min(n, readAvailable());
+            commitRead(n);
+            return n;
+        }
+
+    private:
+        // The read index, taking a flush into account
+        uint64_t readIndex(void) const {
+            const uint64_t t = tail.load(std::memory_order_acquire);
+            const uint64_t f = flushIndex.load(std::memory_order_acquire);
+            return (int64_t)(f - t) > 0 ? f : t;
+        }
+
+        void applyFlush(void) {
+            tail.store(readIndex(), std::memory_order_release);
+        }
+
+        // The indices only grow, the element of index i is at i & mask.
+        // They are 64 bit wide so that they never wrap around.
+        // Each one is written by one side only, and the padding keeps them
+        // on separate cache lines so that the two sides do not share a line.
+        static constexpr size_t cacheLine = 64;
+        std::atomic<uint64_t> head{0};
+        char headPadding[cacheLine - sizeof(std::atomic<uint64_t>)];
+        std::atomic<uint64_t> tail{0};
+        char tailPadding[cacheLine - sizeof(std::atomic<uint64_t>)];
+        // Everything before it was flushed
+        std::atomic<uint64_t> flushIndex{0};
+
+        size_t mask;
+        T *buffer = nullptr;
+        MirrorMapping mirror;
+        std::vector<T> plain;
+};
+
+#endif
@@ -0,0 +1,288 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <thread>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "welle-cli/batchdecoder.h"
+#include "welle-cli/batchreport.h"
+#include "backend/radio-receiver.h"
+#include "input/raw_file.h"
+
+#ifdef GITDESCRIBE
+#define VERSION GITDESCRIBE
+#else
+#define VERSION "unknown"
+#endif
+
+using namespace std;
+
+/* Collects what the receiver tells about the ensemble of one file */
+class BatchRadioInterface : public RadioControllerInterface {
+    public:
+        virtual void onSNR(float snr) override { this->snr = snr; }
+        virtual void onFrequencyCorrectorChange(int fine, int coarse) override
+        {
+            frequencyCorrection = fine + coarse;
+        }
+        virtual void onSyncChange(char isSync) override { (void)isSync; }
+        virtual void onSignalPresence(bool isSignal) override { (void)isSignal; }
+        virtual void onServiceDetected(uint32_t sId) override { (void)sId; }
+        virtual void onNewEnsemble(uint16_t eId) override { (void)eId; }
+        virtual void onSetEnsembleLabel(DabLabel& label) override { (void)label; }
+        virtual void onDateTimeUpdate(const dab_date_time_t& dateTime) override
+        {
+            lastDateTime = dateTime;
+        }
+
+        virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override
+        {
+            (void)fib;
+            numFibs++;
+            if (not crcCheckOk) {
+                numFicCrcErrors++;
+            }
+        }
+
+        // The CIR peaks go into the JSON, nothing else is plotted
+        virtual uint32_t getDiagnosticSubscriptions(void) const override
+        {
+            return DIAGNOSTIC_IMPULSE_RESPONSE;
+        }
+
+        virtual void onNewImpulseResponse(std::vector<float>&& data) override
+        {
+            lastCIR = move(data);
+        }
+        virtual void onConstellationPoints(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
+        virtual void onNewNullSymbol(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
+
+        virtual void onTIIMeasurement(tii_measurement_t&& m) override
+        {
+            tiis[make_pair(m.comb, m.pattern)].push_back(move(m));
+        }
+
+        virtual void onMessage(message_level_t level, const std::string& text, const std::string& text2 = std::string()) override
+        {
+            string fullText = text + text2;
+            switch (level) {
+                case message_level_t::Information:
+                    messages.push_back("INFO : " + fullText);
+                    break;
+                case message_level_t::Error:
+                    messages.push_back("ERROR: " + fullText);
+                    break;
+            }
+        }
+
+        float snr = 0;
+        int frequencyCorrection = 0;
+        dab_date_time_t lastDateTime;
+        size_t numFibs = 0;
+        size_t numFicCrcErrors = 0;
+        vector<float> lastCIR;
+        map<pair<int, int>, list<tii_measurement_t> > tiis;
+        vector<string> messages;
+};
+
+BatchDecoder::BatchDecoder(RadioReceiverOptions rro, size_t numWorkers) :
+    rro(rro),
+    numWorkers(max<size_t>(numWorkers, 1))
+{
+    // Every worker decodes its file on its own thread, and the file
+    // waits for the decoder
+    this->rro.singleThreaded = true;
+    this->rro.frameQueueBackpressure = true;
+}
+
+size_t BatchDecoder::run(const vector<string>& files)
+{
+    nextFile = 0;
+    numFailed = 0;
+
+    vector<thread> workers;
+    const size_t n = min(numWorkers, files.size());
+    for (size_t i = 0; i < n; i++) {
+        workers.emplace_back(&BatchDecoder::worker, this, cref(files));
+    }
+
+    for (auto& t : workers) {
+        t.join();
+    }
+
+    return numFailed;
+}
+
+vector<string> BatchDecoder::listIQFiles(const vector<string>& paths)
+{
+    vector<string> files;
+
+    for (const auto& path : paths) {
+        struct stat st;
+        if (stat(path.c_str(), &st) != 0 or not S_ISDIR(st.st_mode)) {
+            // Let decodeFile report files that cannot be opened
+            files.push_back(path);
+            continue;
+        }
+
+        DIR *dir = opendir(path.c_str());
+        if (dir == nullptr) {
+            cerr << "Cannot open directory " << path << endl;
+            continue;
+        }
+
+        vector<string> dirFiles;
+        while (const struct dirent *entry = readdir(dir)) {
+            if (entry->d_name[0] == '.') {
+                continue;
+            }
+
+            const string file = path + "/" + entry->d_name;
+            if (stat(file.c_str(), &st) == 0 and S_ISREG(st.st_mode)) {
+                dirFiles.push_back(file);
+            }
+        }
+        closedir(dir);
+
+        sort(dirFiles.begin(), dirFiles.end());
+        files.insert(files.end(), dirFiles.begin(), dirFiles.end());
+    }
+
+    return files;
+}
+
+void BatchDecoder::worker(const vector<string>& files)
+{
+    for (size_t i = nextFile++; i < files.size(); i = nextFile++) {
+        const auto result = decodeFile(files[i]);
+        if (not result.error.empty()) {
+            numFailed++;
+        }
+
+        const string line = build_batch_file_json(result);
+        lock_guard<mutex> lock(outputMutex);
+        cout << line << endl;
+    }
+}
+
+BatchFileJson BatchDecoder::decodeFile(const string& file)
+{
+    BatchFileJson result;
+    result.file = file;
+
+    auto& mux = result.mux;
+    mux.receiver.software.name = "welle.io";
+    mux.receiver.software.version = VERSION;
+    mux.receiver.software.fftwindowplacement = fftPlacementMethodToString(rro.fftPlacementMethod);
+    mux.receiver.software.coarsecorrectorenabled = not rro.disableCoarseCorrector;
+    mux.receiver.software.freqsyncmethod = freqSyncMethodToString(rro.freqsyncMethod);
+    mux.receiver.software.lastchannelchange = chrono::system_clock::now();
+
+    BatchRadioInterface ri;
+    CRAWFile in(ri, false, false);
+    in.setFileName(file, "auto");
+    if (not in.is_ok()) {
+        result.error = "Cannot open file";
+        return result;
+    }
+    mux.receiver.hardware.name = in.getDescription();
+    mux.receiver.hardware.gain = in.getGain();
+
+    // The receiver refers to the handlers, they must outlive it
+    BatchProgrammeHandlers handlers;
+    RadioReceiver rx(ri, in, rro);
+
+    const auto wallStart = chrono::steady_clock::now();
+    rx.restart(false);
+
+    // Tune all audio services as soon as the FIC lists them
+    uint64_t ensembleVersion = 0;
+    rx.runSingleThreaded([&]() {
+            const auto ensemble = rx.getEnsembleSnapshot();
+            if (ensemble->version == ensembleVersion) {
+                return not in.endWasReached();
+            }
+            ensembleVersion = ensemble->version;
+
+            for (const auto& s : ensemble->services) {
+                if (handlers.count(s.serviceId) or
+                        not rx.serviceHasAudioComponent(s)) {
+                    continue;
+                }
+
+                auto handler = make_unique<BatchProgrammeHandler>();
+                if (rx.addServiceToDecode(*handler, "", s)) {
+                    handlers.emplace(s.serviceId, move(handler));
+                }
+            }
+            return not in.endWasReached(); });
+
+    const chrono::duration<double> wallTime = chrono::steady_clock::now() - wallStart;
+    result.wall_seconds = wallTime.count();
+    result.signal_seconds = (double)in.getPosition() / INPUT_RATE;
+
+    const auto rx_stats = rx.getReceiverStats();
+    stop_and_report(rx, mux, handlers);
+
+    mux.utctime.year = ri.lastDateTime.year;
+    mux.utctime.month = ri.lastDateTime.month;
+    mux.utctime.day = ri.lastDateTime.day;
+    mux.utctime.hour = ri.lastDateTime.hour;
+    mux.utctime.minutes = ri.lastDateTime.minutes;
+    mux.utctime.lto = ri.lastDateTime.hourOffset + ((double)ri.lastDateTime.minuteOffset / 30.0);
+    mux.messages = move(ri.messages);
+
+    mux.demodulator_fic_numcrcerrors = ri.numFicCrcErrors;
+    mux.demodulator_snr = ri.snr;
+    mux.demodulator_frequencycorrection = ri.frequencyCorrection;
+    mux.demodulator_timelastfct0frame = rx_stats.timeLastFCT0Frame;
+    mux.demodulator_framequeue_depth = rx_stats.frameQueue.depth;
+    mux.demodulator_framequeue_highwatermark = rx_stats.frameQueue.highWaterMark;
+    mux.demodulator_framequeue_decoded = rx_stats.frameQueue.framesDecoded;
+    mux.demodulator_framequeue_dropped = rx_stats.frameQueue.framesDropped;
+    mux.demodulator_eventqueue_depth = rx_stats.eventQueue.depth;
+    mux.demodulator_eventqueue_highwatermark = rx_stats.eventQueue.highWaterMark;
+    mux.demodulator_eventqueue_delivered = rx_stats.eventQueue.eventsDelivered;
+    mux.demodulator_eventqueue_dropped = rx_stats.eventQueue.eventsDropped;
+    mux.demodulator_figcache_hits = rx_stats.figCache.hits;
+    mux.demodulator_figcache_misses = rx_stats.figCache.misses;
+    mux.demodulator_ensemblecache_preloaded = rx_stats.ensembleCache.preloaded;
+    mux.demodulator_ensemblecache_contradictions = rx_stats.ensembleCache.contradictions;
+    mux.demodulator_ensemblecache_timetoplayms = rx_stats.ensembleCache.timeToPlay;
+    mux.tii = summarise_tii(ri.tiis);
+    mux.cir_peaks = calculate_cir_peaks(ri.lastCIR);
+
+    result.fic_numfibs = ri.numFibs;
+    if (ri.numFibs == 0) {
+        result.error = "No FIC could be decoded";
+    }
+
+    return result;
+}
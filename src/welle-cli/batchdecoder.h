@@ -0,0 +1,65 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "radio-receiver-options.h"
+#include "welle-cli/jsonconvert.h"
+
+/* Decodes a set of IQ files in parallel, one file per worker thread.
+ * Each worker runs its own single-threaded RadioReceiver on a CRAWFile,
+ * decodes all audio services, and prints one line of JSON per file. */
+class BatchDecoder {
+    public:
+        BatchDecoder(RadioReceiverOptions rro, size_t numWorkers);
+
+        /* Decode all files and return the number of files that could
+         * not be decoded. */
+        size_t run(const std::vector<std::string>& files);
+
+        /* Replace the directories in paths by the regular files they
+         * contain, in alphabetical order. Hidden files are skipped. */
+        static std::vector<std::string> listIQFiles(
+                const std::vector<std::string>& paths);
+
+    private:
+        void worker(const std::vector<std::string>& files);
+        BatchFileJson decodeFile(const std::string& file);
+
+        RadioReceiverOptions rro;
+        size_t numWorkers;
+
+        std::atomic<size_t> nextFile = ATOMIC_VAR_INIT(0);
+        std::atomic<size_t> numFailed = ATOMIC_VAR_INIT(0);
+
+        // Serialises the output of the workers
+        std::mutex outputMutex;
+};
@@ -0,0 +1,59 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "welle-cli/batchreport.h"
+#include "backend/fib-processor.h"
+
+using namespace std;
+
+void build_batch_services(MuxJson& mux, const EnsembleSnapshot& ensemble,
+        const BatchProgrammeHandlers& handlers)
+{
+    mux.ensemble = build_ensemble_json(ensemble);
+
+    for (const auto& s : ensemble.services) {
+        ServiceJson service = build_service_json(ensemble, s);
+
+        const auto h = handlers.find(s.serviceId);
+        if (h != handlers.end()) {
+            const auto& ph = *h->second;
+            service.channels = 2;
+            service.samplerate = ph.rate;
+            service.mode = ph.mode;
+            service.dls_label = ph.dls;
+            service.errorcounters_frameerrors = ph.numFrameErrors;
+            service.errorcounters_rserrors = ph.numRsErrors;
+            service.errorcounters_aacerrors = ph.numAacErrors;
+            service.xpaderror_haserror = ph.xpadError;
+            service.xpaderror_announcedlen = ph.xpadAnnouncedLen;
+            service.xpaderror_len = ph.xpadLen;
+        }
+        else {
+            service.mode = "invalid";
+        }
+
+        mux.services.push_back(move(service));
+    }
+}
@@ -0,0 +1,100 @@
+/*
+ *    Copyright (C) 2026
+ *    welle.io contributors
+ *
+ *    This file is part of the welle.io.
+ *    Many of the ideas as implemented in welle.io are derived from
+ *    other work, made available through the GNU general Public License.
+ *    All copyrights of the original authors are recognized.
+ *
+ *    welle.io is free software; you can redistribute it and/or modify
+ *    it under the terms of the GNU General Public License as published by
+ *    the Free Software Foundation; either version 2 of the License, or
+ *    (at your option) any later version.
+ *
+ *    welle.io is distributed in the hope that it will be useful,
+ *    but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *    GNU General Public License for more details.
+ *
+ *    You should have received a copy of the GNU General Public License
+ *    along with welle.io; if not, write to the Free Software
+ *    Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include "backend/radio-controller.h"
+#include "welle-cli/jsonconvert.h"
+
+/* Counts the errors of one service. The receiver is single-threaded,
+ * the counters are only read once it is stopped. */
+class BatchProgrammeHandler : public ProgrammeHandlerInterface {
+    public:
+        virtual void onFrameErrors(int frameErrors) override
+        {
+            numFrameErrors += frameErrors;
+        }
+
+        virtual void onNewAudio(std::vector<int16_t>&& audioData, int sampleRate, const std::string& mode) override
+        {
+            (void)audioData;
+            rate = sampleRate;
+            this->mode = mode;
+        }
+
+        virtual void onRsErrors(bool uncorrectedErrors, int numCorrectedErrors) override
+        {
+            (void)numCorrectedErrors;
+            numRsErrors += (uncorrectedErrors ? 1 : 0);
+        }
+
+        virtual void onAacErrors(int aacErrors) override { numAacErrors += aacErrors; }
+        virtual void onNewDynamicLabel(const std::string& label) override { dls = label; }
+        virtual void onMOT(const mot_file_t& mot_file) override { (void)mot_file; }
+        virtual void onPADLengthError(size_t announced_xpad_len, size_t xpad_len) override
+        {
+            xpadError = true;
+            xpadAnnouncedLen = announced_xpad_len;
+            xpadLen = xpad_len;
+        }
+
+        size_t numFrameErrors = 0;
+        size_t numRsErrors = 0;
+        size_t numAacErrors = 0;
+        int rate = 0;
+        std::string mode;
+        std::string dls;
+        bool xpadError = false;
+        size_t xpadAnnouncedLen = 0;
+        size_t xpadLen = 0;
+};
+
+// The handlers of the services of a file that were decoded, by SId
+using BatchProgrammeHandlers =
+    std::map<uint32_t, std::unique_ptr<BatchProgrammeHandler> >;
+
+// The ensemble and its services, with the counters of the decoded ones
+void build_batch_services(MuxJson& mux, const EnsembleSnapshot& ensemble,
+        const BatchProgrammeHandlers& handlers);
+
+/* Stop the receiver and report what it found in the file. Stopping
+ * clears the ensemble, the report comes from the snapshot taken before.
+ * Receiver is a RadioReceiver, or anything with its getEnsembleSnapshot()
+ * and stop(). */
+template<class Receiver>
+void stop_and_report(Receiver& rx, MuxJson& mux,
+        const BatchProgrammeHandlers& handlers)
+{
+    const auto ensemble = rx.getEnsembleSnapshot();
+    rx.stop();
+    build_batch_services(mux, *ensemble, handlers);
+}
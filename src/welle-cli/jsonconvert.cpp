@@ -25,6 +25,10 @@
 
 #include "welle-cli/jsonconvert.h"
 #include "libs/json.hpp"
+#include "fib-processor.h"
+#include <algorithm>
+#include <iomanip>
+#include <sstream>
 
 using namespace std;
 
@@ -228,6 +232,19 @@ static void to_json(nlohmann::json& j, const MuxJson& mux) {
     j["demodulator"]["time_last_fct0_frame"] = timelastfct0_ms;
     j["demodulator"]["snr"] = mux.demodulator_snr;
     j["demodulator"]["frequencycorrection"] = mux.demodulator_frequencycorrection;
+    j["demodulator"]["framequeue"]["depth"] = mux.demodulator_framequeue_depth;
+    j["demodulator"]["framequeue"]["highwatermark"] = mux.demodulator_framequeue_highwatermark;
+    j["demodulator"]["framequeue"]["decoded"] = mux.demodulator_framequeue_decoded;
+    j["demodulator"]["framequeue"]["dropped"] = mux.demodulator_framequeue_dropped;
+    j["demodulator"]["eventqueue"]["depth"] = mux.demodulator_eventqueue_depth;
+    j["demodulator"]["eventqueue"]["highwatermark"] = mux.demodulator_eventqueue_highwatermark;
+    j["demodulator"]["eventqueue"]["delivered"] = mux.demodulator_eventqueue_delivered;
+    j["demodulator"]["eventqueue"]["dropped"] = mux.demodulator_eventqueue_dropped;
+    j["demodulator"]["figcache"]["hits"] = mux.demodulator_figcache_hits;
+    j["demodulator"]["figcache"]["misses"] = mux.demodulator_figcache_misses;
+    j["demodulator"]["ensemblecache"]["preloaded"] = mux.demodulator_ensemblecache_preloaded;
+    j["demodulator"]["ensemblecache"]["contradictions"] = mux.demodulator_ensemblecache_contradictions;
+    j["demodulator"]["ensemblecache"]["timetoplayms"] = mux.demodulator_ensemblecache_timetoplayms;
 }
 
 std::string build_mux_json(const MuxJson& mux)
@@ -235,3 +252,178 @@ std::string build_mux_json(const MuxJson& mux)
     nlohmann::json j = mux;
     return j.dump();
 }
+
+std::string build_batch_file_json(const BatchFileJson& f)
+{
+    nlohmann::json j = nlohmann::json{
+        {"file", f.file},
+        {"signal", f.signal_seconds},
+        {"walltime", f.wall_seconds},
+        {"mux", f.mux}
+    };
+
+    if (f.error.empty()) {
+        j["error"] = nullptr;
+    }
+    else {
+        j["error"] = f.error;
+    }
+
+    j["fic"]["numfibs"] = f.fic_numfibs;
+    j["fic"]["numcrcerrors"] = f.mux.demodulator_fic_numcrcerrors;
+    return j.dump();
+}
+
+string to_hex(uint32_t value, int width)
+{
+    stringstream sidstream;
+    sidstream << "0x" <<
+        setfill('0') << setw(width) <<
+        hex << value;
+    return sidstream.str();
+}
+
+EnsembleJson build_ensemble_json(const EnsembleSnapshot& ensemble)
+{
+    EnsembleJson e;
+    e.label = ensemble.ensembleLabel;
+    e.id = to_hex(ensemble.ensembleId, 4);
+    e.ecc = to_hex(ensemble.ensembleEcc, 2);
+    return e;
+}
+
+ServiceJson build_service_json(const EnsembleSnapshot& ensemble, const Service& s)
+{
+    ServiceJson service;
+    service.sid = to_hex(s.serviceId, 4);
+    service.programType = s.programType;
+    service.ptystring = DABConstants::getProgramTypeName(s.programType);
+    service.language = s.language;
+    service.languagestring = DABConstants::getLanguageName(s.language);
+    service.label = s.serviceLabel;
+    service.url_mp3 = "";
+
+    for (const auto c : ensemble.findComponents(s.serviceId)) {
+        const auto& sc = *c;
+        ComponentJson component;
+        component.componentnr = sc.componentNr;
+        component.primary = (sc.PS_flag ? true : false);
+        component.caflag = (sc.CAflag ? true : false);
+        component.label = sc.componentLabel;
+
+        const Subchannel *subchannel = ensemble.findSubchannel(sc.subchannelId);
+        const auto sub = subchannel ? *subchannel : Subchannel();
+
+        switch (sc.transportMode()) {
+            case TransportMode::Audio:
+                component.transportmode = "audio";
+                component.ascty = make_unique<string>(
+                        string{
+                            (sc.audioType() == AudioServiceComponentType::DAB ? "DAB" :
+                             sc.audioType() == AudioServiceComponentType::DABPlus ? "DAB+" :
+                             "unknown")});
+                if (sc.audioType() == AudioServiceComponentType::DAB or
+                    sc.audioType() == AudioServiceComponentType::DABPlus) {
+                    string urlmp3 = "/mp3/" + to_hex(s.serviceId, 4);
+                    service.url_mp3 = urlmp3;
+                }
+                break;
+            case TransportMode::FIDC:
+                component.transportmode = "fidc";
+                component.dscty = make_unique<uint16_t>(sc.DSCTy);
+                break;
+            case TransportMode::PacketData:
+                component.transportmode = "packetdata";
+                component.scid = make_unique<uint16_t>(sc.SCId);
+                break;
+            case TransportMode::StreamData:
+                component.transportmode = "streamdata";
+                component.dscty = make_unique<uint16_t>(sc.DSCTy);
+                break;
+        }
+
+        component.subchannel = sub;
+
+        service.components.push_back(move(component));
+    }
+
+    return service;
+}
+
+vector<PeakJson> calculate_cir_peaks(const vector<float>& cir_linear)
+{
+    constexpr size_t num_peaks = 6;
+
+    vector<PeakJson> peaks;
+
+    if (not cir_linear.empty()) {
+        vector<float> cir_lin(cir_linear);
+
+        // Every time we find a peak, we attenuate it, including
+        // its surrounding values, and we go search the next peak.
+        for (size_t peak = 0; peak < num_peaks; peak++) {
+            PeakJson p;
+            for (size_t i = 1; i < cir_lin.size(); i++) {
+                if (cir_lin[i] > p.value) {
+                    p.value = cir_lin[i];
+                    p.index = i;
+                }
+            }
+
+            const size_t windowsize = 25;
+            for (size_t j = 0; j < windowsize; j++) {
+                const ssize_t i = p.index + j - windowsize/2;
+                if (i >= 0 and i < (ssize_t)cir_lin.size()) {
+                    cir_lin[i] *= 0;
+                }
+            }
+
+            peaks.push_back(move(p));
+        }
+    }
+
+    return peaks;
+}
+
+list<tii_measurement_t> summarise_tii(
+        const map<pair<int, int>, list<tii_measurement_t> >& tiis)
+{
+    list<tii_measurement_t> l;
+
+    for (const auto& cp_list : tiis) {
+        const auto comb = cp_list.first.first;
+        const auto pattern = cp_list.first.second;
+
+        if (cp_list.second.size() < 5) {
+            continue;
+        }
+
+        tii_measurement_t avg;
+        avg.comb = comb;
+        avg.pattern = pattern;
+        vector<int> delays;
+        double error = 0.0;
+        size_t len = 0;
+        for (const auto& meas : cp_list.second) {
+            delays.push_back(meas.delay_samples);
+            error += meas.error;
+            len++;
+        }
+
+        if (len > 0) {
+            avg.error = error / len;
+
+            // Calculate the median
+            nth_element(delays.begin(), delays.begin() + len/2, delays.end());
+            avg.delay_samples = delays[len/2];
+        }
+        else {
+            // To quiet static analysis check
+            avg.error = 0.0;
+            avg.delay_samples = 0;
+        }
+        l.push_back(move(avg));
+    }
+
+    return l;
+}
@@ -27,12 +27,16 @@
 #include <string>
 #include <chrono>
 #include <list>
+#include <map>
+#include <utility>
 #include <vector>
 #include <memory>
 #include <ctime>
 #include "dab-constants.h"
 #include "backend/radio-controller.h"
 
+struct EnsembleSnapshot;
+
 struct SoftwareJson {
     std::string name;
     std::string version;
@@ -139,9 +143,54 @@ struct MuxJson {
     double demodulator_snr = 0.0;
     double demodulator_frequencycorrection = 0.0;
     std::chrono::system_clock::time_point demodulator_timelastfct0frame;
+    size_t demodulator_framequeue_depth = 0;
+    size_t demodulator_framequeue_highwatermark = 0;
+    uint64_t demodulator_framequeue_decoded = 0;
+    uint64_t demodulator_framequeue_dropped = 0;
+    size_t demodulator_eventqueue_depth = 0;
+    size_t demodulator_eventqueue_highwatermark = 0;
+    uint64_t demodulator_eventqueue_delivered = 0;
+    uint64_t demodulator_eventqueue_dropped = 0;
+    uint64_t demodulator_figcache_hits = 0;
+    uint64_t demodulator_figcache_misses = 0;
+    bool demodulator_ensemblecache_preloaded = false;
+    uint64_t demodulator_ensemblecache_contradictions = 0;
+    int64_t demodulator_ensemblecache_timetoplayms = -1;
 
     std::list<tii_measurement_t> tii;
     std::vector<PeakJson> cir_peaks;
 };
 
 std::string build_mux_json(const MuxJson& mux);
+
+// What the batch mode of welle-cli found in one IQ file
+struct BatchFileJson {
+    std::string file;
+    // Empty if the file could be decoded
+    std::string error;
+
+    double signal_seconds = 0.0;
+    double wall_seconds = 0.0;
+    size_t fic_numfibs = 0;
+
+    MuxJson mux;
+};
+
+std::string build_batch_file_json(const BatchFileJson& f);
+
+std::string to_hex(uint32_t value, int width);
+
+// From a snapshot of the ensemble, which stays valid after the
+// RadioReceiver is stopped
+EnsembleJson build_ensemble_json(const EnsembleSnapshot& ensemble);
+
+// The service and its components as the ensemble describes them,
+// without anything about the audio decoding
+ServiceJson build_service_json(const EnsembleSnapshot& ensemble, const Service& s);
+
+std::vector<PeakJson> calculate_cir_peaks(const std::vector<float>& cir_linear);
+
+// Median delay and average error for every comb and pattern that was
+// measured at least five times
+std::list<tii_measurement_t> summarise_tii(
+        const std::map<std::pair<int, int>, std::list<tii_measurement_t> >& tiis);
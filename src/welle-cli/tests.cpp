@@ -32,6 +32,7 @@
 
 #include "tests.h"
 #include "backend/radio-receiver.h"
+#include "backend/viterbi.h"
 #include "raw_file.h"
 #include "various/profiling.h"
 #include <algorithm>
@@ -42,6 +43,7 @@
 #include <iostream>
 #include <utility>
 #include <cstdio>
+#include <ctime>
 
 using namespace std;
 
@@ -101,6 +103,10 @@ class ChannelSimulator : public CVirtualInput
         virtual int32_t getSamplesToRead(void)
             { return parentInput->getSamplesToRead(); }
 
+        virtual int32_t waitForSamples(int32_t n,
+                std::chrono::milliseconds timeout)
+            { return parentInput->waitForSamples(n, timeout); }
+
         virtual float getGain() const
             { return parentInput->getGain(); }
 
@@ -162,7 +168,8 @@ class TestRadioInterface : public RadioControllerInterface {
         }
 
         virtual void onDateTimeUpdate(const dab_date_time_t& dateTime) override { (void)dateTime; }
-        virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override { (void)crcCheckOk; (void)fib; }
+        virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override { (void)crcCheckOk; (void)fib; num_fibs++; }
+        virtual uint32_t getDiagnosticSubscriptions(void) const override { return DIAGNOSTIC_IMPULSE_RESPONSE; }
         virtual void onNewImpulseResponse(std::vector<float>&& data) override
         {
             if (data.size() != 2048) {
@@ -196,6 +203,7 @@ class TestRadioInterface : public RadioControllerInterface {
         virtual void onTIIMeasurement(tii_measurement_t&& m) override { (void)m; }
         size_t num_syncs = 0;
         size_t num_desyncs = 0;
+        size_t num_fibs = 0;
         chrono::steady_clock::time_point first_sync_time;
 };
 
@@ -369,6 +377,107 @@ void Tests::test_multipath(int test_id)
     fclose(fd);
 }
 
+void Tests::test_viterbi_kernels()
+{
+    // Decode the same random soft bits with every kernel the CPU supports,
+    // check the output against the generic kernel and report throughput.
+    // 768 bits is one FIC block, 3072 bits one CIF of a 128kbps subchannel.
+    const int16_t wordlengths[] = {768, 24 * 128};
+    const int iterations = 500;
+
+    for (const int16_t wordlength : wordlengths) {
+        vector<softbit_t> input(wordlength * 4 + 24);
+        uniform_int_distribution<int> softbit(-127, 127);
+        for (auto& sb : input) {
+            sb = softbit(random_generator);
+        }
+
+        vector<uint8_t> reference(wordlength);
+        Viterbi(wordlength, ViterbiKernel::Generic).deconvolve(
+                input.data(), reference.data());
+
+        for (const auto kernel : Viterbi::availableKernels()) {
+            Viterbi viterbi(wordlength, kernel);
+            vector<uint8_t> output(wordlength);
+
+            const auto start_time = chrono::steady_clock::now();
+            for (int i = 0; i < iterations; i++) {
+                viterbi.deconvolve(input.data(), output.data());
+            }
+            const chrono::duration<double> elapsed =
+                chrono::steady_clock::now() - start_time;
+
+            const double mbps = (double)wordlength * iterations /
+                elapsed.count() / 1e6;
+            cerr << "Viterbi " << Viterbi::kernelName(kernel) <<
+                " " << wordlength << " bits: " << mbps << " Mbit/s" <<
+                (output == reference ? "" : " OUTPUT MISMATCH") << endl;
+        }
+    }
+}
+
+void Tests::test_fic_only()
+{
+    // Process the file in FIC-only mode, in receive mode without any
+    // programme selected, and in receive mode decoding one programme,
+    // and compare the CPU time per frame.
+    struct Run {
+        const char *name;
+        bool ficOnly;
+        bool playProgramme;
+    };
+    const Run runs[] = {
+        {"FIC-only", true, false},
+        {"Full, idle", false, false},
+        {"Full, one programme", false, true} };
+
+    // In transmission mode I, a frame carries 4 CIFs of 3 FIBs each
+    const size_t fibsPerFrame = 12;
+
+    auto& intf = dynamic_cast<CRAWFile&>(*input_interface);
+
+    for (const auto& run : runs) {
+        TestRadioInterface ri;
+        TestProgrammeHandler tph;
+
+        const clock_t cpu_start = clock();
+        {
+            RadioReceiver rx(ri, intf, rro);
+            rx.restart(false);
+            rx.setFicOnly(run.ficOnly);
+
+            bool service_selected = not run.playProgramme;
+            while (not intf.endWasReached()) {
+                this_thread::sleep_for(chrono::milliseconds(120));
+
+                if (service_selected) {
+                    continue;
+                }
+
+                for (const auto& s : rx.getServiceList()) {
+                    if (rx.playSingleProgramme(tph, "", s)) {
+                        service_selected = true;
+                        break;
+                    }
+                }
+            }
+
+            rx.stop();
+        }
+        const double cpu_ms = 1000.0 * (clock() - cpu_start) / CLOCKS_PER_SEC;
+        const size_t num_frames = ri.num_fibs / fibsPerFrame;
+
+        cerr << run.name << ": " << num_frames << " frames, " <<
+            cpu_ms << " ms CPU";
+        if (num_frames > 0) {
+            cerr << ", " << cpu_ms / num_frames << " ms CPU per frame";
+        }
+        cerr << endl;
+
+        intf.rewind();
+    }
+}
+
 void Tests::run_test(int test_id)
 {
     rro.fftPlacementMethod = DEFAULT_FFT_PLACEMENT;
@@ -376,5 +485,7 @@ void Tests::run_test(int test_id)
     if (test_id == 0) test_with_noise();
     else if (test_id == 1 or test_id == 2) test_multipath(test_id);
     else if (test_id == 3) test_with_noise_iteration(0);
+    else if (test_id == 4) test_viterbi_kernels();
+    else if (test_id == 5) test_fic_only();
     else cerr << "Test " << test_id << " does not exist!" << endl;
 }
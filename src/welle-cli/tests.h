@@ -45,6 +45,8 @@ class Tests {
         void test_with_noise();
         void test_with_noise_iteration(double stddev);
         void test_multipath(int test_id);
+        void test_viterbi_kernels();
+        void test_fic_only();
 
         std::unique_ptr<CVirtualInput>& input_interface;
         RadioReceiverOptions rro;
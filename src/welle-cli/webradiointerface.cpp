@@ -113,15 +113,6 @@ static const char* http_contenttype_ico =
 
 static const char* http_nocache = "Cache-Control: no-cache\r\n";
 
-static string to_hex(uint32_t value, int width)
-{
-    stringstream sidstream;
-    sidstream << "0x" <<
-        setfill('0') << setw(width) <<
-        hex << value;
-    return sidstream.str();
-}
-
 static bool send_http_response(Socket& s, const string& statuscode,
         const string& data, const string& content_type = http_contenttype_text) {
     string headers = statuscode;
@@ -165,6 +156,7 @@ WebRadioInterface::WebRadioInterface(CVirtualInput& in,
 
         time_rx_created = chrono::system_clock::now();
         rx->restart(false);
+        use_ensemble_cache();
     }
 
     programme_handler_thread = thread(&WebRadioInterface::handle_phs, this);
@@ -185,12 +177,62 @@ WebRadioInterface::~WebRadioInterface()
 
 class TuneFailed {};
 
+// The SId in a /stream/ or /slide/ URL, in the form of mux.json or in
+// decimal. Returns 0, which is no valid SId, if the URL has neither.
+static uint32_t parse_sid(const string& stream)
+{
+    try {
+        if (stream.compare(0, 2, "0x") == 0) {
+            const uint32_t sid = stoul(stream.substr(2), nullptr, 16);
+            if (to_hex(sid, 4) == stream) {
+                return sid;
+            }
+        }
+        return stoul(stream);
+    }
+    catch (const invalid_argument&) {
+        return 0;
+    }
+    catch (const out_of_range&) {
+        return 0;
+    }
+}
+
+void WebRadioInterface::use_ensemble_cache()
+{
+    try {
+        const auto channel = channels.getChannelForFrequency(input.getFrequency());
+        if (rx->useEnsembleCache(channel)) {
+            cerr << "Preloaded the cached ensemble of " << channel << endl;
+        }
+    }
+    catch (const out_of_range&) {
+        // Not tuned to a channel, e.g. reading a file
+    }
+}
+
 void WebRadioInterface::check_decoders_required()
 {
     lock_guard<mutex> lock(rx_mut);
     ASSERT_RX;
 
     try {
+        if (retune_programmes.exchange(false)) {
+            for (auto& p : programmes_being_decoded) {
+                if (p.second) {
+                    // The corrected ensemble might not describe what the
+                    // programme was tuned to any more. It is tuned again
+                    // below, a service the FIC dropped is not.
+                    const auto ph = phs.find(p.first);
+                    if (ph != phs.end()) {
+                        rx->removeServiceToDecode(ph->second);
+                    }
+                    p.second = false;
+                    programmes_retuning.insert(p.first);
+                }
+            }
+        }
+
         for (auto& s : rx->getServiceList()) {
             const auto sid = s.serviceId;
 
@@ -214,6 +256,11 @@ void WebRadioInterface::check_decoders_required()
 
                     if (success) {
                         programmes_being_decoded[sid] = success;
+                        programmes_retuning.erase(sid);
+                    }
+                    else if (programmes_retuning.count(sid)) {
+                        // The FIC has not described the new subchannel
+                        // yet, try again next time
                     }
                     else {
                         throw TuneFailed();
@@ -237,11 +284,20 @@ void WebRadioInterface::check_decoders_required()
                     " because no handler exists!" << endl;
             }
         }
+
+        // Without any listener, we only need to follow the FIC
+        const bool idle = none_of(
+                programmes_being_decoded.cbegin(),
+                programmes_being_decoded.cend(),
+                [](const pair<const SId_t, bool>& p) { return p.second; });
+        rx->setFicOnly(idle);
     }
     catch (const TuneFailed&) {
         rx->restart_decoder();
+        rx->setFicOnly(true);
         phs.clear();
         programmes_being_decoded.clear();
+        programmes_retuning.clear();
         carousel_services_available.clear();
         carousel_services_active.clear();
     }
@@ -274,6 +330,7 @@ void WebRadioInterface::retune(const string& channel)
         ASSERT_RX;
 
         cerr << "RETUNE Destroy RX" << endl;
+        rx->saveEnsembleCache();
         rx.reset();
 
         {
@@ -304,6 +361,7 @@ void WebRadioInterface::retune(const string& channel)
 
         time_rx_created = chrono::system_clock::now();
         rx->restart(false);
+        use_ensemble_cache();
 
         cerr << "RETUNE Start programme handler" << endl;
         running = true;
@@ -479,6 +537,8 @@ bool WebRadioInterface::dispatch_client(Socket&& client)
                 success = send_file(s, favicon_ico, favicon_ico_len, http_contenttype_ico);
             }
             else if (req.url == "/mux.json") {
+                // For the CIR peaks
+                subscribe_diagnostic(DIAGNOSTIC_IMPULSE_RESPONSE);
                 success = send_mux_json(s);
             }
             else if (req.url == "/mux.m3u") {
@@ -488,15 +548,19 @@ bool WebRadioInterface::dispatch_client(Socket&& client)
                 success = send_fic(s);
             }
             else if (req.url == "/impulseresponse") {
+                subscribe_diagnostic(DIAGNOSTIC_IMPULSE_RESPONSE);
                 success = send_impulseresponse(s);
             }
             else if (req.url == "/spectrum") {
+                subscribe_diagnostic(DIAGNOSTIC_SPECTRUM);
                 success = send_spectrum(s);
             }
             else if (req.url == "/constellation") {
+                subscribe_diagnostic(DIAGNOSTIC_CONSTELLATION);
                 success = send_constellation(s);
             }
             else if (req.url == "/nullspectrum") {
+                subscribe_diagnostic(DIAGNOSTIC_NULL_SYMBOL);
                 success = send_null_spectrum(s);
             }
             else if (req.url == "/channel") {
@@ -593,41 +657,6 @@ bool WebRadioInterface::send_file(Socket& s,
     return true;
 }
 
-static vector<PeakJson> calculate_cir_peaks(const vector<float>& cir_linear)
-{
-    constexpr size_t num_peaks = 6;
-
-    vector<PeakJson> peaks;
-
-    if (not cir_linear.empty()) {
-        vector<float> cir_lin(cir_linear);
-
-        // Every time we find a peak, we attenuate it, including
-        // its surrounding values, and we go search the next peak.
-        for (size_t peak = 0; peak < num_peaks; peak++) {
-            PeakJson p;
-            for (size_t i = 1; i < cir_lin.size(); i++) {
-                if (cir_lin[i] > p.value) {
-                    p.value = cir_lin[i];
-                    p.index = i;
-                }
-            }
-
-            const size_t windowsize = 25;
-            for (size_t j = 0; j < windowsize; j++) {
-                const ssize_t i = p.index + j - windowsize/2;
-                if (i >= 0 and i < (ssize_t)cir_lin.size()) {
-                    cir_lin[i] *= 0;
-                }
-            }
-
-            peaks.push_back(move(p));
-        }
-    }
-
-    return peaks;
-}
-
 bool WebRadioInterface::send_mux_json(Socket& s)
 {
     MuxJson mux_json;
@@ -650,62 +679,11 @@ bool WebRadioInterface::send_mux_json(Socket& s)
         lock_guard<mutex> lock(rx_mut);
         ASSERT_RX;
 
-        mux_json.ensemble.label = rx->getEnsembleLabel();
-
-        mux_json.ensemble.id = to_hex(rx->getEnsembleId(), 4);
-        mux_json.ensemble.ecc = to_hex(rx->getEnsembleEcc(), 2);
+        const auto ensemble = rx->getEnsembleSnapshot();
+        mux_json.ensemble = build_ensemble_json(*ensemble);
 
-        for (const auto& s : rx->getServiceList()) {
-            ServiceJson service;
-            service.sid = to_hex(s.serviceId, 4);
-            service.programType = s.programType;
-            service.ptystring = DABConstants::getProgramTypeName(s.programType);
-            service.language = s.language;
-            service.languagestring = DABConstants::getLanguageName(s.language);
-            service.label = s.serviceLabel;
-            service.url_mp3 = "";
-
-            for (const auto& sc : rx->getComponents(s)) {
-                ComponentJson component;
-                component.componentnr = sc.componentNr;
-                component.primary = (sc.PS_flag ? true : false);
-                component.caflag = (sc.CAflag ? true : false);
-                component.label = sc.componentLabel;
-
-                const auto sub = rx->getSubchannel(sc);
-
-                switch (sc.transportMode()) {
-                    case TransportMode::Audio:
-                        component.transportmode = "audio";
-                        component.ascty = make_unique<string>(
-                                string{
-                                    (sc.audioType() == AudioServiceComponentType::DAB ? "DAB" :
-                                     sc.audioType() == AudioServiceComponentType::DABPlus ? "DAB+" :
-                                     "unknown")});
-                        if (sc.audioType() == AudioServiceComponentType::DAB or
-                            sc.audioType() == AudioServiceComponentType::DABPlus) {
-                            string urlmp3 = "/mp3/" + to_hex(s.serviceId, 4);
-                            service.url_mp3 = urlmp3;
-                        }
-                        break;
-                    case TransportMode::FIDC:
-                        component.transportmode = "fidc";
-                        component.dscty = make_unique<uint16_t>(sc.DSCTy);
-                        break;
-                    case TransportMode::PacketData:
-                        component.transportmode = "packetdata";
-                        component.scid = make_unique<uint16_t>(sc.SCId);
-                        break;
-                    case TransportMode::StreamData:
-                        component.transportmode = "streamdata";
-                        component.dscty = make_unique<uint16_t>(sc.DSCTy);
-                        break;
-                }
-
-                component.subchannel = sub;
-
-                service.components.push_back(move(component));
-            }
+        for (const auto& s : ensemble->services) {
+            ServiceJson service = build_service_json(*ensemble, s);
 
             try {
                 const auto& wph = phs.at(s.serviceId);
@@ -794,7 +772,21 @@ bool WebRadioInterface::send_mux_json(Socket& s)
 
         mux_json.demodulator_snr = last_snr;
         mux_json.demodulator_frequencycorrection = last_fine_correction + last_coarse_correction;
-        mux_json.demodulator_timelastfct0frame = rx->getReceiverStats().timeLastFCT0Frame;
+        const auto rx_stats = rx->getReceiverStats();
+        mux_json.demodulator_timelastfct0frame = rx_stats.timeLastFCT0Frame;
+        mux_json.demodulator_framequeue_depth = rx_stats.frameQueue.depth;
+        mux_json.demodulator_framequeue_highwatermark = rx_stats.frameQueue.highWaterMark;
+        mux_json.demodulator_framequeue_decoded = rx_stats.frameQueue.framesDecoded;
+        mux_json.demodulator_framequeue_dropped = rx_stats.frameQueue.framesDropped;
+        mux_json.demodulator_eventqueue_depth = rx_stats.eventQueue.depth;
+        mux_json.demodulator_eventqueue_highwatermark = rx_stats.eventQueue.highWaterMark;
+        mux_json.demodulator_eventqueue_delivered = rx_stats.eventQueue.eventsDelivered;
+        mux_json.demodulator_eventqueue_dropped = rx_stats.eventQueue.eventsDropped;
+        mux_json.demodulator_figcache_hits = rx_stats.figCache.hits;
+        mux_json.demodulator_figcache_misses = rx_stats.figCache.misses;
+        mux_json.demodulator_ensemblecache_preloaded = rx_stats.ensembleCache.preloaded;
+        mux_json.demodulator_ensemblecache_contradictions = rx_stats.ensembleCache.contradictions;
+        mux_json.demodulator_ensemblecache_timetoplayms = rx_stats.ensembleCache.timeToPlay;
 
         mux_json.tii = getTiiStats();
     }
@@ -870,110 +862,109 @@ bool WebRadioInterface::send_stream(Socket& s, const string& stream)
     unique_lock<mutex> lock(rx_mut);
     ASSERT_RX;
 
-    for (const auto& srv : rx->getServiceList()) {
-        if (rx->serviceHasAudioComponent(srv) and
-                (to_hex(srv.serviceId, 4) == stream or
-                (uint32_t)stoul(stream) == srv.serviceId)) {
-            try {
-                auto& ph = phs.at(srv.serviceId);
+    const auto ensemble = rx->getEnsembleSnapshot();
+    const Service *srv = ensemble->findService(parse_sid(stream));
+    if (srv == nullptr or not rx->serviceHasAudioComponent(*srv)) {
+        return false;
+    }
+    const uint32_t sid = srv->serviceId;
 
-                lock.unlock();
+    try {
+        auto& ph = phs.at(sid);
 
-                string http_contenttype;
+        lock.unlock();
 
-                switch (decode_settings.outputCodec)
-                {
-                case OutputCodec::FLAC:
-                    http_contenttype = http_contenttype_flac;
-                    break;
-                case OutputCodec::MP3:
-                    http_contenttype = http_contenttype_mp3;
-                    break;
-                default:
-                    break;
-                }
+        string http_contenttype;
 
-                if (not send_http_response(s, http_ok, "", http_contenttype)) {
-                    cerr << "Failed to send mp3 headers" << endl;
-                    return false;
-                }
+        switch (decode_settings.outputCodec)
+        {
+        case OutputCodec::FLAC:
+            http_contenttype = http_contenttype_flac;
+            break;
+        case OutputCodec::MP3:
+            http_contenttype = http_contenttype_mp3;
+            break;
+        default:
+            break;
+        }
 
-                ProgrammeSender sender(move(s));
+        if (not send_http_response(s, http_ok, "", http_contenttype)) {
+            cerr << "Failed to send mp3 headers" << endl;
+            return false;
+        }
 
-                cerr << "Registering mp3 sender" << endl;
-                ph.registerSender(&sender);
-                check_decoders_required();
-                sender.wait_for_termination();
+        ProgrammeSender sender(move(s));
 
-                cerr << "Removing mp3 sender" << endl;
-                ph.removeSender(&sender);
-                check_decoders_required();
+        cerr << "Registering mp3 sender" << endl;
+        ph.registerSender(&sender);
+        check_decoders_required();
+        sender.wait_for_termination();
 
-                return true;
-            }
-            catch (const out_of_range& e) {
-                cerr << "Could not setup mp3 sender for " <<
-                    srv.serviceId << ": " << e.what() << endl;
+        cerr << "Removing mp3 sender" << endl;
+        ph.removeSender(&sender);
+        check_decoders_required();
 
-                send_http_response(s, http_503, e.what());
-                return false;
-            }
-        }
+        return true;
+    }
+    catch (const out_of_range& e) {
+        cerr << "Could not setup mp3 sender for " <<
+            sid << ": " << e.what() << endl;
+
+        send_http_response(s, http_503, e.what());
+        return false;
     }
-    return false;
 }
 
 bool WebRadioInterface::send_slide(Socket& s, const string& stream)
 {
-    for (const auto& wph : phs) {
-        if (to_hex(wph.first, 4) == stream or
-                (uint32_t)stoul(stream) == wph.first) {
-            const auto mot = wph.second.getMOT();
-
-            if (mot.data.empty()) {
-                send_http_response(s, http_404, "404 Not Found\r\nSlide not available.\r\n");
-                return true;
-            }
+    const auto wph = phs.find(parse_sid(stream));
+    if (wph == phs.end()) {
+        return false;
+    }
 
-            stringstream headers;
-            headers << http_ok;
+    const auto mot = wph->second.getMOT();
 
-            headers << "Content-Type: ";
-            switch (mot.subtype) {
-                case MOTType::Unknown:
-                    headers << "application/octet-stream";
-                    break;
-                case MOTType::JPEG:
-                    headers << "image/jpeg";
-                    break;
-                case MOTType::PNG:
-                    headers << "image/png";
-                    break;
-            }
-            headers << "\r\n";
+    if (mot.data.empty()) {
+        send_http_response(s, http_404, "404 Not Found\r\nSlide not available.\r\n");
+        return true;
+    }
+
+    stringstream headers;
+    headers << http_ok;
 
-            headers << http_nocache;
+    headers << "Content-Type: ";
+    switch (mot.subtype) {
+        case MOTType::Unknown:
+            headers << "application/octet-stream";
+            break;
+        case MOTType::JPEG:
+            headers << "image/jpeg";
+            break;
+        case MOTType::PNG:
+            headers << "image/png";
+            break;
+    }
+    headers << "\r\n";
 
-            headers << "Last-Modified: ";
-            time_t t = chrono::system_clock::to_time_t(mot.time);
-            headers << put_time(gmtime(&t), "%a, %d %b %Y %T GMT");
-            headers << "\r\n";
+    headers << http_nocache;
 
-            headers << "\r\n";
-            const auto headers_str = headers.str();
-            int ret = s.send(headers_str.data(), headers_str.size(), MSG_NOSIGNAL);
-            if (ret == (ssize_t)headers_str.size()) {
-                ret = s.send(mot.data.data(), mot.data.size(), MSG_NOSIGNAL);
-            }
+    headers << "Last-Modified: ";
+    time_t t = chrono::system_clock::to_time_t(mot.time);
+    headers << put_time(gmtime(&t), "%a, %d %b %Y %T GMT");
+    headers << "\r\n";
 
-            if (ret == -1) {
-                cerr << "Failed to send slide" << endl;
-            }
+    headers << "\r\n";
+    const auto headers_str = headers.str();
+    int ret = s.send(headers_str.data(), headers_str.size(), MSG_NOSIGNAL);
+    if (ret == (ssize_t)headers_str.size()) {
+        ret = s.send(mot.data.data(), mot.data.size(), MSG_NOSIGNAL);
+    }
 
-            return true;
-        }
+    if (ret == -1) {
+        cerr << "Failed to send slide" << endl;
     }
-    return false;
+
+    return true;
 }
 
 bool WebRadioInterface::send_fic(Socket& s)
@@ -1264,11 +1255,55 @@ bool WebRadioInterface::handle_channel_post(Socket& s, const string& channel)
     return true;
 }
 
+void WebRadioInterface::subscribe_diagnostic(uint32_t stream)
+{
+    lock_guard<mutex> lock(diagnostics_mut);
+    diagnostics_requested[stream] = chrono::steady_clock::now();
+
+    if ((diagnostics & stream) == 0) {
+        diagnostics |= stream;
+
+        lock_guard<mutex> rx_lock(rx_mut);
+        // rx is missing while retuning, the new one asks for the streams
+        if (rx) {
+            rx->setDiagnosticSubscriptions(diagnostics);
+        }
+    }
+}
+
+void WebRadioInterface::expire_diagnostics()
+{
+    lock_guard<mutex> lock(diagnostics_mut);
+    const auto now = chrono::steady_clock::now();
+
+    uint32_t streams = diagnostics;
+    for (auto it = diagnostics_requested.begin(); it != diagnostics_requested.end();) {
+        if (now - it->second > chrono::seconds(10)) {
+            streams &= ~it->first;
+            it = diagnostics_requested.erase(it);
+        }
+        else {
+            ++it;
+        }
+    }
+
+    if (streams != diagnostics) {
+        diagnostics = streams;
+
+        lock_guard<mutex> rx_lock(rx_mut);
+        if (rx) {
+            rx->setDiagnosticSubscriptions(streams);
+        }
+    }
+}
+
 void WebRadioInterface::handle_phs()
 {
     while (running) {
         this_thread::sleep_for(chrono::seconds(2));
 
+        expire_diagnostics();
+
         unique_lock<mutex> lock(rx_mut);
         ASSERT_RX;
 
@@ -1471,6 +1506,7 @@ void WebRadioInterface::serve()
     cerr << "SERVE clear remaining data structures" << endl;
     phs.clear();
     programmes_being_decoded.clear();
+    programmes_retuning.clear();
     carousel_services_available.clear();
     carousel_services_active.clear();
 }
@@ -1536,6 +1572,11 @@ void WebRadioInterface::onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib)
     new_fib_block_available.notify_one();
 }
 
+uint32_t WebRadioInterface::getDiagnosticSubscriptions() const
+{
+    return diagnostics;
+}
+
 void WebRadioInterface::onNewImpulseResponse(vector<float>&& data)
 {
     lock_guard<mutex> lock(plotdata_mut);
@@ -1588,44 +1629,14 @@ void WebRadioInterface::onInputFailure()
     exit(1);
 }
 
-list<tii_measurement_t> WebRadioInterface::getTiiStats()
+void WebRadioInterface::onRestartService()
 {
-    list<tii_measurement_t> l;
-
-    for (const auto& cp_list : tiis) {
-        const auto comb = cp_list.first.first;
-        const auto pattern = cp_list.first.second;
-
-        if (cp_list.second.size() < 5) {
-            continue;
-        }
-
-        tii_measurement_t avg;
-        avg.comb = comb;
-        avg.pattern = pattern;
-        vector<int> delays;
-        double error = 0.0;
-        size_t len = 0;
-        for (const auto& meas : cp_list.second) {
-            delays.push_back(meas.delay_samples);
-            error += meas.error;
-            len++;
-        }
-
-        if (len > 0) {
-            avg.error = error / len;
+    retune_programmes = true;
+}
 
-            // Calculate the median
-            nth_element(delays.begin(), delays.begin() + len/2, delays.end());
-            avg.delay_samples = delays[len/2];
-        }
-        else {
-            // To quiet static analysis check
-            avg.error = 0.0;
-            avg.delay_samples = 0;
-        }
-        l.push_back(move(avg));
-    }
+list<tii_measurement_t> WebRadioInterface::getTiiStats()
+{
+    auto l = summarise_tii(tiis);
 
     using namespace chrono;
     const auto now = steady_clock::now();
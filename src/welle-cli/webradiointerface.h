@@ -34,6 +34,7 @@
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
 #include <vector>
 #include <string>
 #include <cstdint>
@@ -92,17 +93,22 @@ class WebRadioInterface : public RadioControllerInterface {
         virtual void onSetEnsembleLabel(DabLabel& label) override;
         virtual void onDateTimeUpdate(const dab_date_time_t& dateTime) override;
         virtual void onFIBDecodeSuccess(bool crcCheckOk, const uint8_t* fib) override;
+        virtual uint32_t getDiagnosticSubscriptions(void) const override;
         virtual void onNewImpulseResponse(std::vector<float>&& data) override;
         virtual void onNewNullSymbol(std::vector<DSPCOMPLEX>&& data) override;
         virtual void onConstellationPoints(std::vector<DSPCOMPLEX>&& data) override;
         virtual void onMessage(message_level_t level, const std::string& text, const std::string& text2 = std::string()) override;
         virtual void onTIIMeasurement(tii_measurement_t&& m) override;
         virtual void onInputFailure() override;
+        virtual void onRestartService() override;
 
     private:
         std::mutex retune_mut;
         void retune(const std::string& channel);
 
+        // Load the ensemble cached for the channel the input is tuned to
+        void use_ensemble_cache();
+
         bool dispatch_client(Socket&& client);
         // Send a file
         bool send_file(Socket& s,
@@ -153,6 +159,11 @@ class WebRadioInterface : public RadioControllerInterface {
 
         void handle_phs();
         void check_decoders_required();
+
+        // A client asked for data of the diagnostic stream
+        void subscribe_diagnostic(uint32_t stream);
+        // Unsubscribe the streams no client asked for recently
+        void expire_diagnostics();
         std::list<tii_measurement_t> getTiiStats();
 
         std::thread programme_handler_thread;
@@ -181,6 +192,12 @@ class WebRadioInterface : public RadioControllerInterface {
 
         std::deque<pending_message_t> pending_messages;
 
+        // The diagnostic streams are only subscribed while clients ask
+        // for them. Lock before rx_mut.
+        std::mutex diagnostics_mut;
+        std::atomic<uint32_t> diagnostics = ATOMIC_VAR_INIT(DIAGNOSTIC_NONE);
+        std::map<uint32_t, std::chrono::time_point<std::chrono::steady_clock> > diagnostics_requested;
+
         mutable std::mutex plotdata_mut;
         std::vector<float> last_CIR;
         std::vector<DSPCOMPLEX> last_NULL;
@@ -205,6 +222,10 @@ class WebRadioInterface : public RadioControllerInterface {
         using SId_t = uint32_t;
         std::map<SId_t, WebProgrammeHandler> phs;
         std::map<SId_t, bool> programmes_being_decoded;
+        // The FIC corrected the subchannels the programmes are decoded from
+        std::atomic<bool> retune_programmes = ATOMIC_VAR_INIT(false);
+        // Stopped for the correction, and not tuned again yet
+        std::set<SId_t> programmes_retuning;
         std::condition_variable phs_changed;
 
         std::list<SId_t> carousel_services_available;
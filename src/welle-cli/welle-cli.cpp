@@ -31,15 +31,20 @@
  */
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
 #include <condition_variable>
 #include <deque>
 #include <iostream>
+#include <map>
 #include <memory>
 #include <mutex>
 #include <thread>
 #include <set>
 #include <utility>
 #include <cstdio>
+#include <ctime>
+#include <getopt.h>
 #include <unistd.h>
 #ifdef HAVE_SOAPYSDR
 #  include "soapy_sdr.h"
@@ -50,7 +55,9 @@
 #endif
 #include "welle-cli/webradiointerface.h"
 #include "welle-cli/tests.h"
+#include "welle-cli/batchdecoder.h"
 #include "backend/radio-receiver.h"
+#include "backend/channel-scan.h"
 #include "input/input_factory.h"
 #include "input/raw_file.h"
 #include "various/channels.h"
@@ -172,13 +179,63 @@ class WavProgrammeHandler: public ProgrammeHandlerInterface {
         int rate = 0;
 };
 
+/* Counts what was decoded, for the report of the offline mode */
+class OfflineProgrammeHandler: public ProgrammeHandlerInterface {
+    public:
+        OfflineProgrammeHandler(uint32_t SId) : SId(SId) {}
+
+        virtual void onFrameErrors(int frameErrors) override
+        {
+            audioFrames++;
+            if (frameErrors) {
+                audioFramesWithErrors++;
+            }
+        }
+
+        virtual void onNewAudio(std::vector<int16_t>&& audioData, int sampleRate, const string& mode) override
+        {
+            (void)mode;
+            // Always stereo
+            audioSeconds = audioSeconds + (double)audioData.size() / 2 / sampleRate;
+        }
+
+        virtual void onRsErrors(bool uncorrectedErrors, int numCorrectedErrors) override
+        {
+            (void)numCorrectedErrors;
+            superframes++;
+            if (uncorrectedErrors) {
+                superframesUncorrectable++;
+            }
+        }
+
+        virtual void onAacErrors(int aacErrors) override { this->aacErrors += aacErrors; }
+        virtual void onNewDynamicLabel(const std::string& label) override
+        {
+            cout << "[0x" << std::hex << SId << std::dec << "] " <<
+                "DLS: " << label << endl;
+        }
+
+        virtual void onMOT(const mot_file_t& mot_file) override { (void)mot_file; }
+        virtual void onPADLengthError(size_t announced_xpad_len, size_t xpad_len) override
+        {
+            (void)announced_xpad_len; (void)xpad_len;
+        }
+
+        const uint32_t SId;
+        std::atomic<uint64_t> audioFrames = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> audioFramesWithErrors = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> superframes = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> superframesUncorrectable = ATOMIC_VAR_INIT(0);
+        std::atomic<uint64_t> aacErrors = ATOMIC_VAR_INIT(0);
+        std::atomic<double> audioSeconds = ATOMIC_VAR_INIT(0);
+};
 
 class RadioInterface : public RadioControllerInterface {
     public:
         virtual void onSNR(float /*snr*/) override { }
         virtual void onFrequencyCorrectorChange(int /*fine*/, int /*coarse*/) override { }
         virtual void onSyncChange(char isSync) override { synced = isSync; }
-        virtual void onSignalPresence(bool /*isSignal*/) override { }
+        virtual void onSignalPresence(bool isSignal) override { signalPresence = isSignal ? 1 : 0; }
         virtual void onServiceDetected(uint32_t sId) override
         {
             cout << "New Service: 0x" << hex << sId << dec << endl;
@@ -233,6 +290,8 @@ class RadioInterface : public RadioControllerInterface {
                 fwrite(buf.data(), buf.size(), sizeof(buf[0]), fic_fd);
             }
         }
+        // Nothing is plotted
+        virtual uint32_t getDiagnosticSubscriptions(void) const override { return DIAGNOSTIC_NONE; }
         virtual void onNewImpulseResponse(std::vector<float>&& data) override { (void)data; }
         virtual void onNewNullSymbol(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
         virtual void onConstellationPoints(std::vector<DSPCOMPLEX>&& data) override { (void)data; }
@@ -269,6 +328,8 @@ class RadioInterface : public RadioControllerInterface {
 
         json last_date_time;
         bool synced = false;
+        // During a scan, -1 until the receiver decided
+        std::atomic<int> signalPresence = ATOMIC_VAR_INIT(-1);
         FILE* fic_fd = nullptr;
 };
 
@@ -278,6 +339,7 @@ struct options_t {
     int gain = -1;
     string channel = "10B";
     string iqsource = "";
+    int64_t iqsource_offset = 0;
     string programme = "GRRIF";
     string frontend = "auto";
     string frontend_args = "";
@@ -288,6 +350,11 @@ struct options_t {
     int web_port = -1; // positive value means enable
     list<int> tests;
     string outputcodec = "";
+    bool offline = false;
+    bool scan = false;
+    // Files and directories to decode with --batch
+    vector<string> batch_paths;
+    size_t batch_jobs = 0;
 
     RadioReceiverOptions rro;
 };
@@ -297,6 +364,7 @@ static void usage()
     cerr <<
     "Usage: welle-cli [OPTION]" << endl <<
     "   or: welle-cli -w <port> [OPTION]" << endl <<
+    "   or: welle-cli --batch [OPTION] <file or directory>..." << endl <<
     endl <<
     "welle-cli is welle.io's command line interface." << endl <<
     endl <<
@@ -305,6 +373,9 @@ static void usage()
     "Tuning:" << endl <<
     "    -c channel    Tune to <channel> (eg. 10B, 5A, LD...)." << endl <<
     "    -p programme  Play <programme> with ALSA (text name of the radio: eg. GRIFF)." << endl <<
+    "    --scan        Scan all channels, print the ensembles found and how long" << endl <<
+    "                  the scan took. Channels without DAB signal are left after" << endl <<
+    "                  a few frames, the others once their ensemble is complete." << endl <<
     endl <<
     "Dumping:" << endl <<
     "    -D            Dump FIC and all programmes to files (cannot be used with -C)." << endl <<
@@ -327,6 +398,31 @@ static void usage()
     "Backend and input options:" << endl <<
     "    -f file       Read an IQ file <file> and play with ALSA." << endl <<
     "                  IQ file format is u8, unless the file ends with 'FORMAT.iq'." << endl <<
+    "    --offline     Decode the IQ file given with -f as fast as possible, without" << endl <<
+    "                  dropping samples, and report the decoding speed. Decodes the" << endl <<
+    "                  programme given with -p, or all programmes with -D." << endl <<
+    "    --single-threaded" << endl <<
+    "                  With --offline, run the whole decoding chain on one thread," << endl <<
+    "                  so that the same file always gives the same results." << endl <<
+    "    --batch path..." << endl <<
+    "                  Decode all IQ files given on the command line, or contained" << endl <<
+    "                  in the given directories, in parallel and as fast as possible." << endl <<
+    "                  Prints one line of JSON per file with the ensemble, FIC CRC" << endl <<
+    "                  errors, error counters of all audio services and TII." << endl <<
+    "    --jobs n      Decode <n> files at the same time with --batch. Defaults to" << endl <<
+    "                  the number of CPU cores." << endl <<
+    "    -S sample     Start reading the IQ file at sample <sample>." << endl <<
+    "    --fft-threads n" << endl <<
+    "                  Split the FFT of the symbols of every frame across <n>" << endl <<
+    "                  threads. Defaults to 1." << endl <<
+    "    --async-events" << endl <<
+    "                  Hand the events of the receiver to the web server and the" << endl <<
+    "                  console through a queue, so that they never hold up the" << endl <<
+    "                  demodulation. Has no effect with --single-threaded." << endl <<
+    "    --ensemble-cache dir" << endl <<
+    "                  Keep the ensemble of every channel, or IQ file, in the" << endl <<
+    "                  existing directory <dir>, and load it when tuning, so that" << endl <<
+    "                  programmes play before the FIC described the ensemble." << endl <<
     "    -u            Disable coarse corrector, for receivers who have a low " << endl <<
     "                  frequency offset." << endl <<
     "    -g gain       Set input gain to <gain> or -1 for auto gain." << endl <<
@@ -356,9 +452,20 @@ static void usage()
     "welle-cli -f ./ofdm.iq -p GRRIF" << endl <<
     "    Read IQ file './ofdm.iq' (in u8 format) and play programme 'GRIFF' with ALSA." << endl <<
     endl <<
+    "welle-cli -f ./ofdm.iq --offline -D" << endl <<
+    "    Decode all programmes of IQ file './ofdm.iq' as fast as possible, and" << endl <<
+    "    report the real-time factor." << endl <<
+    endl <<
+    "welle-cli --batch ./captures/" << endl <<
+    "    Decode all IQ files in directory './captures/' in parallel, and print" << endl <<
+    "    their ensembles as JSON." << endl <<
+    endl <<
     "welle-cli -f ./ofdm.iq -t 1" << endl <<
     "    Read IQ file './ofdm.iq' (in u8 format), and run test 1." << endl <<
     endl <<
+    "welle-cli --scan -F rtl_sdr" << endl <<
+    "    Scan all channels with an RTL-SDR dongle, and print the ensembles found." << endl <<
+    endl <<
     "welle-cli -c 10B -p GRRIF -F rtl_tcp,localhost:1234" << endl <<
     "    Receive 'GRRIF' on channel '10B' using 'rtl_tcp' driver on localhost:1234," << endl <<
     "    and play with ALSA." << endl <<
@@ -408,9 +515,50 @@ options_t parse_cmdline(int argc, char **argv)
     string fe_opt = "";
     options.rro.decodeTII = true;
 
+    bool batch = false;
+
+    enum { OPT_OFFLINE = 256, OPT_SINGLE_THREADED, OPT_BATCH, OPT_JOBS, OPT_FFT_THREADS,
+        OPT_ASYNC_EVENTS, OPT_ENSEMBLE_CACHE, OPT_SCAN };
+    static const struct option long_options[] = {
+        {"offline", no_argument, nullptr, OPT_OFFLINE},
+        {"single-threaded", no_argument, nullptr, OPT_SINGLE_THREADED},
+        {"batch", no_argument, nullptr, OPT_BATCH},
+        {"jobs", required_argument, nullptr, OPT_JOBS},
+        {"fft-threads", required_argument, nullptr, OPT_FFT_THREADS},
+        {"async-events", no_argument, nullptr, OPT_ASYNC_EVENTS},
+        {"ensemble-cache", required_argument, nullptr, OPT_ENSEMBLE_CACHE},
+        {"scan", no_argument, nullptr, OPT_SCAN},
+        {nullptr, 0, nullptr, 0}
+    };
+
     int opt;
-    while ((opt = getopt(argc, argv, "A:c:C:dDf:F:g:hp:O:Ps:Tt:uvw:")) != -1) {
+    while ((opt = getopt_long(argc, argv, "A:c:C:dDf:F:g:hp:O:Ps:S:Tt:uvw:",
+                    long_options, nullptr)) != -1) {
         switch (opt) {
+            case OPT_OFFLINE:
+                options.offline = true;
+                break;
+            case OPT_SINGLE_THREADED:
+                options.rro.singleThreaded = true;
+                break;
+            case OPT_BATCH:
+                batch = true;
+                break;
+            case OPT_JOBS:
+                options.batch_jobs = std::max(std::atoi(optarg), 1);
+                break;
+            case OPT_FFT_THREADS:
+                options.rro.fftThreads = std::max(std::atoi(optarg), 1);
+                break;
+            case OPT_ASYNC_EVENTS:
+                options.rro.asyncEvents = true;
+                break;
+            case OPT_ENSEMBLE_CACHE:
+                options.rro.ensembleCacheDirectory = optarg;
+                break;
+            case OPT_SCAN:
+                options.scan = true;
+                break;
             case 'A':
                 options.antenna = optarg;
                 break;
@@ -450,6 +598,9 @@ options_t parse_cmdline(int argc, char **argv)
             case 's':
                 options.soapySDRDriverArgs = optarg;
                 break;
+            case 'S':
+                options.iqsource_offset = std::atoll(optarg);
+                break;
             case 't':
                 options.tests.push_back(std::atoi(optarg));
                 break;
@@ -486,15 +637,278 @@ options_t parse_cmdline(int argc, char **argv)
         cerr << "Cannot select both -C and -D" << endl;
         exit(1);
     }
+    if (batch) {
+        for (int i = optind; i < argc; i++) {
+            options.batch_paths.push_back(argv[i]);
+        }
+        if (options.batch_paths.empty()) {
+            cerr << "--batch needs at least one IQ file or directory" << endl;
+            exit(1);
+        }
+        if (options.offline or options.web_port != -1 or not options.tests.empty()) {
+            cerr << "Cannot combine --batch with --offline, -w or -t" << endl;
+            exit(1);
+        }
+    }
+
+    if (options.scan) {
+        if (not options.iqsource.empty()) {
+            cerr << "--scan needs a tuner, it cannot read an IQ file" << endl;
+            exit(1);
+        }
+        if (batch or options.web_port != -1 or not options.tests.empty()) {
+            cerr << "Cannot combine --scan with --batch, -w or -t" << endl;
+            exit(1);
+        }
+    }
+
+    if (options.offline) {
+        if (options.iqsource.empty()) {
+            cerr << "--offline needs an IQ file given with -f" << endl;
+            exit(1);
+        }
+        if (options.web_port != -1 or not options.tests.empty()) {
+            cerr << "Cannot combine --offline with -w or -t" << endl;
+            exit(1);
+        }
+        // The file can wait for the decoder, never drop a frame
+        options.rro.frameQueueBackpressure = true;
+    }
+    else if (options.rro.singleThreaded and not batch) {
+        cerr << "--single-threaded is only supported with --offline" << endl;
+        exit(1);
+    }
 
     return options;
 }
 
+/* Decode the whole IQ file as fast as possible, and report how long
+ * it took compared to the duration of the signal. */
+static int decodeOffline(RadioInterface& ri, CRAWFile& in, const options_t& options)
+{
+    // The receiver refers to the handlers, they must outlive it
+    map<uint32_t, unique_ptr<OfflineProgrammeHandler> > handlers;
+    RadioReceiver rx(ri, in, options.rro);
+
+    const int64_t startPosition = in.getPosition();
+    const auto wallStart = chrono::steady_clock::now();
+    const clock_t cpuStart = clock();
+
+    rx.restart(false);
+    if (not options.rro.ensembleCacheDirectory.empty()) {
+        cerr << (rx.useEnsembleCache(options.iqsource) ?
+                "Preloaded the cached ensemble" : "No cached ensemble") << endl;
+    }
+
+    // The services are tuned as soon as the FIC describes them, which
+    // is checked every few milliseconds, or after every frame when
+    // single-threaded. The decoders miss what comes before.
+    uint64_t ensembleVersion = 0;
+    auto tuneServices = [&]() {
+        const auto ensemble = rx.getEnsembleSnapshot();
+        if (ensemble->version == ensembleVersion) {
+            return;
+        }
+        ensembleVersion = ensemble->version;
+
+        for (const auto& s : ensemble->services) {
+            if (handlers.count(s.serviceId) or not rx.serviceHasAudioComponent(s)) {
+                continue;
+            }
+
+            const string label = s.serviceLabel.utf8_label();
+            if (not options.decode_all_programmes and
+                    (label.empty() or label.find(options.programme) == string::npos)) {
+                continue;
+            }
+
+            auto handler = make_unique<OfflineProgrammeHandler>(s.serviceId);
+            if (rx.addServiceToDecode(*handler, "", s)) {
+                cerr << "Decoding [0x" << hex << s.serviceId << dec << "] " <<
+                    label << endl;
+                handlers.emplace(s.serviceId, move(handler));
+            }
+        }
+    };
+
+    // Seconds of signal read when each programme gave its first audio,
+    // to the frame when single-threaded, otherwise a few frames late
+    map<uint32_t, double> firstAudio;
+    auto checkFirstAudio = [&]() {
+        for (const auto& h : handlers) {
+            if (h.second->audioSeconds > 0 and firstAudio.count(h.first) == 0) {
+                firstAudio[h.first] =
+                    (double)(in.getPosition() - startPosition) / INPUT_RATE;
+            }
+        }
+    };
+
+    int64_t endPosition = 0;
+    if (options.rro.singleThreaded) {
+        // Everything read before the callback is decoded when it runs
+        rx.runSingleThreaded([&]() {
+                tuneServices();
+                checkFirstAudio();
+                return not in.endWasReached(); });
+        endPosition = in.getPosition();
+    }
+    else {
+        while (not in.endWasReached()) {
+            tuneServices();
+            checkFirstAudio();
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+        endPosition = in.getPosition();
+
+        // Let the decoder finish the frames that are still queued
+        for (uint64_t decoded = 0;;) {
+            this_thread::sleep_for(chrono::milliseconds(20));
+            const auto q = rx.getReceiverStats().frameQueue;
+            if (q.framesDecoded + q.framesDropped == q.framesPushed and
+                    q.framesDecoded == decoded) {
+                break;
+            }
+            decoded = q.framesDecoded;
+        }
+
+        // And the programme decoders the subchannels of those frames
+        rx.drainDecoders();
+    }
+
+    const chrono::duration<double> wallTime = chrono::steady_clock::now() - wallStart;
+    const double cpuTime = (double)(clock() - cpuStart) / CLOCKS_PER_SEC;
+    const auto stats = rx.getReceiverStats();
+    // Stopping clears the ensemble, the snapshot keeps the labels
+    const auto ensemble = rx.getEnsembleSnapshot();
+    rx.stop();
+
+    const double signalTime = (double)(endPosition - startPosition) / INPUT_RATE;
+
+    cout << "Offline decoding of " << options.iqsource << endl <<
+        "  Signal:           " << signalTime << " s" << endl <<
+        "  Wall time:        " << wallTime.count() << " s" << endl <<
+        "  CPU time:         " << cpuTime << " s" << endl <<
+        "  Real-time factor: " << signalTime / wallTime.count() << endl <<
+        "  OFDM frames:      " << stats.frameQueue.framesDecoded << " decoded, " <<
+        stats.frameQueue.framesDropped << " dropped" << endl;
+    if (not options.rro.ensembleCacheDirectory.empty()) {
+        cout << "  Ensemble cache:   " <<
+            (stats.ensembleCache.preloaded ? "preloaded, " : "missed, ") <<
+            stats.ensembleCache.contradictions << " contradictions" << endl;
+    }
+
+    for (const auto& h : handlers) {
+        const auto& ph = *h.second;
+        const Service *s = ensemble->findService(h.first);
+        cout << "  [0x" << hex << h.first << dec << "] " <<
+            (s ? s->serviceLabel.utf8_label() : "") << ": " <<
+            ph.audioFrames << " audio frames (" <<
+            ph.audioFramesWithErrors << " with errors), " <<
+            ph.superframes << " superframes (" <<
+            ph.superframesUncorrectable << " uncorrectable), " <<
+            ph.aacErrors << " AAC errors, " <<
+            ph.audioSeconds << " s of audio";
+        if (firstAudio.count(h.first)) {
+            cout << ", first after " << firstAudio.at(h.first) << " s";
+        }
+        cout << endl;
+    }
+
+    if (handlers.empty()) {
+        cerr << "No programme was decoded" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+/* Scan all channels, and report the ensembles found and how long it
+ * took. A channel without DAB signal is left as soon as the receiver
+ * says so, a few frames after the tune, see SignalDetector. The FIC of
+ * the others is decoded until their ensemble is complete, see ScanDwell. */
+static int scanBand(RadioInterface& ri, CVirtualInput& in, const options_t& options)
+{
+    // In case the receiver never decides, e.g. the input stalls
+    const auto maxWaitForSignal = chrono::seconds(5);
+
+    Channels channels;
+    RadioReceiver rx(ri, in, options.rro);
+    ScanDwell dwell;
+
+    const auto scanStart = chrono::steady_clock::now();
+    int numChannels = 0;
+    int numEnsembles = 0;
+
+    for (string channel = Channels::firstChannel; not channel.empty();
+            channel = channels.getNextChannel()) {
+        const auto channelStart = chrono::steady_clock::now();
+        numChannels++;
+
+        in.setFrequency(channels.getFrequency(channel));
+        in.reset();
+        ri.signalPresence = -1;
+        rx.restart(true);
+        // Keep what the scan finds for when the channel is tuned
+        rx.useEnsembleCache(channel, false);
+
+        while (ri.signalPresence == -1 and
+                chrono::steady_clock::now() - channelStart < maxWaitForSignal) {
+            this_thread::sleep_for(chrono::milliseconds(5));
+        }
+
+        if (ri.signalPresence == 1) {
+            dwell.start();
+            while (not dwell.isDone(*rx.getEnsembleSnapshot())) {
+                this_thread::sleep_for(chrono::milliseconds(100));
+            }
+        }
+
+        const auto channelTime = chrono::duration_cast<chrono::milliseconds>(
+                chrono::steady_clock::now() - channelStart);
+        const auto ensemble = rx.getEnsembleSnapshot();
+
+        cout << "Scan " << channel << ": ";
+        if (ri.signalPresence != 1) {
+            cout << "no DAB signal";
+        }
+        else if (ensemble->services.empty()) {
+            cout << "DAB signal, no ensemble decoded";
+        }
+        else {
+            numEnsembles++;
+            cout << "[0x" << hex << ensemble->ensembleId << dec << "] " <<
+                ensemble->ensembleLabel.utf8_label() << ", " <<
+                ensemble->services.size() << " services" <<
+                (dwell.isComplete() ? "" : " (incomplete)");
+        }
+        cout << ", " << channelTime.count() << " ms" << endl;
+    }
+    rx.stop();
+
+    const chrono::duration<double> scanTime = chrono::steady_clock::now() - scanStart;
+    cout << "Scanned " << numChannels << " channels in " << scanTime.count() <<
+        " s, found " << numEnsembles << " ensembles" << endl;
+    return 0;
+}
+
 int main(int argc, char **argv)
 {
     auto options = parse_cmdline(argc, argv);
     version();
 
+    if (not options.batch_paths.empty()) {
+        size_t jobs = options.batch_jobs;
+        if (jobs == 0) {
+            jobs = max(thread::hardware_concurrency(), 1u);
+        }
+
+        const auto files = BatchDecoder::listIQFiles(options.batch_paths);
+        cerr << "Decoding " << files.size() << " files with " <<
+            jobs << " workers" << endl;
+
+        BatchDecoder bd(options.rro, jobs);
+        return bd.run(files) == 0 ? 0 : 1;
+    }
+
     RadioInterface ri;
 
     Channels channels;
@@ -510,9 +924,10 @@ int main(int argc, char **argv)
         }
     }
     else {
-        // Run the tests without input throttling for max speed
-        const bool throttle = options.tests.empty();
-        const bool rewind = options.tests.empty();
+        // Run the tests and the offline mode without input throttling
+        // for max speed
+        const bool throttle = options.tests.empty() and not options.offline;
+        const bool rewind = options.tests.empty() and not options.offline;
         auto in_file = make_unique<CRAWFile>(ri, throttle, rewind);
         if (not in_file) {
             cerr << "Could not prepare CRAWFile" << endl;
@@ -520,6 +935,16 @@ int main(int argc, char **argv)
         }
 
         in_file->setFileName(options.iqsource, "auto");
+        // At the end of the file, the demodulator thread waits for the
+        // offline mode to stop it instead of demodulating silence.
+        // Single-threaded, the frames stop at the end of the file anyway.
+        in_file->setBlockAtEnd(options.offline and not options.rro.singleThreaded);
+        if (options.iqsource_offset > 0 and
+                not in_file->seek(options.iqsource_offset)) {
+            cerr << "Could not seek to sample " << options.iqsource_offset <<
+                " of " << options.iqsource << endl;
+            return 1;
+        }
         in = move(in_file);
     }
 
@@ -570,6 +995,12 @@ int main(int argc, char **argv)
             tests.run_test(test);
         }
     }
+    else if (options.scan) {
+        return scanBand(ri, *in, options);
+    }
+    else if (options.offline) {
+        return decodeOffline(ri, dynamic_cast<CRAWFile&>(*in), options);
+    }
     else if (options.web_port != -1) {
         using DS = WebRadioInterface::DecodeStrategy;
         WebRadioInterface::DecodeSettings ds;
@@ -620,18 +1051,26 @@ int main(int argc, char **argv)
 
         rx.restart(false);
 
-        cerr << "Wait for sync" << endl;
-        while (not ri.synced) {
-            this_thread::sleep_for(chrono::seconds(3));
+        // The cached ensemble can be played before the receiver is synced
+        const bool preloaded = rx.useEnsembleCache(
+                options.iqsource.empty() ? options.channel : options.iqsource);
+        if (preloaded) {
+            cerr << "Preloaded the cached ensemble" << endl;
         }
+        else {
+            cerr << "Wait for sync" << endl;
+            while (not ri.synced) {
+                this_thread::sleep_for(chrono::seconds(3));
+            }
 
-        cerr << "Wait for service list" << endl;
-        while (rx.getServiceList().empty()) {
-            this_thread::sleep_for(chrono::seconds(1));
-        }
+            cerr << "Wait for service list" << endl;
+            while (rx.getServiceList().empty()) {
+                this_thread::sleep_for(chrono::seconds(1));
+            }
 
-        // Wait an additional 3 seconds so that the receiver can complete the service list
-        this_thread::sleep_for(chrono::seconds(3));
+            // Wait an additional 3 seconds so that the receiver can complete the service list
+            this_thread::sleep_for(chrono::seconds(3));
+        }
 
         if (options.decode_all_programmes) {
             using SId_t = uint32_t;
@@ -726,6 +1165,8 @@ int main(int argc, char **argv)
             cerr << "Nothing to do, not ALSA support." << endl;
 #endif // defined(HAVE_ALSA)
         }
+
+        rx.saveEnsembleCache();
     }
 
     if (ri.fic_fd) {
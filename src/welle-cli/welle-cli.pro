@@ -8,7 +8,9 @@ HEADERS += \
     alsa-output.h  \
     webprogrammehandler.h \
     webradiointerface.h \
-    jsonconvert.h
+    jsonconvert.h \
+    batchdecoder.h \
+    batchreport.h
 
 SOURCES += \
     alsa-output.cpp \
@@ -16,6 +18,8 @@ SOURCES += \
     webprogrammehandler.cpp \
     webradiointerface.cpp \
     jsonconvert.cpp \
+    batchdecoder.cpp \
+    batchreport.cpp \
     welle-cli.cpp
 
 # Include git hash into build
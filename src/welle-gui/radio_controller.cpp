@@ -32,6 +32,7 @@
 
 #include <QCoreApplication>
 #include <QDebug>
+#include <QDir>
 #include <QSettings>
 #include <QStandardPaths>
 #include <QTimeZone>
@@ -46,6 +47,8 @@
 #include "rtl_tcp.h"
 
 #define AUDIOBUFFERSIZE 32768
+// How often a scan checks whether the ensemble of a channel is complete, in ms
+#define SCAN_DWELL_POLL 200
 
 static QString serialise_serviceid(quint32 serviceid) {
     return QString::asprintf("%x", serviceid);
@@ -121,6 +124,14 @@ CRadioController::CRadioController(QVariantMap& commandLineOptions, QObject *par
     // Fix: Ensure settings are loaded during initialization
     loadAnnouncementSettings();
 
+    // Keep the ensemble of every channel, so that a station can play
+    // as soon as we tune back to its channel
+    const QString ensembleCacheDir =
+        QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/ensembles";
+    if (QDir().mkpath(ensembleCacheDir)) {
+        rro.ensembleCacheDirectory = ensembleCacheDir.toStdString();
+    }
+
     qDebug() << "RadioController: AnnouncementManager initialized with loaded settings";
 }
 
@@ -163,6 +174,9 @@ void CRadioController::closeDevice()
 {
     qDebug() << "RadioController:" << "Close device";
 
+    if (radioReceiver) {
+        radioReceiver->saveEnsembleCache();
+    }
     radioReceiver.reset();
     device.reset();
     audio.reset();
@@ -425,6 +439,12 @@ void CRadioController::setChannel(QString Channel, bool isScan, bool Force)
             radioReceiver = std::make_unique<RadioReceiver>(*this, *device, rro, 1);
             radioReceiver->setReceiverOptions(rro);
             radioReceiver->restart(isScan);
+
+            // A scan must find what is on the air, it only fills the cache
+            if (currentChannel != "File" and
+                    radioReceiver->useEnsembleCache(currentChannel.toStdString(), not isScan)) {
+                qDebug() << "RadioController: Preloaded the ensemble of channel" << currentChannel;
+            }
         }
 
         emit channelChanged();
@@ -486,6 +506,7 @@ void CRadioController::startScan(void)
 
         isChannelScan = true;
         emit isChannelScanChanged(isChannelScan);
+        scanTimer.start();
         stationCount = 0;
         currentTitle = tr("Scanning") + " ... " + Channel
                 + " (" + QString::number((1 * 100 / NUMBEROFCHANNELS)) + "%)";
@@ -517,11 +538,22 @@ void CRadioController::stopScan(void)
     currentText = "";
     emit textChanged();
 
+    const bool wasScanning = isChannelScan;
+    if (wasScanning) {
+        scanDuration = scanTimer.elapsed();
+        qDebug() << "RadioController:" << "Channel scan took" << scanDuration / 1000.0 << "s";
+    }
+
     isChannelScan = false;
     emit isChannelScanChanged(isChannelScan);
     emit scanStopped();
 
     stop();
+
+    if (wasScanning) {
+        currentText = tr("Scan took %1 s").arg(scanDuration / 1000.0, 0, 'f', 1);
+        emit textChanged();
+    }
 }
 
 void CRadioController::setAGC(bool isAGC)
@@ -968,8 +1000,15 @@ void CRadioController::channelTimerTimeout(void)
 {
     channelTimer.stop();
 
-    if(isChannelScan)
+    if(isChannelScan) {
+        // Stay as long as the FIC completes the ensemble
+        if (radioReceiver and not scanDwell.isDone(*radioReceiver->getEnsembleSnapshot())) {
+            channelTimer.start(SCAN_DWELL_POLL);
+            return;
+        }
+
         nextChannel(false);
+    }
 }
 
 void CRadioController::announcementDurationTimerTimeout(void)
@@ -1000,8 +1039,9 @@ void CRadioController::displayDateTime(const dab_date_time_t& dateTime)
 
 void CRadioController::nextChannel(bool isWait)
 {
-    if (isWait) { // It might be a channel, wait 10 seconds
-        channelTimer.start(10000);
+    if (isWait) { // A DAB signal, wait for its ensemble, see ScanDwell
+        scanDwell.start();
+        channelTimer.start(SCAN_DWELL_POLL);
     }
     else {
         auto Channel = QString::fromStdString(channels.getNextChannel());
@@ -36,6 +36,7 @@
 #include <QObject>
 #include <QList>
 #include <QDateTime>
+#include <QElapsedTimer>
 #include <QImage>
 #include <QVariantMap>
 #include <QFile>
@@ -47,6 +48,7 @@
 #include "audio_output.h"
 #include "dab-constants.h"
 #include "radio-receiver.h"
+#include "channel-scan.h"
 #include "ringbuffer.h"
 #include "channels.h"
 #include "../backend/announcement-manager.h"
@@ -88,6 +90,7 @@ class CRadioController :
     Q_PROPERTY(QDateTime dateTime MEMBER currentDateTime NOTIFY dateTimeChanged)
     Q_PROPERTY(bool isPlaying MEMBER isPlaying NOTIFY isPlayingChanged)
     Q_PROPERTY(bool isChannelScan MEMBER isChannelScan NOTIFY isChannelScanChanged)
+    Q_PROPERTY(qint64 scanDuration MEMBER scanDuration NOTIFY scanStopped)
     Q_PROPERTY(bool isSync MEMBER isSync NOTIFY isSyncChanged)
     Q_PROPERTY(bool isFICCRC MEMBER isFICCRC NOTIFY isFICCRCChanged)
     Q_PROPERTY(bool isSignal MEMBER isSignal NOTIFY isSignalChanged)
@@ -307,6 +310,10 @@ private:
     QTimer announcementDurationTimer;  // NEW: Timer for announcement duration updates
 
     bool isChannelScan = false;
+    QElapsedTimer scanTimer;
+    // Of the last scan, in milliseconds
+    qint64 scanDuration = 0;
+    ScanDwell scanDwell;
     bool isAGC = false;
     bool isAutoPlay = false;
     QString autoChannel;